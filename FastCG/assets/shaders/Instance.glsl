@@ -7,8 +7,6 @@ struct InstanceData
 {
 	mat4 model;
 	mat4 modelInverseTranspose;
-	mat4 viewProjection;
-	mat4 modelViewProjection;
 };
 
 layout(std140, BINDING_0_1) uniform InstanceConstants
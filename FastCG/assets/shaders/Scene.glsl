@@ -9,6 +9,7 @@ layout(std140, BINDING_0_0) uniform SceneConstants
 	mat4 uInverseView;
 	mat4 uProjection;
 	mat4 uInverseProjection;
+	mat4 uViewProjection;
 	vec2 uScreenSize;
 	float uPointSize;
 };
@@ -1,4 +1,5 @@
 #include "FastCG.glsl"
+#include "Scene.glsl"
 #include "Instance.glsl"
 
 layout(location = 0) in vec3 iPosition;
@@ -8,5 +9,5 @@ layout(location = 0) out vec3 vRayDir;
 void main()
 {
     vRayDir = iPosition;
-	gl_Position = GetInstanceData().modelViewProjection * vec4(iPosition, 1);
+	gl_Position = uViewProjection * GetInstanceData().model * vec4(iPosition, 1);
 }
\ No newline at end of file
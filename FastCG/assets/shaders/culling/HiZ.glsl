@@ -0,0 +1,26 @@
+#ifndef FASTCG_CULLING_HI_Z_GLSL
+#define FASTCG_CULLING_HI_Z_GLSL
+
+#define HI_Z_CELL_SIZE 8u
+#define HI_Z_LEVEL_COUNT 4u
+
+// number of cells of a Hi-Z level (each cell covers HI_Z_CELL_SIZE << level pixels of the depth buffer)
+uvec2 GetHiZLevelSize(uvec2 depthSize, uint level)
+{
+	uint cellSize = HI_Z_CELL_SIZE << level;
+	return (depthSize + uvec2(cellSize - 1u)) / cellSize;
+}
+
+// levels are stored one after the other, from the finest to the coarsest
+uint GetHiZLevelOffset(uvec2 depthSize, uint level)
+{
+	uint offset = 0u;
+	for (uint i = 0u; i < level; ++i)
+	{
+		uvec2 levelSize = GetHiZLevelSize(depthSize, i);
+		offset += levelSize.x * levelSize.y;
+	}
+	return offset;
+}
+
+#endif
\ No newline at end of file
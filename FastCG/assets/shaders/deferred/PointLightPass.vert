@@ -1,9 +1,10 @@
 #include "FastCG.glsl"
+#include "Scene.glsl"
 #include "Instance.glsl"
 
 layout(location = 0) in vec3 iPosition;
 
 void main()
 {
-	gl_Position = GetInstanceData().modelViewProjection * vec4(iPosition, 1.0);
+	gl_Position = uViewProjection * GetInstanceData().model * vec4(iPosition, 1.0);
 }
\ No newline at end of file
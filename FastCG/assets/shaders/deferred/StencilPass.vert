@@ -1,4 +1,5 @@
 #include "FastCG.glsl"
+#include "Scene.glsl"
 #include "Instance.glsl"
 
 layout(location = 0) in vec3 iPosition;
@@ -7,5 +8,5 @@ layout(location = 2) in vec2 iUV;
 
 void main()
 {
-	gl_Position = GetInstanceData().modelViewProjection * vec4(iPosition, 1.0);
+	gl_Position = uViewProjection * GetInstanceData().model * vec4(iPosition, 1.0);
 }
\ No newline at end of file
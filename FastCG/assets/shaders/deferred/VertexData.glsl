@@ -17,7 +17,7 @@ struct VertexData
 VertexData ComputeVertexData(vec3 position, vec3 normal, vec2 uv, vec4 tangent)
 {
     VertexData vertexData;
-    vertexData.clipPosition = GetInstanceData().modelViewProjection * vec4(position, 1.0);
+    vertexData.clipPosition = uViewProjection * GetInstanceData().model * vec4(position, 1.0);
 	mat3 MIT = mat3(GetInstanceData().modelInverseTranspose);
 	vertexData.normal = normalize(MIT * normal);
 	vertexData.tangent = vec4(normalize(MIT * tangent.xyz), tangent.w);
@@ -24,7 +24,7 @@ VertexData ComputeVertexData(vec3 position, vec3 normal, vec2 uv, vec4 tangent)
     VertexData vertexData;
     vec4 worldPosition = GetInstanceData().model * vec4(position, 1.0);
     vertexData.worldPosition = worldPosition.xyz;
-    vertexData.clipPosition = GetInstanceData().viewProjection * worldPosition;
+    vertexData.clipPosition = uViewProjection * worldPosition;
 	vertexData.viewerDirection = GetViewerPosition() - vertexData.worldPosition;
 	vertexData.viewerDistance = length(vertexData.viewerDirection);
 	vertexData.viewerDirection = vertexData.viewerDirection / max(vertexData.viewerDistance, 1e-8);
@@ -3,6 +3,8 @@
 
 #include <glm/glm.hpp>
 
+#include <cmath>
+
 #ifdef max
 #undef max
 #endif
@@ -37,6 +39,76 @@ namespace FastCG
         {
             return max.x <= min.x || max.y <= min.y || max.z <= min.z;
         }
+
+        inline bool IsEmpty() const
+        {
+            return max == min;
+        }
+
+        inline float GetSurfaceArea() const
+        {
+            auto extent = getExtent();
+            return 2 * (extent.x * extent.y + extent.y * extent.z + extent.z * extent.x);
+        }
+
+        inline bool Contains(const AABB &other) const
+        {
+            return glm::all(glm::lessThanEqual(min, other.min)) && glm::all(glm::greaterThanEqual(max, other.max));
+        }
+
+        inline bool Intersects(const AABB &other) const
+        {
+            return glm::all(glm::lessThanEqual(min, other.max)) && glm::all(glm::greaterThanEqual(max, other.min));
+        }
+
+        inline bool Intersects(const glm::vec3 &rCenter, float radius) const
+        {
+            auto closestPoint = glm::clamp(rCenter, min, max);
+            auto offset = closestPoint - rCenter;
+            return glm::dot(offset, offset) <= radius * radius;
+        }
+
+        // slab test, rDistance is the entry distance along the ray (0 if the origin is inside)
+        inline bool Raycast(const glm::vec3 &rOrigin, const glm::vec3 &rInverseDirection, float maxDistance,
+                            float &rDistance) const
+        {
+            auto tEnter = 0.0f;
+            auto tExit = maxDistance;
+            for (glm::length_t i = 0; i < 3; ++i)
+            {
+                // a zero direction component has an infinite inverse, which turns the slab test into 0 * inf = NaN
+                // whenever the origin lies on a slab plane. a ray parallel to a slab either starts inside it (and
+                // never leaves it) or misses the box entirely
+                if (std::isinf(rInverseDirection[i]))
+                {
+                    if (rOrigin[i] < min[i] || rOrigin[i] > max[i])
+                    {
+                        return false;
+                    }
+                    continue;
+                }
+                auto t0 = (min[i] - rOrigin[i]) * rInverseDirection[i];
+                auto t1 = (max[i] - rOrigin[i]) * rInverseDirection[i];
+                tEnter = glm::max(tEnter, glm::min(t0, t1));
+                tExit = glm::min(tExit, glm::max(t0, t1));
+                if (tEnter > tExit)
+                {
+                    return false;
+                }
+            }
+            rDistance = tEnter;
+            return true;
+        }
+
+        // source: Arvo, "Transforming Axis-Aligned Bounding Boxes" (Graphics Gems)
+        inline AABB Transform(const glm::mat4 &rMatrix) const
+        {
+            auto center = glm::vec3(rMatrix * glm::vec4(getCenter(), 1));
+            auto halfExtent = glm::mat3(glm::abs(glm::vec3(rMatrix[0])), glm::abs(glm::vec3(rMatrix[1])),
+                                        glm::abs(glm::vec3(rMatrix[2]))) *
+                              (getExtent() * 0.5f);
+            return {center - halfExtent, center + halfExtent};
+        }
     };
 
 }
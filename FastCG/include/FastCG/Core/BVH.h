@@ -0,0 +1,102 @@
+#ifndef FASTCG_BVH_H
+#define FASTCG_BVH_H
+
+#include <FastCG/Core/AABB.h>
+#include <FastCG/Core/Frustum.h>
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace FastCG
+{
+    using BVHProxyId = int32_t;
+
+    constexpr BVHProxyId INVALID_BVH_PROXY_ID = -1;
+
+    // Dynamic AABB tree (source: Catto, Box2D b2DynamicTree)
+    //
+    // Leaves store "fat" bounds (the real bounds inflated by a margin), so small movements don't
+    // require touching the tree. Insertions pick the sibling that minimizes the surface area
+    // heuristic and rotations keep the tree balanced.
+    template <typename T>
+    class BVH
+    {
+    public:
+        BVH(float margin = 0.1f) : mMargin(margin)
+        {
+        }
+
+        inline BVHProxyId Insert(const AABB &rBounds, const T &rData);
+        inline void Remove(BVHProxyId proxyId);
+        // returns true if the proxy was reinserted (ie, its bounds escaped the fat bounds)
+        inline bool Update(BVHProxyId proxyId, const AABB &rBounds);
+        inline void Clear();
+        inline const T &GetData(BVHProxyId proxyId) const
+        {
+            return mNodes[proxyId].data;
+        }
+        inline const AABB &GetFatBounds(BVHProxyId proxyId) const
+        {
+            return mNodes[proxyId].bounds;
+        }
+        inline size_t GetProxyCount() const
+        {
+            return mProxyCount;
+        }
+        inline int32_t GetHeight() const
+        {
+            return mRoot == NULL_NODE ? 0 : mNodes[mRoot].height;
+        }
+        // CallbackT: bool(const T &rData) -> return false to stop the query
+        template <typename CallbackT>
+        inline void Query(const AABB &rBounds, CallbackT &&rCallback) const;
+        template <typename CallbackT>
+        inline void Query(const Frustum &rFrustum, CallbackT &&rCallback) const;
+        template <typename CallbackT>
+        inline void Query(const glm::vec3 &rCenter, float radius, CallbackT &&rCallback) const;
+        // CallbackT: float(const T &rData, float distance) -> return the new max. distance (0 stops the raycast)
+        template <typename CallbackT>
+        inline void Raycast(const glm::vec3 &rOrigin, const glm::vec3 &rDirection, float maxDistance,
+                            CallbackT &&rCallback) const;
+
+    private:
+        static constexpr int32_t NULL_NODE = -1;
+
+        struct Node
+        {
+            AABB bounds;
+            T data{};
+            int32_t parent{NULL_NODE}; // also used as the next free node
+            int32_t child0{NULL_NODE};
+            int32_t child1{NULL_NODE};
+            int32_t height{-1}; // -1 = free node, 0 = leaf
+
+            inline bool IsLeaf() const
+            {
+                return child0 == NULL_NODE;
+            }
+        };
+
+        float mMargin;
+        std::vector<Node> mNodes;
+        int32_t mRoot{NULL_NODE};
+        int32_t mFreeList{NULL_NODE};
+        size_t mProxyCount{0};
+
+        inline int32_t AllocateNode();
+        inline void FreeNode(int32_t nodeIdx);
+        inline void InsertLeaf(int32_t leafIdx);
+        inline void RemoveLeaf(int32_t leafIdx);
+        inline int32_t Balance(int32_t nodeIdx);
+        inline void Refit(int32_t nodeIdx);
+        template <typename OverlapT, typename CallbackT>
+        inline void Traverse(OverlapT &&rOverlap, CallbackT &&rCallback) const;
+    };
+
+}
+
+#include <FastCG/Core/BVH.inc>
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef FASTCG_FRUSTUM_H
+#define FASTCG_FRUSTUM_H
+
+#include <FastCG/Core/AABB.h>
+
+#include <glm/glm.hpp>
+
+#include <array>
+
+namespace FastCG
+{
+    struct Frustum
+    {
+        // left, right, bottom, top, near, far (xyz = inward-pointing normal, w = distance)
+        std::array<glm::vec4, 6> planes{};
+
+        Frustum() = default;
+
+        // source: Gribb & Hartmann, "Fast Extraction of Viewing Frustum Planes from the World-View-Projection Matrix"
+        Frustum(const glm::mat4 &rViewProjection)
+        {
+            auto row0 = glm::vec4{rViewProjection[0][0], rViewProjection[1][0], rViewProjection[2][0],
+                                  rViewProjection[3][0]};
+            auto row1 = glm::vec4{rViewProjection[0][1], rViewProjection[1][1], rViewProjection[2][1],
+                                  rViewProjection[3][1]};
+            auto row2 = glm::vec4{rViewProjection[0][2], rViewProjection[1][2], rViewProjection[2][2],
+                                  rViewProjection[3][2]};
+            auto row3 = glm::vec4{rViewProjection[0][3], rViewProjection[1][3], rViewProjection[2][3],
+                                  rViewProjection[3][3]};
+
+            planes[0] = row3 + row0;
+            planes[1] = row3 - row0;
+            planes[2] = row3 + row1;
+            planes[3] = row3 - row1;
+            // assumes [-1, 1] clip-space depth, which is also conservative for [0, 1]
+            planes[4] = row3 + row2;
+            planes[5] = row3 - row2;
+
+            for (auto &rPlane : planes)
+            {
+                rPlane /= glm::length(glm::vec3(rPlane));
+            }
+        }
+
+        inline bool Intersects(const AABB &rBounds) const
+        {
+            for (const auto &rPlane : planes)
+            {
+                // test the corner that lies the furthest along the plane normal (p-vertex)
+                glm::vec3 pVertex{rPlane.x >= 0 ? rBounds.max.x : rBounds.min.x,
+                                  rPlane.y >= 0 ? rBounds.max.y : rBounds.min.y,
+                                  rPlane.z >= 0 ? rBounds.max.z : rBounds.min.z};
+                if (glm::dot(glm::vec3(rPlane), pVertex) + rPlane.w < 0)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+    };
+
+}
+
+#endif
@@ -3,6 +3,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 
 namespace FastCG
 {
@@ -33,6 +34,71 @@ namespace FastCG
         return hash;
     }
 
+    // null-terminated string version, usable at compile time
+    constexpr uint32_t FNV1a(const char *pString)
+    {
+        uint32_t hash = FNV_OFFSET_BASIS;
+        for (; *pString != '\0'; ++pString)
+        {
+            hash ^= (uint8_t)*pString;
+            hash *= FNV_PRIME;
+        }
+        return hash;
+    }
+
+    // source: https://github.com/aappleby/smhasher/blob/master/src/MurmurHash2.cpp (MurmurHash64A, public domain)
+    inline uint64_t MurmurHash64A(const void *pData, size_t size, uint64_t seed = 0)
+    {
+        constexpr uint64_t M = 0xc6a4a7935bd1e995ull;
+        constexpr int R = 47;
+
+        auto *pBytes = reinterpret_cast<const uint8_t *>(pData);
+        uint64_t hash = seed ^ (size * M);
+
+        // consume 8 bytes at a time
+        auto *pEnd = pBytes + (size & ~(size_t)7);
+        for (; pBytes != pEnd; pBytes += 8)
+        {
+            uint64_t k;
+            std::memcpy(&k, pBytes, sizeof(k)); // unaligned read
+            k *= M;
+            k ^= k >> R;
+            k *= M;
+            hash ^= k;
+            hash *= M;
+        }
+
+        switch (size & 7)
+        {
+        case 7:
+            hash ^= (uint64_t)pBytes[6] << 48;
+            [[fallthrough]];
+        case 6:
+            hash ^= (uint64_t)pBytes[5] << 40;
+            [[fallthrough]];
+        case 5:
+            hash ^= (uint64_t)pBytes[4] << 32;
+            [[fallthrough]];
+        case 4:
+            hash ^= (uint64_t)pBytes[3] << 24;
+            [[fallthrough]];
+        case 3:
+            hash ^= (uint64_t)pBytes[2] << 16;
+            [[fallthrough]];
+        case 2:
+            hash ^= (uint64_t)pBytes[1] << 8;
+            [[fallthrough]];
+        case 1:
+            hash ^= (uint64_t)pBytes[0];
+            hash *= M;
+        }
+
+        hash ^= hash >> R;
+        hash *= M;
+        hash ^= hash >> R;
+        return hash;
+    }
+
     template <typename T>
     struct IdentityHasher
     {
@@ -0,0 +1,61 @@
+#ifndef FASTCG_THREAD_POOL_H
+#define FASTCG_THREAD_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace FastCG
+{
+    // Fixed set of worker threads that split index ranges with the calling thread.
+    // Workers have thread indices [0, GetThreadCount()) and the calling thread has GetThreadCount(), so per-thread
+    // resources can be indexed without locking.
+    // Workers also run background tasks when there's no index range to split.
+    class ThreadPool final
+    {
+    public:
+        using Callback = std::function<void(size_t index, uint32_t threadIdx)>;
+        using Task = std::function<void()>;
+
+        ThreadPool(uint32_t threadCount);
+        ~ThreadPool();
+
+        inline uint32_t GetThreadCount() const
+        {
+            return (uint32_t)mThreads.size();
+        }
+
+        // calls rCallback for every index in [0, count) and returns once all calls are done, rethrowing the first
+        // exception thrown by them (not reentrant)
+        void ParallelFor(size_t count, const Callback &rCallback);
+        // runs rTask on a worker at some point (or right away, if there are no workers). tasks must not throw and the
+        // ones still queued when the pool is destroyed are discarded
+        void Enqueue(Task task);
+
+    private:
+        std::vector<std::thread> mThreads;
+        std::mutex mMutex;
+        std::condition_variable mWorkAvailable;
+        std::condition_variable mWorkDone;
+        const Callback *mpCallback{nullptr};
+        size_t mCount{0};
+        size_t mNextIndex{0};
+        size_t mDoneCount{0};
+        uint64_t mGeneration{0};
+        std::exception_ptr mException;
+        std::deque<Task> mTasks;
+        bool mStop{false};
+
+        void RunWorker(uint32_t threadIdx);
+        void RunCallbacks(uint32_t threadIdx);
+    };
+
+}
+
+#endif
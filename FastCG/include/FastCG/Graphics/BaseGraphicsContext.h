@@ -1,6 +1,7 @@
 #ifndef FASTCG_BASE_GRAPHICS_CONTEXT_H
 #define FASTCG_BASE_GRAPHICS_CONTEXT_H
 
+#include <FastCG/Graphics/BaseShader.h>
 #include <FastCG/Graphics/GraphicsUtils.h>
 
 #include <glm/glm.hpp>
@@ -17,8 +18,11 @@ namespace FastCG
         struct Args
         {
             std::string name;
+            // hint, backends without a dedicated queue of that type use the graphics one
+            QueueType queueType;
 
-            Args(const std::string &rName = "") : name(rName)
+            Args(const std::string &rName = "", QueueType queueType = QueueType::GRAPHICS)
+                : name(rName), queueType(queueType)
             {
             }
         };
@@ -51,12 +55,14 @@ namespace FastCG
         void SetScissorTest(bool scissorTest);
         void SetCullMode(Face face);
         void Copy(const Buffer *pDst, const void *pSrc, size_t size);
+        void Copy(const Buffer *pDst, const void *pSrc, size_t offset, size_t size);
         void Copy(const Texture *pDst, const void *pSrc, size_t size);
         void Copy(void *pDst, const Buffer *pSrc, size_t offset, size_t size);
         void AddMemoryBarrier();
         void BindShader(const Shader *pShader);
-        void BindResource(const Buffer *pBuffer, const char *pName);
-        void BindResource(const Texture *pTexture, const char *pName);
+        void BindResource(const Buffer *pBuffer, ShaderResourceId id);
+        void BindResource(const Buffer *pBuffer, size_t offset, size_t size, ShaderResourceId id);
+        void BindResource(const Texture *pTexture, ShaderResourceId id);
         void Blit(const Texture *pSrc, const Texture *pDst);
         void SetRenderTargets(const Texture *const *ppRenderTargets, uint32_t renderTargetCount,
                               const Texture *pDepthStencilBuffer);
@@ -70,6 +76,9 @@ namespace FastCG
         void DrawIndexed(PrimitiveType primitiveType, uint32_t firstIndex, uint32_t indexCount, int32_t vertexOffset);
         void DrawInstancedIndexed(PrimitiveType primitiveType, uint32_t firstInstance, uint32_t instanceCount,
                                   uint32_t firstIndex, uint32_t indexCount, int32_t vertexOffset);
+        void DrawIndexedIndirect(PrimitiveType primitiveType, const Buffer *pIndirectBuffer, size_t offset);
+        void MultiDrawIndexedIndirect(PrimitiveType primitiveType, const Buffer *pIndirectBuffer, size_t offset,
+                                      uint32_t drawCount, uint32_t stride);
         void Dispatch(uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ);
         void End();
         double GetElapsedTime(uint32_t frame) const;
@@ -2,6 +2,7 @@
 #define FASTCG_BASE_GRAPHICS_SYSTEM_H
 
 #include <FastCG/Core/Hash.h>
+#include <FastCG/Core/ThreadPool.h>
 #include <FastCG/Graphics/BaseBuffer.h>
 #include <FastCG/Graphics/BaseGraphicsContext.h>
 #include <FastCG/Graphics/BaseShader.h>
@@ -10,6 +11,7 @@
 #include <glm/glm.hpp>
 
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <type_traits>
 #include <unordered_map>
@@ -26,6 +28,8 @@ namespace FastCG
         uint32_t maxSimultaneousFrames;
         bool vsync;
         bool headless;
+        // size (in bytes) of the memory reserved for each frame in flight to stage uploads
+        size_t stagingBufferSize;
     };
 
     template <class BufferT, class GraphicsContextT, class ShaderT, class TextureT>
@@ -76,6 +80,11 @@ namespace FastCG
         {
             return mTextures;
         }
+        // worker threads shared by asset importing and the backend (e.g., command recording)
+        inline ThreadPool *GetThreadPool() const
+        {
+            return mpThreadPool.get();
+        }
 #if _DEBUG
         inline void SetSelectedTexture(const Texture *pTexture)
         {
@@ -90,6 +99,8 @@ namespace FastCG
         inline virtual Buffer *CreateBuffer(const typename Buffer::Args &rArgs);
         inline virtual GraphicsContext *CreateGraphicsContext(const typename GraphicsContext::Args &rArgs);
         inline virtual Shader *CreateShader(const typename Shader::Args &rArgs);
+        // creates several shaders at once, so that backends can overlap their creation
+        inline std::vector<Shader *> CreateShaders(const std::vector<typename Shader::Args> &rArgs);
         inline virtual Texture *CreateTexture(const typename Texture::Args &rArgs);
         inline virtual void DestroyBuffer(const Buffer *pBuffer);
         inline virtual void DestroyGraphicsContext(const GraphicsContext *pGraphicsContext);
@@ -118,6 +129,13 @@ namespace FastCG
         virtual void OnPostFinalize()
         {
         }
+        virtual void ConstructShaders(const std::vector<typename Shader::Args> &rArgs, std::vector<Shader *> &rShaders)
+        {
+            for (size_t i = 0; i < rArgs.size(); ++i)
+            {
+                rShaders[i] = new Shader{rArgs[i]};
+            }
+        }
 #if _DEBUG
         inline void DebugMenuCallback(int result);
         inline void DebugMenuItemCallback(int &result);
@@ -129,6 +147,7 @@ namespace FastCG
 
     private:
         bool mInitialized{false};
+        std::unique_ptr<ThreadPool> mpThreadPool;
         const Texture *mpBackbuffer;
         std::vector<Buffer *> mBuffers;
         std::vector<GraphicsContext *> mGraphicsContexts;
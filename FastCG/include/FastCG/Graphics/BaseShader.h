@@ -1,9 +1,11 @@
 #ifndef FASTCG_BASE_SHADER_H
 #define FASTCG_BASE_SHADER_H
 
+#include <FastCG/Core/Hash.h>
 #include <FastCG/Graphics/GraphicsUtils.h>
 
 #include <array>
+#include <cstdint>
 #include <string>
 #include <type_traits>
 
@@ -14,6 +16,15 @@ namespace FastCG
     template <typename T>
     using ShaderTypeValueArray = std::array<T, (ShaderTypeInt)ShaderType::LAST>;
 
+    // shader resources (constant buffers, storage buffers and textures) are bound by the hash of their names, so that
+    // binding them doesn't involve any string handling (names are hashed at compile time when they're literals)
+    using ShaderResourceId = uint32_t;
+
+    constexpr ShaderResourceId GetShaderResourceId(const char *pName)
+    {
+        return FNV1a(pName);
+    }
+
     struct ShaderProgramData
     {
         size_t dataSize{0};
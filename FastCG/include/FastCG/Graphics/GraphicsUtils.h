@@ -11,7 +11,8 @@
 
 namespace FastCG
 {
-    FASTCG_DECLARE_FLAGS(BufferUsage, uint8_t, UNIFORM, SHADER_STORAGE, VERTEX_BUFFER, INDEX_BUFFER, DYNAMIC);
+    FASTCG_DECLARE_FLAGS(BufferUsage, uint8_t, UNIFORM, SHADER_STORAGE, VERTEX_BUFFER, INDEX_BUFFER, INDIRECT,
+                         DYNAMIC);
     FASTCG_DECLARE_SCOPED_ENUM(VertexDataType, uint8_t, NONE, FLOAT, UNSIGNED_BYTE);
     FASTCG_DECLARE_SCOPED_ENUM(ShaderType, uint8_t, VERTEX, FRAGMENT, COMPUTE);
     FASTCG_DECLARE_SCOPED_ENUM(TextureType, uint8_t, TEXTURE_1D, TEXTURE_2D, TEXTURE_3D, TEXTURE_CUBE_MAP,
@@ -37,6 +38,7 @@ namespace FastCG
                                ONE_MINUS_SRC_COLOR, ONE_MINUS_SRC_ALPHA);
     FASTCG_DECLARE_SCOPED_ENUM(Face, uint8_t, NONE, FRONT, BACK, FRONT_AND_BACK);
     FASTCG_DECLARE_SCOPED_ENUM(CompareOp, uint8_t, LEQUAL, LESS, GEQUAL, GREATER, EQUAL, NOT_EQUAL, ALWAYS, NEVER);
+    FASTCG_DECLARE_SCOPED_ENUM(QueueType, uint8_t, GRAPHICS, COMPUTE, TRANSFER);
     FASTCG_DECLARE_SCOPED_ENUM(StencilOp, uint8_t, KEEP, ZERO, REPLACE, INVERT, INCREMENT_AND_CLAMP, INCREMENT_AND_WRAP,
                                DECREMENT_AND_CLAMP, DECREMENT_AND_WRAP);
     FASTCG_DECLARE_SCOPED_ENUM(FogMode, uint8_t, NONE, LINEAR, EXP, EXP2);
@@ -62,6 +64,16 @@ namespace FastCG
         uint32_t writeMask;
     };
 
+    // same layout as VkDrawIndexedIndirectCommand and GL's DrawElementsIndirectCommand
+    struct DrawIndexedIndirectCommand
+    {
+        uint32_t indexCount;
+        uint32_t instanceCount;
+        uint32_t firstIndex;
+        int32_t vertexOffset;
+        uint32_t firstInstance;
+    };
+
     struct VertexBindingDescriptor
     {
         uint32_t binding;
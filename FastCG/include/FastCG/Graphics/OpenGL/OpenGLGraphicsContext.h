@@ -40,12 +40,14 @@ namespace FastCG
         void SetScissorTest(bool scissorTest);
         void SetCullMode(Face face);
         void Copy(const OpenGLBuffer *pDst, const void *pSrc, size_t size);
+        void Copy(const OpenGLBuffer *pDst, const void *pSrc, size_t offset, size_t size);
         void Copy(const OpenGLTexture *pDst, const void *pSrc, size_t size);
         void Copy(void *pDst, const OpenGLBuffer *pSrc, size_t offset, size_t size);
         void AddMemoryBarrier();
         void BindShader(const OpenGLShader *pShader);
-        void BindResource(const OpenGLBuffer *pBuffer, const char *pName);
-        void BindResource(const OpenGLTexture *pTexture, const char *pName);
+        void BindResource(const OpenGLBuffer *pBuffer, ShaderResourceId id);
+        void BindResource(const OpenGLBuffer *pBuffer, size_t offset, size_t size, ShaderResourceId id);
+        void BindResource(const OpenGLTexture *pTexture, ShaderResourceId id);
         void Blit(const OpenGLTexture *pSrc, const OpenGLTexture *pDst);
         void SetRenderTargets(const OpenGLTexture *const *ppRenderTargets, uint32_t renderTargetCount,
                               const OpenGLTexture *pDepthStencilBuffer);
@@ -58,13 +60,16 @@ namespace FastCG
         void DrawIndexed(PrimitiveType primitiveType, uint32_t firstIndex, uint32_t indexCount, int32_t vertexOffset);
         void DrawInstancedIndexed(PrimitiveType primitiveType, uint32_t firstInstance, uint32_t instanceCount,
                                   uint32_t firstIndex, uint32_t indexCount, int32_t vertexOffset);
+        void DrawIndexedIndirect(PrimitiveType primitiveType, const OpenGLBuffer *pIndirectBuffer, size_t offset);
+        void MultiDrawIndexedIndirect(PrimitiveType primitiveType, const OpenGLBuffer *pIndirectBuffer, size_t offset,
+                                      uint32_t drawCount, uint32_t stride);
         void Dispatch(uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ);
         void End();
         double GetElapsedTime(uint32_t frame) const;
 
     private:
         const OpenGLShader *mpBoundShader{nullptr};
-        std::unordered_set<std::string> mResourceUsage;
+        std::unordered_set<ShaderResourceId, IdentityHasher<ShaderResourceId>> mResourceUsage;
         std::vector<const OpenGLTexture *> mRenderTargets;
         const OpenGLTexture *mpDepthStencilBuffer;
         bool mEnded{true};
@@ -10,6 +10,7 @@
 #include <FastCG/Graphics/OpenGL/OpenGLBuffer.h>
 #include <FastCG/Graphics/OpenGL/OpenGLGraphicsContext.h>
 #include <FastCG/Graphics/OpenGL/OpenGLShader.h>
+#include <FastCG/Graphics/OpenGL/OpenGLStateCache.h>
 #include <FastCG/Graphics/OpenGL/OpenGLTexture.h>
 
 #include <cassert>
@@ -50,6 +51,10 @@ namespace FastCG
         {
             return mDeviceProperties;
         }
+        inline OpenGLStateCache &GetStateCache()
+        {
+            return mStateCache;
+        }
         OpenGLGraphicsContext *CreateGraphicsContext(const typename OpenGLGraphicsContext::Args &rArgs) override;
         void DestroyTexture(const OpenGLTexture *pTexture) override;
         void Submit();
@@ -81,10 +86,19 @@ namespace FastCG
         std::unordered_map<GLuint, std::vector<GLint>, IdentityHasher<GLuint>> mFboIdToTextureIds;
         std::unordered_map<size_t, GLuint, IdentityHasher<size_t>> mVaoIds;
         DeviceProperties mDeviceProperties{};
+        OpenGLStateCache mStateCache;
+        // persistently mapped buffer that uploads are staged in, w/ one region of stagingBufferSize bytes per frame
+        // in flight (0/nullptr if persistent mapping isn't available)
+        GLuint mUploadRingId{0};
+        uint8_t *mpUploadRingData{nullptr};
+        size_t mUploadRingOffset{0};
         GLsync mFrameFences[2]{nullptr, nullptr}; // double-buffered
         uint32_t mCurrentFrame{0};                // 0 or 1 (double-buffering)
 
         void OnInitialize() override;
+        void OnPreFinalize() override;
+        void ConstructShaders(const std::vector<OpenGLShader::Args> &rArgs,
+                              std::vector<OpenGLShader *> &rShaders) override;
         void Resize()
         {
         }
@@ -95,6 +109,14 @@ namespace FastCG
         void CreateOpenGLHeadedContext(void *pWindow);
         void DestroyOpenGLContext(void *pWindow);
         void QueryDeviceProperties();
+        void CreateUploadRing();
+        void DestroyUploadRing();
+        // returns false if the data doesn't fit in the current frame's region
+        bool CopyToUploadRing(const void *pSrc, size_t size, size_t &rOffset);
+        inline GLuint GetUploadRingId() const
+        {
+            return mUploadRingId;
+        }
         GLuint GetOrCreateFramebuffer(const OpenGLTexture *const *pRenderTargets, uint32_t renderTargetCount,
                                       const OpenGLTexture *pDepthStencilBuffer);
         GLuint GetOrCreateVertexArray(const OpenGLBuffer *const *pBuffers, uint32_t bufferCount);
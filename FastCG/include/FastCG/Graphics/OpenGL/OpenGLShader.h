@@ -3,6 +3,7 @@
 
 #ifdef FASTCG_OPENGL
 
+#include <FastCG/Core/Hash.h>
 #include <FastCG/Graphics/BaseShader.h>
 #include <FastCG/Graphics/OpenGL/OpenGL.h>
 
@@ -19,7 +20,8 @@ namespace FastCG
         GLint type;
     };
 
-    using OpenGLResourceInfoMap = std::unordered_map<std::string, OpenGLResourceInfo>;
+    using OpenGLResourceInfoMap =
+        std::unordered_map<ShaderResourceId, OpenGLResourceInfo, IdentityHasher<ShaderResourceId>>;
 
     class OpenGLGraphicsSystem;
 
@@ -37,9 +39,9 @@ namespace FastCG
         {
             return mProgramId;
         }
-        inline OpenGLResourceInfo GetResourceInfo(const std::string &rName) const
+        inline OpenGLResourceInfo GetResourceInfo(ShaderResourceId id) const
         {
-            auto it = mResourceInfo.find(rName);
+            auto it = mResourceInfo.find(id);
             if (it != mResourceInfo.end())
             {
                 return it->second;
@@ -59,6 +61,15 @@ namespace FastCG
         ShaderTypeValueArray<GLuint> mShadersIds{};
         OpenGLResourceInfoMap mResourceInfo;
 
+        // finishLinking: whether to wait for the program to be linked, otherwise FinishLinking() has to be called
+        // later (so drivers can compile and link several programs in the background)
+        OpenGLShader(const Args &rArgs, bool finishLinking);
+
+        // retrievable: whether the program binary will be retrieved after linking
+        void Compile(const Args &rArgs, bool retrievable);
+        void FinishLinking(const Args &rArgs);
+        void CheckCompileStatus(const Args &rArgs);
+
         friend class OpenGLGraphicsSystem;
     };
 
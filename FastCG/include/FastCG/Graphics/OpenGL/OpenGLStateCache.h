@@ -0,0 +1,135 @@
+#ifndef FASTCG_OPENGL_STATE_CACHE_H
+#define FASTCG_OPENGL_STATE_CACHE_H
+
+#ifdef FASTCG_OPENGL
+
+#include <FastCG/Core/Hash.h>
+#include <FastCG/Graphics/OpenGL/OpenGL.h>
+
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace FastCG
+{
+    // Shadows the GL state that is set through it and drops the calls that wouldn't change anything.
+    // GL state belongs to the GL context (not to OpenGLGraphicsContext), so there's a single cache, owned by the
+    // graphics system, and all the code that touches the state it tracks must go through it.
+    // State that hasn't been set through the cache yet is unknown and is always forwarded to GL.
+    class OpenGLStateCache
+    {
+    public:
+        // forget everything (e.g., after the GL context is (re)created)
+        void Invalidate();
+        bool IsEnabled(GLenum capability);
+        void SetEnabled(GLenum capability, bool enabled);
+        void SetBlendEquation(GLenum color, GLenum alpha);
+        void SetBlendFunc(GLenum srcColor, GLenum dstColor, GLenum srcAlpha, GLenum dstAlpha);
+        void SetStencilFunc(GLenum face, GLenum func, GLint ref, GLuint mask);
+        void SetStencilOp(GLenum face, GLenum stencilFail, GLenum depthFail, GLenum depthPass);
+        void SetStencilWriteMask(GLenum face, GLuint mask);
+        bool GetDepthMask();
+        void SetDepthMask(bool depthMask);
+        void SetDepthFunc(GLenum func);
+        void SetCullFace(GLenum face);
+        void SetViewport(GLint x, GLint y, GLsizei width, GLsizei height);
+        void SetScissor(GLint x, GLint y, GLsizei width, GLsizei height);
+        void UseProgram(GLuint programId);
+        GLuint GetFramebuffer(GLenum target);
+        // returns false if the call was elided
+        bool BindFramebuffer(GLenum target, GLuint fboId);
+        void BindVertexArray(GLuint vaoId);
+        void BindBuffer(GLenum target, GLuint bufferId);
+        void BindBufferRange(GLenum target, GLuint index, GLuint bufferId, GLintptr offset, GLsizeiptr size);
+        void BindTexture(GLuint unit, GLenum target, GLuint textureId);
+        void OnBufferDeleted(GLuint bufferId);
+        void OnTextureDeleted(GLuint textureId);
+        void OnFramebufferDeleted(GLuint fboId);
+        void OnProgramDeleted(GLuint programId);
+        void OnFrameEnd();
+        // number of GL calls elided in the last frame
+        inline uint32_t GetElidedCallCount() const
+        {
+            return mLastElidedCallCount;
+        }
+
+    private:
+        template <typename T>
+        struct Cached
+        {
+            T value{};
+            bool valid{false};
+        };
+
+        template <typename T>
+        using PerFace = std::array<Cached<T>, 2>;
+
+        struct State
+        {
+            std::array<Cached<bool>, 5> enabled;
+            Cached<std::array<GLenum, 2>> blendEquation;
+            Cached<std::array<GLenum, 4>> blendFunc;
+            PerFace<std::array<GLuint, 3>> stencilFunc;
+            PerFace<std::array<GLenum, 3>> stencilOp;
+            PerFace<GLuint> stencilWriteMask;
+            Cached<bool> depthMask;
+            Cached<GLenum> depthFunc;
+            Cached<GLenum> cullFace;
+            Cached<std::array<GLint, 4>> viewport;
+            Cached<std::array<GLint, 4>> scissor;
+            Cached<GLuint> program;
+            Cached<GLuint> drawFbo;
+            Cached<GLuint> readFbo;
+            Cached<GLuint> vao;
+            Cached<GLuint> activeTextureUnit;
+            std::vector<Cached<std::pair<GLenum, GLuint>>> textures;
+            std::unordered_map<GLenum, GLuint, IdentityHasher<GLenum>> buffers;
+            std::unordered_map<uint64_t, std::array<uint64_t, 3>, IdentityHasher<uint64_t>> bufferRanges;
+        };
+
+        State mState;
+        uint32_t mElidedCallCount{0};
+        uint32_t mLastElidedCallCount{0};
+
+        template <typename T>
+        inline bool Changes(Cached<T> &rCached, const T &rValue)
+        {
+            if (rCached.valid && rCached.value == rValue)
+            {
+                mElidedCallCount++;
+                return false;
+            }
+            rCached.value = rValue;
+            rCached.valid = true;
+            return true;
+        }
+        template <typename T>
+        inline bool Changes(GLenum face, PerFace<T> &rCached, const T &rValue)
+        {
+            auto front = face != GL_BACK;
+            auto back = face != GL_FRONT;
+            if ((!front || (rCached[0].valid && rCached[0].value == rValue)) &&
+                (!back || (rCached[1].valid && rCached[1].value == rValue)))
+            {
+                mElidedCallCount++;
+                return false;
+            }
+            if (front)
+            {
+                rCached[0] = {rValue, true};
+            }
+            if (back)
+            {
+                rCached[1] = {rValue, true};
+            }
+            return true;
+        }
+    };
+
+}
+
+#endif
+
+#endif
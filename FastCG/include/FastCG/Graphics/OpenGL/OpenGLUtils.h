@@ -43,6 +43,10 @@ namespace FastCG
         {
             return GL_ELEMENT_ARRAY_BUFFER;
         }
+        else if ((usage & BufferUsageFlagBit::INDIRECT) != 0)
+        {
+            return GL_DRAW_INDIRECT_BUFFER;
+        }
         else
         {
             FASTCG_THROW_EXCEPTION(Exception, "Couldn't get a GL target (usage: %d)", (int)usage);
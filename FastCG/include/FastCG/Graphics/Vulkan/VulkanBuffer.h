@@ -35,6 +35,8 @@ namespace FastCG
             VkBuffer buffer;
             VmaAllocation allocation;
             VmaAllocationInfo allocationInfo;
+            // only meaningful for buffers backed by mappable memory
+            bool hostCoherent;
         };
 
         VulkanBuffer(const Args &rArgs);
@@ -46,10 +48,20 @@ namespace FastCG
         {
             return mFrameData[frameIndex];
         }
+        inline uint32_t GetFrameDataCount() const
+        {
+            return (uint32_t)mFrameData.size();
+        }
         inline bool IsMultiFrame() const
         {
             return IsDynamic() && !mForceSingleFrameDataCount;
         }
+        // mappable memory stays mapped for the whole lifetime of the buffer (nullptr otherwise).
+        // writes to non-coherent memory must be flushed with vmaFlushAllocation.
+        inline void *GetMappedData(uint32_t frameIndex) const
+        {
+            return mFrameData[frameIndex].allocationInfo.pMappedData;
+        }
 
         VulkanBuffer &operator=(const VulkanBuffer &rOther) = delete;
 
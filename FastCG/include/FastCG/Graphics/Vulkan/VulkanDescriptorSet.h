@@ -12,9 +12,15 @@
 
 namespace FastCG
 {
-    union VulkanDescriptorSetBinding {
-        const VulkanBuffer *pBuffer;
-        const VulkanTexture *pTexture;
+    struct VulkanDescriptorSetBinding
+    {
+        union {
+            const VulkanBuffer *pBuffer;
+            const VulkanTexture *pTexture;
+        };
+        // bound range of buffers
+        uint32_t offset;
+        uint32_t size;
     };
 
     struct VulkanDescriptorSet
@@ -28,6 +34,8 @@ namespace FastCG
     struct VulkanPipelineLayout
     {
         static constexpr uint32_t MAX_SET_COUNT = 16;
+        // uniform buffers past this count (or past the device limit) fallback to regular uniform buffer descriptors
+        static constexpr uint32_t MAX_DYNAMIC_UNIFORM_BUFFER_COUNT = 16;
 
         uint32_t setCount;
         VulkanDescriptorSet pSet[MAX_SET_COUNT];
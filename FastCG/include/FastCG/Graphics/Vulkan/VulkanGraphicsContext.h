@@ -43,14 +43,16 @@ namespace FastCG
         void SetScissorTest(bool scissorTest);
         void SetCullMode(Face face);
         void Copy(const VulkanBuffer *pDst, const void *pSrc, size_t size);
-        void Copy(const VulkanBuffer *pDst, const void *pSrc, uint32_t frameIndex, size_t size);
+        void Copy(const VulkanBuffer *pDst, const void *pSrc, size_t offset, size_t size);
+        void Copy(const VulkanBuffer *pDst, const void *pSrc, uint32_t frameIndex, size_t offset, size_t size);
         void Copy(const VulkanTexture *pDst, const void *pSrc, size_t size);
         void Copy(void *pDst, const VulkanBuffer *pSrc, size_t offset, size_t size);
         void Copy(void *pDst, const VulkanBuffer *pSrc, uint32_t frameIndex, size_t offset, size_t size);
         void AddMemoryBarrier();
         void BindShader(const VulkanShader *pShader);
-        void BindResource(const VulkanBuffer *pBuffer, const char *pName);
-        void BindResource(const VulkanTexture *pTexture, const char *pName);
+        void BindResource(const VulkanBuffer *pBuffer, ShaderResourceId id);
+        void BindResource(const VulkanBuffer *pBuffer, size_t offset, size_t size, ShaderResourceId id);
+        void BindResource(const VulkanTexture *pTexture, ShaderResourceId id);
         void Blit(const VulkanTexture *pSrc, const VulkanTexture *pDst);
         void SetRenderTargets(const VulkanTexture *const *ppRenderTargets, uint32_t renderTargetCount,
                               const VulkanTexture *pDepthStencilBuffer);
@@ -63,14 +65,22 @@ namespace FastCG
         void DrawIndexed(PrimitiveType primitiveType, uint32_t firstIndex, uint32_t indexCount, int32_t vertexOffset);
         void DrawInstancedIndexed(PrimitiveType primitiveType, uint32_t firstInstance, uint32_t instanceCount,
                                   uint32_t firstIndex, uint32_t indexCount, int32_t vertexOffset);
+        void DrawIndexedIndirect(PrimitiveType primitiveType, const VulkanBuffer *pIndirectBuffer, size_t offset);
+        void MultiDrawIndexedIndirect(PrimitiveType primitiveType, const VulkanBuffer *pIndirectBuffer, size_t offset,
+                                      uint32_t drawCount, uint32_t stride);
         void Dispatch(uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ);
         void End();
         double GetElapsedTime(uint32_t frame) const;
+        inline QueueType GetQueueType() const
+        {
+            return mQueueType;
+        }
 
     private:
         enum class DrawCommandType : uint8_t
         {
-            INSTANCED_INDEXED
+            INSTANCED_INDEXED,
+            INDEXED_INDIRECT
         };
 
         struct ClearCommand
@@ -96,6 +106,8 @@ namespace FastCG
             {
                 const VulkanBuffer *pBuffer{nullptr};
                 uint32_t frameIndex{~0u};
+                size_t offset{0};
+                size_t size{0};
             };
 
             struct TextureData
@@ -163,6 +175,8 @@ namespace FastCG
             VulkanPipelineLayout pipelineLayout;
             uint32_t setCount = 0;
             VkDescriptorSet pSets[VulkanPipelineLayout::MAX_SET_COUNT];
+            uint32_t dynamicOffsetCount = 0;
+            uint32_t pDynamicOffsets[VulkanPipelineLayout::MAX_DYNAMIC_UNIFORM_BUFFER_COUNT];
             union {
                 struct
                 {
@@ -178,6 +192,10 @@ namespace FastCG
                     uint32_t vertexBufferCount;
                     VkBuffer pVertexBuffers[MAX_VERTEX_BUFFER_COUNT];
                     VkBuffer indexBuffer;
+                    VkBuffer indirectBuffer;
+                    VkDeviceSize indirectOffset;
+                    uint32_t drawCount;
+                    uint32_t stride;
                 } drawInfo;
                 struct
                 {
@@ -231,6 +249,8 @@ namespace FastCG
             };
         };
 
+        // resolved queue (the requested one may not be available)
+        QueueType mQueueType;
         VulkanRenderPassDescription mRenderPassDescription;
         VulkanPipelineDescription mPipelineDescription;
         VulkanPipelineLayout mPipelineLayout;
@@ -239,8 +259,10 @@ namespace FastCG
         std::vector<ClearCommand> mClearCommands;
         std::vector<CopyCommand> mCopyCommands;
         std::vector<InvokeCommand> mInvokeCommands;
+        std::vector<VkCommandBuffer> mSecondaryCommandBuffers;
         bool mNoDrawSinceLastRenderTargetsSet{true};
         bool mAddMemoryBarrier{false};
+        bool mNewComputePassBatch{false};
         bool mEnded{true};
 #if _DEBUG
         std::vector<MarkerCommand> mMarkerCommands;
@@ -255,14 +277,20 @@ namespace FastCG
         std::vector<double> mElapsedTimes;
 #endif
 
+        VkCommandBuffer GetCommandBuffer() const;
         void AddBufferMemoryBarrier(VkBuffer buffer, VkAccessFlags srcAccessMask, VkAccessFlags dstAccessMask,
                                     VkPipelineStageFlags srcStageMask, VkPipelineStageFlags dstStageMask);
         void AddTextureMemoryBarrier(const VulkanTexture *pTexture, VkImageLayout oldLayout, VkImageLayout newLayout,
                                      VkAccessFlags srcAccessMask, VkAccessFlags dstAccessMask,
                                      VkPipelineStageFlags srcStageMask, VkPipelineStageFlags dstStageMask);
+        // sub-allocates from the current frame's staging ring, false if the data doesn't fit
+        bool StageData(const void *pSrc, size_t size, size_t alignment,
+                       CopyCommandArgs::BufferData &rStagingBufferData);
         void EnqueueCopyCommand(CopyCommandType type, const CopyCommandArgs &rArgs);
-        void EnqueueDrawCommand(DrawCommandType type, PrimitiveType primitiveType, uint32_t firstInstance,
-                                uint32_t instanceCount, uint32_t firstIndex, uint32_t indexCount, int32_t vertexOffset);
+        // returns nullptr if the draw was skipped (i.e., its pipeline is still being compiled in the background)
+        InvokeCommand *EnqueueDrawCommand(DrawCommandType type, PrimitiveType primitiveType, uint32_t firstInstance,
+                                          uint32_t instanceCount, uint32_t firstIndex, uint32_t indexCount,
+                                          int32_t vertexOffset);
         void EnqueueDispatchCommand(uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ);
         void EnqueueTimestampQuery(uint32_t query, VkPipelineStageFlagBits pipelineStage);
 #if !defined FASTCG_DISABLE_GPU_TIMING
@@ -10,15 +10,22 @@
 #include <FastCG/Graphics/Vulkan/VulkanBuffer.h>
 #include <FastCG/Graphics/Vulkan/VulkanDescriptorSet.h>
 #include <FastCG/Graphics/Vulkan/VulkanGraphicsContext.h>
+#include <FastCG/Graphics/Vulkan/VulkanObjectCache.h>
 #include <FastCG/Graphics/Vulkan/VulkanPipeline.h>
 #include <FastCG/Graphics/Vulkan/VulkanRenderPass.h>
 #include <FastCG/Graphics/Vulkan/VulkanShader.h>
 #include <FastCG/Graphics/Vulkan/VulkanTexture.h>
 
+#include <algorithm>
 #include <cassert>
+#include <condition_variable>
 #include <cstdint>
 #include <deque>
+#include <exception>
+#include <list>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <tuple>
 #include <unordered_map>
 #include <vector>
@@ -79,6 +86,13 @@ namespace FastCG
         inline void DestroyTexture(const VulkanTexture *pTexture) override;
         void Submit();
         void WaitPreviousFrame();
+        // compile the pipelines on the worker threads, draws that need one of them are skipped until it's ready
+        void PrewarmGraphicsPipelines(const std::vector<VulkanPipelineDescription> &rPipelineDescriptions,
+                                      const VulkanRenderPassDescription &rRenderPassDescription);
+        // dispatches that need one of those pipelines wait for it instead
+        void PrewarmComputePipelines(const std::vector<VulkanPipelineDescription> &rPipelineDescriptions);
+        bool IsPrewarmingPipelines();
+        void WaitForPipelinePrewarm();
         void OnPostWindowInitialize(void *pWindow);
         void OnPreWindowTerminate(void *pWindow)
         {
@@ -93,6 +107,8 @@ namespace FastCG
         void OnInitialize() override;
         void OnPreFinalize() override;
         void OnPostFinalize() override;
+        void ConstructShaders(const std::vector<VulkanShader::Args> &rArgs,
+                              std::vector<VulkanShader *> &rShaders) override;
 
     private:
         static constexpr VkFormat LAST_FORMAT = VK_FORMAT_ASTC_12x12_SRGB_BLOCK;
@@ -104,7 +120,14 @@ namespace FastCG
                 BUFFER,
                 SHADER,
                 TEXTURE,
-                FRAME_BUFFER
+                FRAME_BUFFER,
+                DESCRIPTOR_SET
+            };
+
+            struct DescriptorSet
+            {
+                VkDescriptorSet set;
+                VkDescriptorPool pool;
             };
 
             uint32_t frame;
@@ -114,6 +137,7 @@ namespace FastCG
                 const VulkanShader *pShader;
                 const VulkanTexture *pTexture;
                 VkFramebuffer frameBuffer;
+                DescriptorSet descriptorSet;
             };
 
             DeferredDestroyRequest(uint32_t frame, const VulkanBuffer *pBuffer)
@@ -132,18 +156,71 @@ namespace FastCG
                 : frame(frame), type(Type::FRAME_BUFFER), frameBuffer(frameBuffer)
             {
             }
+            DeferredDestroyRequest(uint32_t frame, VkDescriptorSet set, VkDescriptorPool pool)
+                : frame(frame), type(Type::DESCRIPTOR_SET), descriptorSet{set, pool}
+            {
+            }
         };
 
-        struct VulkanDescriptorSetLocalPool
+        // read from the shader and the vertex buffers up front, so background compilations don't depend on the
+        // vertex buffers (which can be destroyed at any time)
+        struct VertexInputState
         {
-#if defined FASTCG_ANDROID
-            static constexpr size_t MAX_SET_COUNT = 512;
-#else
-            static constexpr size_t MAX_SET_COUNT = 128;
-#endif
+            std::vector<VkVertexInputAttributeDescription> attributeDescriptions;
+            std::vector<VkVertexInputBindingDescription> bindingDescriptions;
+        };
+
+        struct PipelineCompileJob
+        {
+            uint64_t hash;
+            VulkanObjectKey key;
+            VulkanPipelineDescription description;
+            VertexInputState vertexInputState;
+            // VK_NULL_HANDLE for compute pipelines
+            VkRenderPass renderPass;
+            uint32_t renderTargetCount;
+            VkPipelineLayout layout;
+            VkPipeline pipeline{VK_NULL_HANDLE};
+            std::exception_ptr exception;
+        };
 
-            VkDescriptorSet descriptorSets[MAX_SET_COUNT]{};
-            size_t lastDescriptorSetIdx{0};
+        struct FrameBufferEntry
+        {
+            uint64_t hash;
+            std::vector<VkImage> renderTargets;
+        };
+
+        struct DescriptorSetCacheEntry
+        {
+            uint64_t hash;
+            VkDescriptorSet descriptorSet;
+            VkDescriptorPool descriptorPool;
+            // image views and buffers the set points to (no duplicates)
+            std::vector<uint64_t> resources;
+        };
+
+        // most recently used first
+        using DescriptorSetLru = std::list<DescriptorSetCacheEntry>;
+
+        // queue of a family without graphics support, so compute and transfer work can overlap with rendering.
+        // its work is submitted right before the graphics work of the same frame, which waits on it.
+        struct DedicatedQueue
+        {
+            uint32_t familyIdx{~0u};
+            VkQueue queue{VK_NULL_HANDLE};
+            VkCommandPool commandPool{VK_NULL_HANDLE};
+            // one per frame in flight
+            std::vector<VkCommandBuffer> commandBuffers;
+            std::vector<VkSemaphore> submitFinishedSemaphores;
+            bool recording{false};
+        };
+
+        // one per frame in flight and recording thread, so secondary command buffers can be recorded without locking
+        struct SecondaryCommandBufferPool
+        {
+            VkCommandPool commandPool{VK_NULL_HANDLE};
+            std::vector<VkCommandBuffer> commandBuffers;
+            size_t nextCommandBufferIdx{0};
         };
 
         VkInstance mInstance{VK_NULL_HANDLE};
@@ -152,6 +229,10 @@ namespace FastCG
         VkSurfaceKHR mSurface{VK_NULL_HANDLE};
         VkPhysicalDevice mPhysicalDevice{VK_NULL_HANDLE};
         VkPhysicalDeviceProperties mPhysicalDeviceProperties{};
+        VkPhysicalDeviceFeatures mPhysicalDeviceFeatures{};
+        VkPhysicalDeviceFeatures mEnabledPhysicalDeviceFeatures{};
+        // frame buffers are created from attachment descriptions and get their image views on render pass begin
+        bool mImagelessFrameBufferSupported{false};
         VkPhysicalDeviceMemoryProperties mPhysicalDeviceMemoryProperties{};
         VkFormatProperties mPhysicalDeviceFormatProperties[((size_t)LAST_FORMAT) + 1]{};
         std::vector<VkExtensionProperties> mPhysicalDeviceExtensionProperties;
@@ -162,8 +243,12 @@ namespace FastCG
         uint32_t mQueueFamilyIdx{~0u};
         bool mQueueSupportsPresentation{false};
         bool mQueueSupportsCompute{false};
-        // support only one queue at the moment
+        // graphics (and present) queue
         VkQueue mQueue{VK_NULL_HANDLE};
+        // indexed by QueueType (the graphics entry is never used)
+        DedicatedQueue mDedicatedQueues[(size_t)QueueType::LAST];
+        // distinct families of all queues, resources are shared between them when there's more than one
+        std::vector<uint32_t> mQueueFamilyIndices;
         VkPresentModeKHR mPresentMode{VK_PRESENT_MODE_IMMEDIATE_KHR};
         VkSurfaceFormatKHR mSurfaceSwapChainFormat{};
         // FIXME: because of headless-mode, forcing max simultaneous frame to three so we don't need to write complex
@@ -179,26 +264,62 @@ namespace FastCG
         std::vector<VkFence> mFrameFences;
         VkCommandPool mCommandPool{VK_NULL_HANDLE};
         std::vector<VkCommandBuffer> mCommandBuffers;
-        VkDescriptorPool mDescriptorPool{VK_NULL_HANDLE};
+        // secondary command buffers are recorded in parallel on the worker threads (see VulkanGraphicsContext::End()),
+        // which also run the background pipeline compilations in between.
+        // indexed by frame * (worker thread count + 1) + thread index
+        std::vector<SecondaryCommandBufferPool> mSecondaryCommandBufferPools;
+        // a new pool is only created when none of the existing ones has room for a set
+        std::vector<VkDescriptorPool> mDescriptorPools;
+        // pool tried first: the last one that allocated or got a set back
+        size_t mDescriptorPoolHint{0};
         std::vector<VkQueryPool> mQueryPools{VK_NULL_HANDLE};
 #if _DEBUG
         VkDebugUtilsMessengerEXT mDebugMessenger;
 #endif
         VmaAllocator mAllocator;
-        std::unordered_map<size_t, VkRenderPass, IdentityHasher<size_t>> mRenderPasses;
-        std::unordered_map<size_t, VkFramebuffer, IdentityHasher<size_t>> mFrameBuffers;
-        std::unordered_map<size_t, VkPipeline, IdentityHasher<size_t>> mPipelines;
-        std::unordered_map<size_t, VkPipelineLayout, IdentityHasher<size_t>> mPipelineLayouts;
-        std::unordered_map<size_t, VkDescriptorSetLayout, IdentityHasher<size_t>> mDescriptorSetLayouts;
-        std::vector<std::unordered_map<size_t, VulkanDescriptorSetLocalPool, IdentityHasher<size_t>>>
-            mDescriptorSetLocalPools;
+        VulkanObjectCache<VkRenderPass> mRenderPasses;
+        // first render pass created for each set of compatible render passes (same attachment formats), shared by
+        // pipelines and frame buffers regardless of load/store ops and layouts
+        VulkanObjectCache<VkRenderPass> mCompatibleRenderPasses;
+        VulkanObjectCache<VkFramebuffer> mFrameBuffers;
+        VulkanObjectCache<VkPipeline> mPipelines;
+        VulkanObjectCache<VkPipelineLayout> mPipelineLayouts;
+        VulkanObjectCache<VkDescriptorSetLayout> mDescriptorSetLayouts;
+        // scratch keys, one per cache cause lookups nest (e.g., pipeline -> pipeline layout -> set layout)
+        VulkanObjectKey mRenderPassKey;
+        VulkanObjectKey mCompatibleRenderPassKey;
+        VulkanObjectKey mFrameBufferKey;
+        VulkanObjectKey mPipelineKey;
+        VulkanObjectKey mPipelineLayoutKey;
+        VulkanObjectKey mDescriptorSetLayoutKey;
+        // descriptor sets keyed by set layout and bound resources, so unchanged bindings are never rewritten
+        VulkanObjectCache<DescriptorSetLru::iterator> mDescriptorSets;
+        DescriptorSetLru mDescriptorSetLru;
+        // cached sets pointing to each resource, so destroying one doesn't scan the whole cache
+        std::unordered_map<uint64_t, std::vector<DescriptorSetLru::iterator>, IdentityHasher<uint64_t>>
+            mResourceToDescriptorSets;
+        VulkanObjectKey mDescriptorSetKey;
         std::unordered_map<VkImage, VulkanImageMemoryBarrier, IdentityHasher<VkImage>> mLastImageMemoryBarriers;
         std::unordered_map<VkBuffer, VulkanBufferMemoryBarrier, IdentityHasher<VkBuffer>> mLastBufferMemoryBarriers;
         VulkanGraphicsContext *mpImmediateGraphicsContext;
         std::deque<DeferredDestroyRequest> mDeferredDestroyRequests;
-        std::unordered_map<VkImage, size_t, IdentityHasher<VkImage>> mRenderTargetToFrameBufferHash;
-        std::unordered_map<size_t, std::vector<VkImage>, IdentityHasher<size_t>> mFrameBufferHashToRenderTargets;
+        std::unordered_map<VkImage, std::vector<VkFramebuffer>, IdentityHasher<VkImage>> mRenderTargetToFrameBuffers;
+        std::unordered_map<VkFramebuffer, FrameBufferEntry, IdentityHasher<VkFramebuffer>> mFrameBufferEntries;
         std::vector<uint32_t> mNextQueries;
+        // linear allocator for uploads, one region per frame in flight (reset once the frame fence is signaled)
+        const VulkanBuffer *mpStagingRing{nullptr};
+        size_t mStagingRingOffset{0};
+        size_t mStagingRingAlignment{0};
+        // persisted across runs (see CreatePipelineCache()/SavePipelineCache())
+        VkPipelineCache mPipelineCache{VK_NULL_HANDLE};
+        // background pipeline compilation, pipelines being compiled are VK_NULL_HANDLE in mPipelines
+        std::mutex mPipelineCompileMutex;
+        std::condition_variable mPipelineCompileJobDone;
+        std::deque<std::unique_ptr<PipelineCompileJob>> mQueuedPipelineCompileJobs;
+        std::vector<std::unique_ptr<PipelineCompileJob>> mDonePipelineCompileJobs;
+        size_t mPendingPipelineCompileJobCount{0};
+        // shader modules have to outlive the compilations that use them
+        std::unordered_map<const VulkanShader *, size_t> mPendingPipelineCompileJobCountPerShader;
 #if defined FASTCG_LINUX
         XVisualInfo *mpVisualInfo{nullptr};
 #endif
@@ -207,11 +328,18 @@ namespace FastCG
         inline VkDevice GetDevice() const;
         inline VmaAllocator GetAllocator() const;
         inline const VulkanTexture *GetCurrentSwapChainTexture() const;
+        inline const VulkanBuffer *GetStagingRing() const;
         inline VulkanGraphicsContext *GetImmediateGraphicsContext() const;
         inline VkCommandBuffer GetCurrentCommandBuffer() const;
+        inline bool HasDedicatedQueue(QueueType queueType) const;
+        inline const std::vector<uint32_t> &GetQueueFamilyIndices() const;
+        // begins the command buffer of dedicated queues on first use in the frame
+        VkCommandBuffer GetCurrentCommandBuffer(QueueType queueType);
         inline VkAllocationCallbacks *GetAllocationCallbacks() const;
         inline const VkFormatProperties *GetFormatProperties(VkFormat format) const;
         inline const VkPhysicalDeviceProperties &GetPhysicalDeviceProperties() const;
+        inline const VkPhysicalDeviceFeatures &GetEnabledPhysicalDeviceFeatures() const;
+        inline bool IsImagelessFrameBufferSupported() const;
         inline VkQueryPool GetQueryPool(uint32_t frame) const;
         inline uint32_t NextQuery();
         void CreateInstance();
@@ -220,6 +348,7 @@ namespace FastCG
         void CreateAllocator();
         void AcquirePhysicalDeviceProperties();
         void AcquirePhysicalDeviceSurfaceProperties();
+        void SelectDedicatedQueueFamilies();
         void CreateDeviceAndGetQueues();
         void RecreateSwapChain();
         void CreateSurfaceSwapChainAndAcquireNextImage();
@@ -227,19 +356,32 @@ namespace FastCG
         void CreateSurfacelessSwapChain();
         void CreateSynchronizationObjects();
         void CreateCommandPoolAndCommandBuffers();
-        void CreateDescriptorPool();
+        VkDescriptorPool CreateDescriptorPool();
+        VkDescriptorSet AllocateDescriptorSet(VkDescriptorSetLayout setLayout, VkDescriptorPool &rDescriptorPool);
+        void EvictDescriptorSet(DescriptorSetLru::iterator it);
+        void InvalidateDescriptorSets(uint64_t resource);
         void CreateQueryPool();
         void BeginCurrentCommandBuffer();
+        VkCommandBuffer AcquireSecondaryCommandBuffer(uint32_t threadIdx);
+        void ResetSecondaryCommandBufferPools();
         void ResetQueryPool();
         void CreateImmediateGraphicsContext();
+        void CreateStagingRing();
+        void CreatePipelineCache();
         void EndCurrentCommandBuffer();
+        void SubmitDedicatedQueues(std::vector<VkSemaphore> &rWaitSemaphores,
+                                   std::vector<VkPipelineStageFlags> &rWaitDstStageMasks);
+        void SavePipelineCache();
+        void CancelPipelineCompileJobs();
+        void DestroyPipelineCache();
+        void DestroyStagingRing();
         void DestroyDescriptorSetLayouts();
         void DestroyPipelineLayouts();
         void DestroyPipelines();
         void DestroyFrameBuffers();
         void DestroyRenderPasses();
         void DestroyQueryPool();
-        void DestroyDescriptorPool();
+        void DestroyDescriptorPools();
         void DestroyCommandPoolAndCommandBuffers();
         void DestroySynchronizationObjects();
         void DestroySwapChain();
@@ -257,28 +399,54 @@ namespace FastCG
         void PopDebugMarker(VkCommandBuffer commandBuffer);
         void SetObjectName(const char *pObjectName, VkObjectType objectType, uint64_t objectHandle);
 #endif
-        std::pair<size_t, VkRenderPass> GetOrCreateRenderPass(const VulkanRenderPassDescription &rRenderPassDescription,
-                                                              bool depthWrite, bool stencilWrite);
-        std::pair<size_t, VkFramebuffer> GetOrCreateFrameBuffer(
+        std::pair<uint64_t, VkRenderPass> GetOrCreateRenderPass(
             const VulkanRenderPassDescription &rRenderPassDescription, bool depthWrite, bool stencilWrite);
-        std::pair<size_t, VulkanPipeline> GetOrCreateGraphicsPipeline(
+        VkRenderPass GetOrCreateCompatibleRenderPass(const VulkanRenderPassDescription &rRenderPassDescription,
+                                                     bool depthWrite, bool stencilWrite);
+        // imageless frame buffers only depend on the attachments' formats, usages and extents, so they're shared by
+        // render targets alike (image views are passed on render pass begin, see VulkanGraphicsContext::End())
+        std::pair<uint64_t, VkFramebuffer> GetOrCreateFrameBuffer(
+            const VulkanRenderPassDescription &rRenderPassDescription, bool depthWrite, bool stencilWrite);
+        std::pair<uint64_t, VulkanPipeline> GetOrCreateGraphicsPipeline(
             const VulkanPipelineDescription &rPipelineDescription, VkRenderPass renderPass, uint32_t renderTargetCount);
-        std::pair<size_t, VulkanPipeline> GetOrCreateComputePipeline(
+        std::pair<uint64_t, VulkanPipeline> GetOrCreateComputePipeline(
             const VulkanPipelineDescription &rPipelineDescription);
-        std::pair<size_t, VkPipelineLayout> GetOrCreatePipelineLayout(
+        // thread-safe
+        VkPipeline CreateGraphicsPipeline(const VulkanPipelineDescription &rPipelineDescription,
+                                          const VertexInputState &rVertexInputState, VkRenderPass renderPass,
+                                          uint32_t renderTargetCount, VkPipelineLayout pipelineLayout) const;
+        VkPipeline CreateComputePipeline(const VulkanPipelineDescription &rPipelineDescription,
+                                         VkPipelineLayout pipelineLayout) const;
+        void EnqueuePipelineCompileJob(uint64_t hash, const VulkanObjectKey &rKey,
+                                       const VulkanPipelineDescription &rPipelineDescription, VkRenderPass renderPass,
+                                       uint32_t renderTargetCount, VkPipelineLayout pipelineLayout);
+        void RunPipelineCompileJob();
+        void CollectDonePipelineCompileJobs();
+        void WaitForDonePipelineCompileJobs();
+        void WaitForPipelineCompileJobs(const VulkanShader *pShader);
+        static void GetVertexInputState(const VulkanPipelineDescription &rPipelineDescription,
+                                        VertexInputState &rVertexInputState);
+        // render targets the shader doesn't write to are removed from the render pass
+        static void GetDrawRenderPassDescription(const VulkanPipelineDescription &rPipelineDescription,
+                                                 const VulkanRenderPassDescription &rRenderPassDescription,
+                                                 VulkanRenderPassDescription &rDrawRenderPassDescription,
+                                                 bool &rDepthWrite, bool &rStencilWrite, uint32_t &rRenderTargetCount);
+        std::pair<uint64_t, VkPipelineLayout> GetOrCreatePipelineLayout(
             const VulkanPipelineLayoutDescription &rPipelineLayoutDescription);
-        std::pair<size_t, VkDescriptorSetLayout> GetOrCreateDescriptorSetLayout(
-            const VulkanDescriptorSetLayout &rDescriptorSetLayout);
-        std::pair<size_t, VkDescriptorSet> GetOrCreateDescriptorSet(
+        std::pair<uint64_t, VkDescriptorSetLayout> GetOrCreateDescriptorSetLayout(
             const VulkanDescriptorSetLayout &rDescriptorSetLayout);
+        // pSetWrites describe the whole set (dstSet is ignored), they're only applied if no cached set matches them
+        VkDescriptorSet GetOrCreateDescriptorSet(const VulkanDescriptorSetLayout &rDescriptorSetLayout,
+                                                 VkWriteDescriptorSet *pSetWrites, uint32_t setWriteCount);
         void PerformDeferredDestroys();
         void FinalizeDeferredDestroys();
+        bool CopyToStagingRing(const void *pSrc, size_t size, size_t alignment, size_t &rOffset);
         inline VulkanImageMemoryBarrier GetLastImageMemoryBarrier(const VulkanTexture *pTexture) const;
         inline VulkanBufferMemoryBarrier GetLastBufferMemoryBarrier(VkBuffer buffer) const;
         inline void NotifyImageMemoryBarrier(const VulkanTexture *pTexture,
                                              const VulkanImageMemoryBarrier &rImageMemoryBarrier);
         inline void NotifyBufferMemoryBarrier(VkBuffer buffer, const VulkanBufferMemoryBarrier &rBufferMemoryBarrier);
-        inline void DestroyFrameBuffer(size_t frameBufferHash);
+        inline void DestroyFrameBuffer(VkFramebuffer frameBuffer);
 
         friend class VulkanBuffer;
         friend class VulkanGraphicsContext;
@@ -0,0 +1,83 @@
+#ifndef FASTCG_VULKAN_OBJECT_CACHE_H
+#define FASTCG_VULKAN_OBJECT_CACHE_H
+
+#ifdef FASTCG_VULKAN
+
+#include <FastCG/Core/Hash.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace FastCG
+{
+    // Key of a Vulkan object cache: the bytes the object is created from, built with Append().
+    // Values are appended with their full size, so pointers, handles and padding-free structs can be used.
+    class VulkanObjectKey final
+    {
+    public:
+        template <typename T>
+        inline void Append(const T &rValue)
+        {
+            Append(&rValue, 1);
+        }
+        template <typename T>
+        inline void Append(const T *pValues, size_t count)
+        {
+            auto *pBytes = reinterpret_cast<const uint8_t *>(pValues);
+            mBytes.insert(mBytes.end(), pBytes, pBytes + sizeof(T) * count);
+        }
+        inline void Clear()
+        {
+            mBytes.clear();
+        }
+        inline const uint8_t *GetData() const
+        {
+            return mBytes.data();
+        }
+        inline size_t GetSize() const
+        {
+            return mBytes.size();
+        }
+        inline uint64_t GetHash() const
+        {
+            return MurmurHash64A(mBytes.data(), mBytes.size());
+        }
+
+    private:
+        std::vector<uint8_t> mBytes;
+    };
+
+    // Maps the 64-bit hash of the keys to the objects created from them.
+    // Full keys are stored and compared on lookup, so hash collisions never return the wrong object.
+    template <typename T>
+    class VulkanObjectCache final
+    {
+    public:
+        // returns nullptr if no object was created from the key
+        inline const T *Find(uint64_t hash, const VulkanObjectKey &rKey) const;
+        inline T *Find(uint64_t hash, const VulkanObjectKey &rKey);
+        inline const T &Add(uint64_t hash, const VulkanObjectKey &rKey, const T &rObject);
+        inline void Remove(uint64_t hash, const T &rObject);
+        template <typename CallbackT>
+        inline void ForEach(CallbackT callback) const;
+        inline void Clear();
+
+    private:
+        struct Entry
+        {
+            std::vector<uint8_t> key;
+            T object;
+        };
+
+        std::unordered_multimap<uint64_t, Entry, IdentityHasher<uint64_t>> mEntries;
+    };
+
+}
+
+#include <FastCG/Graphics/Vulkan/VulkanObjectCache.inc>
+
+#endif
+
+#endif
@@ -38,9 +38,9 @@ namespace FastCG
 
         VulkanShader operator=(const VulkanShader &rOther) = delete;
 
-        inline VulkanResourceLocation GetResourceLocation(const std::string &rName) const
+        inline VulkanResourceLocation GetResourceLocation(ShaderResourceId id) const
         {
-            auto it = mResourceLocation.find(rName);
+            auto it = mResourceLocation.find(id);
             if (it != mResourceLocation.end())
             {
                 return it->second;
@@ -53,7 +53,8 @@ namespace FastCG
 
     private:
         VkShaderModule mModules[(ShaderTypeInt)ShaderType::LAST]{};
-        std::unordered_map<std::string, VulkanResourceLocation> mResourceLocation;
+        std::unordered_map<ShaderResourceId, VulkanResourceLocation, IdentityHasher<ShaderResourceId>>
+            mResourceLocation;
         VulkanPipelineLayoutDescription mPipelineLayoutDescription{};
         VulkanInputDescription mInputDescription;
         VulkanOutputDescription mOutputDescription;
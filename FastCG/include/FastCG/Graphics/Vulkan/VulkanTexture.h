@@ -18,16 +18,18 @@ namespace FastCG
         struct Args : BaseTexture::Args
         {
             VkImage image;
+            // usage the (external) image was created with
+            VkImageUsageFlags imageUsage;
 
             Args(const std::string &rName = "", uint32_t width = 1, uint32_t height = 1, uint32_t depthOrSlices = 1,
                  uint8_t mipCount = 1, TextureType type = TextureType::TEXTURE_2D,
                  TextureUsageFlags usage = TextureUsageFlagBit::SAMPLED,
                  TextureFormat format = TextureFormat::R8G8B8A8_UNORM,
                  TextureFilter filter = TextureFilter::LINEAR_FILTER, TextureWrapMode wrapMode = TextureWrapMode::CLAMP,
-                 const uint8_t *pData = nullptr, VkImage image = VK_NULL_HANDLE)
+                 const uint8_t *pData = nullptr, VkImage image = VK_NULL_HANDLE, VkImageUsageFlags imageUsage = 0)
                 : BaseTexture::Args(rName, width, height, depthOrSlices, mipCount, type, usage, format, filter,
                                     wrapMode, pData),
-                  image(image)
+                  image(image), imageUsage(imageUsage)
             {
             }
         };
@@ -41,6 +43,8 @@ namespace FastCG
 
     private:
         VkImage mImage;
+        VkImageUsageFlags mImageUsage;
+        VkImageCreateFlags mImageCreateFlags{0};
         VmaAllocation mAllocation{VK_NULL_HANDLE};
         VmaAllocationInfo mAllocationInfo;
         VkImageView mDefaultImageView{VK_NULL_HANDLE};
@@ -51,6 +55,14 @@ namespace FastCG
         {
             return mImage;
         }
+        inline VkImageUsageFlags GetImageUsageFlags() const
+        {
+            return mImageUsage;
+        }
+        inline VkImageCreateFlags GetImageCreateFlags() const
+        {
+            return mImageCreateFlags;
+        }
         inline bool OwnsImage() const
         {
             return mAllocation != VK_NULL_HANDLE;
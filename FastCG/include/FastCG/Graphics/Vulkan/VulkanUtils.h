@@ -512,6 +512,10 @@ namespace FastCG
         {
             usageFlags |= VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
         }
+        if ((usage & BufferUsageFlagBit::INDIRECT) != 0)
+        {
+            usageFlags |= VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT;
+        }
         usageFlags |= VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
         usageFlags |= VK_BUFFER_USAGE_TRANSFER_DST_BIT;
         return usageFlags;
@@ -528,6 +532,10 @@ namespace FastCG
         {
             stageFlags |= VK_PIPELINE_STAGE_VERTEX_INPUT_BIT;
         }
+        if ((usage & BufferUsageFlagBit::INDIRECT) != 0)
+        {
+            stageFlags |= VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT;
+        }
         if ((usage & BufferUsageFlagBit::DYNAMIC) != 0)
         {
             stageFlags |= VK_PIPELINE_STAGE_TRANSFER_BIT;
@@ -559,6 +567,10 @@ namespace FastCG
         {
             accessFlags |= VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT;
         }
+        if ((usage & BufferUsageFlagBit::INDIRECT) != 0)
+        {
+            accessFlags |= VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+        }
         assert(accessFlags != 0);
         return accessFlags;
     }
@@ -31,6 +31,10 @@ namespace FastCG
         {
             return mAndroidApp->activity->internalDataPath;
         }
+        std::filesystem::path GetDataPath() const override
+        {
+            return GetInternalDataPath();
+        }
         inline JNIEnv *GetJniEnv()
         {
             return mJniEnv;
@@ -43,6 +43,7 @@ namespace FastCG
             uint32_t maxSimultaneousFrames{3};
             bool vsync{false};
             bool headless{false};
+            size_t stagingBufferSize{32 * 1024 * 1024};
         } graphics;
         struct
         {
@@ -111,6 +112,12 @@ namespace FastCG
             return mFrameCount;
         }
 
+        // directory in which the application can persist data (eg, caches) across runs
+        virtual std::filesystem::path GetDataPath() const
+        {
+            return std::filesystem::current_path();
+        }
+
         int Run();
         int Run(int argc, char **argv);
 
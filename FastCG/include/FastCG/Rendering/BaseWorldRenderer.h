@@ -1,8 +1,11 @@
 #ifndef FASTCG_BASE_WORLD_RENDERER_H
 #define FASTCG_BASE_WORLD_RENDERER_H
 
+#include <FastCG/Core/Frustum.h>
+#include <FastCG/Core/Hash.h>
 #include <FastCG/Graphics/GraphicsContextState.h>
 #include <FastCG/Rendering/DirectionalLight.h>
+#include <FastCG/Rendering/DrawList.h>
 #include <FastCG/Rendering/Fog.h>
 #include <FastCG/Rendering/IWorldRenderer.h>
 #include <FastCG/Rendering/Light.h>
@@ -13,6 +16,7 @@
 #include <FastCG/Rendering/Renderable.h>
 #include <FastCG/Rendering/RenderingStatistics.h>
 #include <FastCG/Rendering/ShaderConstants.h>
+#include <FastCG/Rendering/UniformAllocator.h>
 
 #include <glm/glm.hpp>
 
@@ -21,6 +25,7 @@
 #include <tuple>
 #include <type_traits>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace FastCG
@@ -113,6 +118,46 @@ namespace FastCG
             mSSAOBlurEnabled = ssaoBlurEnabled;
         }
 
+        inline bool IsFrustumCullingEnabled() const override
+        {
+            return mFrustumCullingEnabled;
+        }
+
+        inline void SetFrustumCullingEnabled(bool frustumCullingEnabled) override
+        {
+            mFrustumCullingEnabled = frustumCullingEnabled;
+        }
+
+        inline bool IsInstanceResidencyEnabled() const override
+        {
+            return mInstanceResidencyEnabled;
+        }
+
+        inline void SetInstanceResidencyEnabled(bool instanceResidencyEnabled) override
+        {
+            mInstanceResidencyEnabled = instanceResidencyEnabled;
+        }
+
+        inline bool IsIndirectDrawEnabled() const override
+        {
+            return mIndirectDrawEnabled;
+        }
+
+        inline void SetIndirectDrawEnabled(bool indirectDrawEnabled) override
+        {
+            mIndirectDrawEnabled = indirectDrawEnabled;
+        }
+
+        inline bool IsGPUCullingEnabled() const override
+        {
+            return mGPUCullingEnabled;
+        }
+
+        inline void SetGPUCullingEnabled(bool gpuCullingEnabled) override
+        {
+            mGPUCullingEnabled = gpuCullingEnabled;
+        }
+
         inline Tonemapper GetTonemapper() const
         {
             return mTonemapper;
@@ -133,42 +178,97 @@ namespace FastCG
         std::unique_ptr<Mesh> mpQuadMesh{nullptr};
 
         virtual void OnRender(const Camera *pCamera, GraphicsContext *pGraphicsContext) = 0;
-        inline void GenerateShadowMaps(GraphicsContext *pGraphicsContext);
+        inline void GenerateShadowMaps(const Frustum &rFrustum, GraphicsContext *pGraphicsContext);
         inline void GenerateAmbientOcculusionMap(const glm::mat4 &rProjection, float fov, const Texture *pDepth,
                                                  GraphicsContext *pGraphicsContext);
+        // if GPU culling is enabled, reduces the depth buffer into the Hi-Z pyramid the following draws are tested
+        // against for occlusion (the depth buffer shouldn't contain transparent geometry)
+        inline void GenerateHiZPyramid(const Texture *pDepth, GraphicsContext *pGraphicsContext);
         inline void RenderSkybox(const Texture *pRenderTarget, const Texture *pDepthScencilBuffer,
-                                 const Buffer *pSceneConstantsBuffer, const glm::mat4 &rView,
-                                 const glm::mat4 &rProjection, GraphicsContext *pGraphicsContext);
+                                 const UniformSlice &rSceneConstants, GraphicsContext *pGraphicsContext);
         inline void Tonemap(const Texture *pSourceRenderTarget, const Texture *pDestinationRenderTarget,
                             GraphicsContext *pGraphicsContext);
-        inline void BindMaterial(const std::shared_ptr<Material> &rpMaterial, GraphicsContext *pGraphicsContext);
+        inline void BindMaterial(const Material *pMaterial, GraphicsContext *pGraphicsContext);
+        // binds the material constants and textures (expects the material's shader to be bound already)
+        inline void BindMaterialResources(const Material *pMaterial, GraphicsContext *pGraphicsContext);
         inline void SetGraphicsContextState(const GraphicsContextState &rGraphicsContextState,
                                             GraphicsContext *pGraphicsContext) const;
-        inline const Buffer *UpdateInstanceConstants(const glm::mat4 &rModel, const glm::mat4 &rView,
-                                                     const glm::mat4 &rProjection, GraphicsContext *pGraphicsContext);
-        inline std::pair<uint32_t, const Buffer *> UpdateInstanceConstants(
-            const std::vector<const Renderable *> &rRenderables, const glm::mat4 &rView, const glm::mat4 &rProjection,
-            GraphicsContext *pGraphicsContext);
-        inline virtual const Buffer *EmptyLightingConstants(GraphicsContext *pGraphicsContext);
-        inline virtual const Buffer *UpdateLightingConstants(const PointLight *pPointLight,
-                                                             GraphicsContext *pGraphicsContext);
-        inline virtual const Buffer *UpdateLightingConstants(const DirectionalLight *pDirectionalLight,
-                                                             const glm::vec3 &rViewDirection,
-                                                             GraphicsContext *pGraphicsContext);
-        inline const Buffer *EmptyPCSSConstants(GraphicsContext *pGraphicsContext);
-        inline const Buffer *UpdatePCSSConstants(const PointLight *pPointLight, float nearClip,
-                                                 GraphicsContext *pGraphicsContext);
-        inline const Buffer *UpdatePCSSConstants(const DirectionalLight *pDirectionalLight, float nearClip,
-                                                 GraphicsContext *pGraphicsContext);
+        // the returned renderables are only valid until the next call
+        inline const std::vector<const Renderable *> &CullRenderables(
+            const std::vector<const Renderable *> &rRenderables, const Frustum &rFrustum);
+        // culls the renderables of the material render batches in [first, last) and sorts them into a draw list
+        // (valid until the next call)
+        inline const DrawList &BuildDrawList(
+            const RenderBatchStrategy::RenderBatches::const_iterator &rFirstRenderBatchIt,
+            const RenderBatchStrategy::RenderBatches::const_iterator &rLastRenderBatchIt, const Frustum &rFrustum,
+            const glm::mat4 &rView, float nearClip, float farClip);
+        // per-draw constants are sub-allocated from mUniformAllocator, so the returned slices are only valid until
+        // the end of the frame
+        inline UniformSlice UpdateInstanceConstants(const glm::mat4 &rModel, GraphicsContext *pGraphicsContext);
+        inline std::pair<uint32_t, UniformSlice> UpdateInstanceConstants(
+            const std::vector<const Renderable *> &rRenderables, GraphicsContext *pGraphicsContext);
+        // renderableCount must not exceed MAX_NUM_INSTANCES (split larger groups into several draws)
+        inline std::pair<uint32_t, UniformSlice> UpdateInstanceConstants(const Renderable *const *ppRenderables,
+                                                                         size_t renderableCount,
+                                                                         GraphicsContext *pGraphicsContext);
+        // if instance residency is enabled, the instance constants of the draw live in a persistent buffer and only
+        // the slots whose renderable changed or whose transform has updated are uploaded
+        inline std::pair<uint32_t, UniformSlice> UpdateInstanceConstants(const DrawList &rDrawList,
+                                                                         const DrawCommand &rDrawCommand,
+                                                                         GraphicsContext *pGraphicsContext);
+        // if indirect draws are enabled, packs the draw arguments of all commands in the draw list into a single
+        // indirect draw buffer, uploaded at once (otherwise returns nullptr).
+        // if GPU culling is enabled, a compute pass also culls the instances of each draw against the frustum and the
+        // Hi-Z pyramid, compacting the visible ones and writing their count in the draw arguments
+        inline const Buffer *UpdateIndirectDrawCommands(const DrawList &rDrawList, const Frustum &rFrustum,
+                                                        GraphicsContext *pGraphicsContext);
+        // draws the instances of the draw command from the indirect draw buffer or, if it's null, directly
+        inline void DrawInstances(const DrawList &rDrawList, const DrawCommand &rDrawCommand, uint32_t instanceCount,
+                                  const Buffer *pIndirectDrawBuffer, GraphicsContext *pGraphicsContext);
+        inline virtual UniformSlice EmptyLightingConstants(GraphicsContext *pGraphicsContext);
+        inline virtual UniformSlice UpdateLightingConstants(const PointLight *pPointLight,
+                                                            GraphicsContext *pGraphicsContext);
+        inline virtual UniformSlice UpdateLightingConstants(const DirectionalLight *pDirectionalLight,
+                                                            const glm::vec3 &rViewDirection,
+                                                            GraphicsContext *pGraphicsContext);
+        inline UniformSlice EmptyPCSSConstants(GraphicsContext *pGraphicsContext);
+        inline UniformSlice UpdatePCSSConstants(const PointLight *pPointLight, float nearClip,
+                                                GraphicsContext *pGraphicsContext);
+        inline UniformSlice UpdatePCSSConstants(const DirectionalLight *pDirectionalLight, float nearClip,
+                                                GraphicsContext *pGraphicsContext);
         inline void UpdateSSAOConstants(bool isSSAOEnabled, GraphicsContext *pGraphicsContext) const;
-        inline const Buffer *UpdateFogConstants(const Fog *pFog, GraphicsContext *pGraphicsContext);
-        inline virtual const Buffer *UpdateSceneConstants(const glm::mat4 &rView, const glm::mat4 &rInverseView,
-                                                          const glm::mat4 &rProjection,
-                                                          GraphicsContext *pGraphicsContext);
+        inline UniformSlice UpdateFogConstants(const Fog *pFog, GraphicsContext *pGraphicsContext);
+        inline virtual UniformSlice UpdateSceneConstants(const glm::mat4 &rView, const glm::mat4 &rInverseView,
+                                                         const glm::mat4 &rProjection,
+                                                         GraphicsContext *pGraphicsContext);
 
     private:
         using ShadowMapKey = uint64_t;
 
+        // resident instance constants are dropped after this many frames without being used
+        static constexpr uint64_t MAX_RESIDENT_INSTANCE_CONSTANTS_IDLE_FRAMES = 60;
+
+        struct ResidentInstanceConstantsKey
+        {
+            const Material *pMaterial;
+            const Mesh *pMesh;
+            size_t chunk;
+
+            inline bool operator==(const ResidentInstanceConstantsKey &rOther) const
+            {
+                return pMaterial == rOther.pMaterial && pMesh == rOther.pMesh && chunk == rOther.chunk;
+            }
+        };
+
+        struct ResidentInstanceConstants
+        {
+            const Buffer *pBuffer{nullptr};
+            // renderable whose instance data is in each slot and the model generation of its transform when it
+            // was uploaded
+            std::vector<std::pair<const Renderable *, uint64_t>> renderables;
+            uint64_t lastUsedFrame{0};
+        };
+
         class ShadowMap
         {
         public:
@@ -201,9 +301,9 @@ namespace FastCG
             {
                 if (mpLight->GetType().IsDerived(DirectionalLight::TYPE))
                 {
-                    constexpr float size = 20;
-                    constexpr float halfSize = size * 0.5f;
-                    return glm::ortho(-halfSize, halfSize, -halfSize, halfSize, -size, size);
+                    return glm::ortho(-DIRECTIONAL_LIGHT_VOLUME_HALF_SIZE, DIRECTIONAL_LIGHT_VOLUME_HALF_SIZE,
+                                      -DIRECTIONAL_LIGHT_VOLUME_HALF_SIZE, DIRECTIONAL_LIGHT_VOLUME_HALF_SIZE,
+                                      -DIRECTIONAL_LIGHT_VOLUME_SIZE, DIRECTIONAL_LIGHT_VOLUME_SIZE);
                 }
                 else
                 {
@@ -211,29 +311,51 @@ namespace FastCG
                 }
             }
 
+            // crops the light volume to the (world-space) bounds of the shadow receivers,
+            // returns false if they don't overlap
+            inline bool GetCroppedProjection(const AABB &rReceiversBounds, glm::mat4 &rCroppedProjection) const
+            {
+                if (!mpLight->GetType().IsDerived(DirectionalLight::TYPE))
+                {
+                    rCroppedProjection = GetProjection();
+                    return true;
+                }
+
+                auto lightSpaceBounds = rReceiversBounds.Transform(GetView());
+                auto left = glm::max(-DIRECTIONAL_LIGHT_VOLUME_HALF_SIZE, lightSpaceBounds.min.x);
+                auto right = glm::min(DIRECTIONAL_LIGHT_VOLUME_HALF_SIZE, lightSpaceBounds.max.x);
+                auto bottom = glm::max(-DIRECTIONAL_LIGHT_VOLUME_HALF_SIZE, lightSpaceBounds.min.y);
+                auto top = glm::min(DIRECTIONAL_LIGHT_VOLUME_HALF_SIZE, lightSpaceBounds.max.y);
+                // casters between the light and the receivers still cast shadows,
+                // so only the far plane is pulled in
+                auto zNear = -DIRECTIONAL_LIGHT_VOLUME_SIZE;
+                auto zFar = glm::min(DIRECTIONAL_LIGHT_VOLUME_SIZE, -lightSpaceBounds.min.z);
+                if (left >= right || bottom >= top || zNear >= zFar)
+                {
+                    return false;
+                }
+                rCroppedProjection = glm::ortho(left, right, bottom, top, zNear, zFar);
+                return true;
+            }
+
         private:
+            static constexpr float DIRECTIONAL_LIGHT_VOLUME_SIZE = 20;
+            static constexpr float DIRECTIONAL_LIGHT_VOLUME_HALF_SIZE = DIRECTIONAL_LIGHT_VOLUME_SIZE * 0.5f;
+
             const Light *mpLight;
             const Texture *mpTexture;
         };
 
-        std::vector<const Buffer *> mInstanceConstantsBuffers;
-        size_t mLastInstanceConstantsBufferIdx{0};
-        std::vector<const Buffer *> mLightingConstantsBuffers;
-        size_t mLastLightingConstantsBufferIdx{0};
-        std::vector<const Buffer *> mPCSSConstantsBuffers;
-        size_t mLastPCSSConstantsBufferIdx{0};
-        std::vector<const Buffer *> mFogConstantsBuffers;
-        size_t mLastFogConstantsBufferIdx{0};
-        std::vector<const Buffer *> mSceneConstantsBuffers;
-        size_t mLastSceneConstantsBufferIdx{0};
+        // per-draw uniform buffer pages are this large
+        static constexpr size_t UNIFORM_ALLOCATOR_PAGE_SIZE = 4 * 1024 * 1024;
+
+        UniformAllocator mUniformAllocator{"Per-Draw Constants", UNIFORM_ALLOCATOR_PAGE_SIZE};
         InstanceConstants mInstanceConstants{};
         LightingConstants mLightingConstants{};
         PCSSConstants mPCSSConstants{};
         FogConstants mFogConstants{};
         SceneConstants mSceneConstants{};
         const Shader *mpShadowMapPassShader{nullptr};
-        std::vector<const Buffer *> mShadowMapPassConstantsBuffers;
-        size_t mLastShadowMapPassConstantsBufferIdx{0};
         ShadowMapPassConstants mShadowMapPassConstants{};
         const Texture *mpEmptyShadowMap{nullptr};
         std::unordered_map<ShadowMapKey, ShadowMap> mShadowMaps;
@@ -246,22 +368,53 @@ namespace FastCG
         const Texture *mpEmptySSAOTexture{nullptr};
         bool mSSAOBlurEnabled{true};
         Tonemapper mTonemapper{Tonemapper::CHEAP_REINHARD};
+        bool mFrustumCullingEnabled{true};
+        std::vector<const Renderable *> mVisibleRenderables;
+        DrawList mDrawList;
+        bool mInstanceResidencyEnabled{true};
+        std::unordered_map<ResidentInstanceConstantsKey, ResidentInstanceConstants,
+                           FNV1aHasher<ResidentInstanceConstantsKey>>
+            mResidentInstanceConstants;
+        uint64_t mFrame{0};
+        uint64_t mLastRenderableRemovalCount{0};
+        bool mIndirectDrawEnabled{false};
+        std::vector<DrawIndexedIndirectCommand> mIndirectDrawCommands;
+        std::vector<const Buffer *> mIndirectDrawBuffers;
+        size_t mLastIndirectDrawBufferIdx{0};
+        bool mGPUCullingEnabled{false};
+        const Shader *mpHiZPyramidShader{nullptr};
+        const Shader *mpInstanceCullingShader{nullptr};
+        const Buffer *mpHiZPyramidBuffer{nullptr};
+        bool mHiZPyramidValid{false};
+        glm::mat4 mHiZViewProjection{};
+        glm::vec2 mHiZDepthSize{};
+        InstanceCullingConstants mInstanceCullingConstants{};
+        std::vector<const Buffer *> mCulledInstanceConstantsBuffers;
+        size_t mLastCulledInstanceConstantsBufferIdx{0};
+        // instance count and instance constants written by the GPU culling for each command of the draw list
+        std::vector<std::pair<uint32_t, UniformSlice>> mCulledInstanceConstants;
+        bool mDrawListCulledOnGPU{false};
         std::array<const Shader *, (TonemapperInt)Tonemapper::LAST - 1> mTonemapperShaders{};
 
-        inline const Buffer *GetShadowMapPassConstantsBuffer();
-        inline const Buffer *GetInstanceConstantsBuffer();
-        inline const Buffer *GetLightingConstantsBuffer();
-        inline const Buffer *GetPCSSConstantsBuffer();
-        inline const Buffer *GetFogConstantsBuffer();
-        inline const Buffer *GetSceneConstantsBuffer();
+        inline const Buffer *GetIndirectDrawBuffer(size_t size);
+        inline const Buffer *GetCulledInstanceConstantsBuffer();
         inline void CreateSSAORenderTargets();
         inline void DestroySSAORenderTargets();
+        inline void CreateHiZPyramid();
+        inline void DestroyHiZPyramid();
+        inline void CullInstances(const DrawList &rDrawList, const Frustum &rFrustum,
+                                  const Buffer *pIndirectDrawBuffer, GraphicsContext *pGraphicsContext);
         inline ShadowMapKey GetShadowMapKey(const Light *pLight) const;
         inline const ShadowMap &GetOrCreateShadowMap(const Light *pLight);
         inline bool GetShadowMap(const Light *pLight, ShadowMap &rShadowMap) const;
-        inline std::pair<uint32_t, const Buffer *> UpdateShadowMapPassConstants(
-            const std::vector<const Renderable *> &rRenderables, const glm::mat4 &rView, const glm::mat4 &rProjection,
-            GraphicsContext *pGraphicsContext);
+        inline uint32_t FilterRenderables(const std::vector<const Renderable *> &rRenderables, const Frustum *pFrustum);
+        inline bool GetShadowReceiversBounds(const Frustum &rFrustum, AABB &rReceiversBounds) const;
+        inline const std::vector<const Renderable *> &CullShadowCasters(
+            const std::vector<const Renderable *> &rRenderables, const Frustum *pFrustum);
+        inline std::pair<uint32_t, UniformSlice> UpdateShadowMapPassConstants(const Renderable *const *ppRenderables,
+                                                                              size_t renderableCount,
+                                                                              const glm::mat4 &rViewProjection,
+                                                                              GraphicsContext *pGraphicsContext);
         inline void UpdateSSAOHighFrequencyPassConstants(const glm::mat4 &rProjection, float fov, const Texture *pDepth,
                                                          GraphicsContext *pGraphicsContext);
 #if _DEBUG
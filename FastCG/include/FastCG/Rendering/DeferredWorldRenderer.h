@@ -28,11 +28,11 @@ namespace FastCG
         void CreateGBuffers();
         void DestroyGBuffers();
         void BindGBuffer(GraphicsContext *pGraphicsContext) const;
-        const Buffer *UpdateLightingConstants(const PointLight *pPointLight,
-                                              GraphicsContext *pGraphicsContext) override;
-        const Buffer *UpdateLightingConstants(const DirectionalLight *pDirectionalLight,
-                                              const glm::vec3 &rViewDirection,
-                                              GraphicsContext *pGraphicsContext) override;
+        UniformSlice UpdateLightingConstants(const PointLight *pPointLight,
+                                             GraphicsContext *pGraphicsContext) override;
+        UniformSlice UpdateLightingConstants(const DirectionalLight *pDirectionalLight,
+                                             const glm::vec3 &rViewDirection,
+                                             GraphicsContext *pGraphicsContext) override;
 
     private:
         std::vector<std::array<const Texture *, 6>> mGBuffers;
@@ -0,0 +1,85 @@
+#ifndef FASTCG_DRAW_LIST_H
+#define FASTCG_DRAW_LIST_H
+
+#include <FastCG/Rendering/Material.h>
+#include <FastCG/Rendering/Mesh.h>
+#include <FastCG/Rendering/RenderingUtils.h>
+#include <FastCG/Rendering/ShaderConstants.h>
+
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace FastCG
+{
+    class Renderable;
+
+    using DrawSortKey = uint64_t;
+
+    struct DrawCommand
+    {
+        DrawSortKey sortKey;
+        const Material *pMaterial;
+        const Mesh *pMesh;
+        // range in DrawList::GetRenderables()
+        uint32_t firstRenderable;
+        uint32_t renderableCount;
+        // index of the draw among the ones its material/mesh group was split into
+        uint32_t chunk;
+    };
+
+    // Per-frame list of instanced draws, sorted by a 64-bit key so that draws sharing a shader, a material and a
+    // mesh end up next to each other.
+    //
+    // Opaque key:      | order (8) | shader (12) | material (16) | depth (16) | mesh (12) |
+    // Transparent key: | order (8) | inverted depth (16) | shader (12) | material (16) | mesh (12) |
+    //
+    // Opaque draws of a material go front to back (early-Z), transparent draws go back to front (blending).
+    // Groups with more than MAX_NUM_INSTANCES renderables are split into several draws with the same key.
+    // Shader, material and mesh IDs are assigned as they're first seen and wrap around, so collisions only
+    // cost state changes, never correctness.
+    class DrawList final
+    {
+    public:
+        inline const std::vector<DrawCommand> &GetDrawCommands() const
+        {
+            return mDrawCommands;
+        }
+        inline const std::vector<const Renderable *> &GetRenderables() const
+        {
+            return mRenderables;
+        }
+        inline const Renderable *const *GetRenderables(const DrawCommand &rDrawCommand) const
+        {
+            return mRenderables.data() + rDrawCommand.firstRenderable;
+        }
+        inline bool IsEmpty() const
+        {
+            return mDrawCommands.empty();
+        }
+
+        void Clear();
+        // normalizedDepth is the view depth of the draw in [0, 1] (nearest instance for opaque draws, farthest
+        // instance for transparent ones)
+        void Add(RenderGroup group, const Material *pMaterial, const Mesh *pMesh,
+                 const std::vector<const Renderable *> &rRenderables, float normalizedDepth);
+        void Sort();
+
+    private:
+        std::vector<DrawCommand> mDrawCommands;
+        std::vector<const Renderable *> mRenderables;
+        std::unordered_map<const void *, uint32_t> mIds;
+        uint32_t mLastShaderId{0};
+        uint32_t mLastMaterialId{0};
+        uint32_t mLastMeshId{0};
+        std::vector<std::pair<DrawSortKey, uint32_t>> mSortEntries;
+        std::vector<std::pair<DrawSortKey, uint32_t>> mSortScratch;
+        std::vector<DrawCommand> mSortedDrawCommands;
+
+        uint32_t GetId(const void *pObject, uint32_t &rLastId);
+    };
+
+}
+
+#endif
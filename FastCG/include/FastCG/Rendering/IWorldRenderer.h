@@ -23,6 +23,14 @@ namespace FastCG
         virtual void SetSSAORadius(float radius) = 0;
         virtual bool IsSSAOBlurEnabled() const = 0;
         virtual void SetSSAOBlurEnabled(bool ssaoBlurEnabled) = 0;
+        virtual bool IsFrustumCullingEnabled() const = 0;
+        virtual void SetFrustumCullingEnabled(bool frustumCullingEnabled) = 0;
+        virtual bool IsInstanceResidencyEnabled() const = 0;
+        virtual void SetInstanceResidencyEnabled(bool instanceResidencyEnabled) = 0;
+        virtual bool IsIndirectDrawEnabled() const = 0;
+        virtual void SetIndirectDrawEnabled(bool indirectDrawEnabled) = 0;
+        virtual bool IsGPUCullingEnabled() const = 0;
+        virtual void SetGPUCullingEnabled(bool gpuCullingEnabled) = 0;
         virtual void Initialize() = 0;
         virtual void Resize() = 0;
         virtual void Finalize() = 0;
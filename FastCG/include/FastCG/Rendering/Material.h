@@ -14,6 +14,8 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace FastCG
 {
@@ -113,38 +115,44 @@ namespace FastCG
 
         inline size_t GetTextureCount() const
         {
-            return mTextures.size();
+            return mTextureBindings.size();
         }
 
         inline void GetTextureAt(size_t i, std::string &rName, const Texture *&rpTexture) const
         {
-            assert(i < mTextures.size());
-            auto it = std::next(mTextures.cbegin(), i);
+            assert(i < mTextureIndices.size());
+            auto it = std::next(mTextureIndices.cbegin(), i);
             rName = it->first;
-            rpTexture = it->second;
+            rpTexture = mTextureBindings[it->second].second;
         }
 
         inline bool GetTexture(const std::string &rName, const Texture *&rpTexture) const
         {
-            auto it = mTextures.find(rName);
-            if (it == mTextures.end())
+            auto it = mTextureIndices.find(rName);
+            if (it == mTextureIndices.end())
             {
                 assert(false);
                 return false;
             }
-            rpTexture = it->second;
+            rpTexture = mTextureBindings[it->second].second;
             return true;
         }
 
+        // textures paired with their pre-resolved shader resource IDs, in binding order
+        inline const auto &GetTextureBindings() const
+        {
+            return mTextureBindings;
+        }
+
         inline bool SetTexture(const std::string &rName, const Texture *pTexture)
         {
-            auto it = mTextures.find(rName);
-            if (it == mTextures.end())
+            auto it = mTextureIndices.find(rName);
+            if (it == mTextureIndices.end())
             {
                 assert(false);
                 return false;
             }
-            it->second = pTexture;
+            mTextureBindings[it->second].second = pTexture;
             return true;
         }
 
@@ -159,7 +167,9 @@ namespace FastCG
         const std::shared_ptr<MaterialDefinition> mpMaterialDefinition;
         ConstantBuffer mConstants;
         const Buffer *mpConstantBuffer;
-        std::unordered_map<std::string, const Texture *> mTextures;
+        // index of each texture in mTextureBindings
+        std::unordered_map<std::string, size_t> mTextureIndices;
+        std::vector<std::pair<ShaderResourceId, const Texture *>> mTextureBindings;
     };
 
 }
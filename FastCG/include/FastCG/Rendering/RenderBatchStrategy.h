@@ -7,6 +7,9 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <iterator>
+#include <list>
+#include <map>
 #include <memory>
 #include <unordered_map>
 #include <vector>
@@ -25,7 +28,8 @@ namespace FastCG
     class RenderBatchStrategy final
     {
     public:
-        using RenderBatches = std::vector<RenderBatch>;
+        // a list, so that iterators to batches remain valid (ie, can be used as handles) while others come and go
+        using RenderBatches = std::list<RenderBatch>;
 
         inline const RenderBatch &GetShadowCastersRenderBatch() const
         {
@@ -37,55 +41,73 @@ namespace FastCG
         }
         inline RenderBatches::const_iterator GetFirstOpaqueMaterialRenderBatchIterator() const
         {
-            return mRenderBatches.begin() + (RenderGroupInt)RenderGroup::OPAQUE_MATERIAL;
+            return std::next(mRenderBatches.cbegin(), (RenderGroupInt)RenderGroup::OPAQUE_MATERIAL);
         }
         inline RenderBatches::const_iterator GetFirstTransparentMaterialRenderBatchIterator() const
         {
-            return std::find_if(mRenderBatches.cbegin(), mRenderBatches.cend(), [](const auto &rRenderBatch) {
-                return rRenderBatch.group == RenderGroup::TRANSPARENT_MATERIAL;
-            });
+            auto it = mFirstRenderBatchPerOrder.lower_bound((RenderGroupInt)RenderGroup::TRANSPARENT_MATERIAL);
+            return it == mFirstRenderBatchPerOrder.end() ? mRenderBatches.cend() : it->second;
         }
         inline RenderBatches::const_iterator GetLastRenderBatchIterator() const
         {
             return mRenderBatches.cend();
         }
 
+        // a new renderable may reuse the address of a removed one, so data cached per renderable pointer must be
+        // invalidated whenever this changes
+        inline uint64_t GetRenderableRemovalCount() const
+        {
+            return mRenderableRemovalCount;
+        }
+
         void AddRenderable(const Renderable *pRenderable);
         void RemoveRenderable(const Renderable *pRenderable);
 
     private:
+        // position of a renderable in its batch's per-mesh vector (for O(1) removals)
+        using RenderableIndices = std::unordered_map<const Renderable *, size_t>;
+
         RenderBatches mRenderBatches{{RenderGroup::SHADOW_CASTERS}, {RenderGroup::SKYBOX}, {RenderGroup::RESERVED}};
+        // first batch of each order value present in mRenderBatches (batches are kept sorted by order)
+        std::map<RenderGroupInt, RenderBatches::iterator> mFirstRenderBatchPerOrder{};
+        std::unordered_map<const Material *, RenderBatches::iterator> mMaterialRenderBatches{};
+        RenderableIndices mShadowCasterIndices{};
+        RenderableIndices mMaterialRenderableIndices{};
+        uint64_t mRenderableRemovalCount{0};
 
         inline RenderBatches::iterator GetShadowCastersRenderBatchIterator()
         {
-            return mRenderBatches.begin() + (RenderGroupInt)RenderGroup::SHADOW_CASTERS;
+            return std::next(mRenderBatches.begin(), (RenderGroupInt)RenderGroup::SHADOW_CASTERS);
         }
         inline RenderBatches::const_iterator GetShadowCastersRenderBatchIterator() const
         {
-            return mRenderBatches.cbegin() + (RenderGroupInt)RenderGroup::SHADOW_CASTERS;
+            return std::next(mRenderBatches.cbegin(), (RenderGroupInt)RenderGroup::SHADOW_CASTERS);
         }
         inline RenderBatches::iterator GetSkyboxRenderBatchIterator()
         {
-            return mRenderBatches.begin() + (RenderGroupInt)RenderGroup::SKYBOX;
+            return std::next(mRenderBatches.begin(), (RenderGroupInt)RenderGroup::SKYBOX);
         }
         inline RenderBatches::const_iterator GetSkyboxRenderBatchIterator() const
         {
-            return mRenderBatches.cbegin() + (RenderGroupInt)RenderGroup::SKYBOX;
+            return std::next(mRenderBatches.cbegin(), (RenderGroupInt)RenderGroup::SKYBOX);
         }
         inline RenderBatches::iterator GetMaterialRenderBatchIterator(const std::shared_ptr<Material> &rpMaterial)
         {
-            return std::find_if(mRenderBatches.begin(), mRenderBatches.end(), [&rpMaterial](const auto &rRenderBatch) {
-                return rRenderBatch.pMaterial == rpMaterial;
-            });
+            auto it = mMaterialRenderBatches.find(rpMaterial.get());
+            return it == mMaterialRenderBatches.end() ? mRenderBatches.end() : it->second;
         }
+        RenderBatches::iterator InsertMaterialRenderBatch(RenderBatch &&rRenderBatch);
+        void EraseMaterialRenderBatch(const RenderBatches::iterator &rRenderBatchIt);
         void AddToShadowCastersRenderBatch(const Renderable *pRenderable);
         void RemoveFromShadowCastersRenderBatch(const Renderable *pRenderable);
         void AddToSkyboxRenderBatch(const Renderable *pRenderable);
         void RemoveFromSkyboxRenderBatch(const Renderable *pRenderable);
         void AddToMaterialRenderBatch(const Renderable *pRenderable);
         void RemoveFromMaterialRenderBatch(const Renderable *pRenderable);
-        void AddToRenderBatch(const RenderBatches::iterator &rRenderBatchIt, const Renderable *pRenderable);
-        bool RemoveFromRenderBatch(const RenderBatches::iterator &rRenderBatchIt, const Renderable *pRenderable);
+        void AddToRenderBatch(const RenderBatches::iterator &rRenderBatchIt, RenderableIndices &rRenderableIndices,
+                              const Renderable *pRenderable);
+        bool RemoveFromRenderBatch(const RenderBatches::iterator &rRenderBatchIt,
+                                   RenderableIndices &rRenderableIndices, const Renderable *pRenderable);
     };
 
 }
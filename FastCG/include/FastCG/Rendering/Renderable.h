@@ -4,6 +4,7 @@
 #include <FastCG/Graphics/GraphicsSystem.h>
 #include <FastCG/Rendering/RenderingSystem.h>
 #include <FastCG/World/Component.h>
+#include <FastCG/World/WorldSystem.h>
 
 #include <memory>
 
@@ -36,6 +37,7 @@ namespace FastCG
             RenderingSystem::GetInstance()->UnregisterRenderable(this);
             mpMesh = pMesh;
             RenderingSystem::GetInstance()->RegisterRenderable(this);
+            WorldSystem::GetInstance()->UpdateSpatialIndex(GetGameObject());
         }
 
         inline bool IsShadowCaster() const
@@ -60,6 +62,7 @@ namespace FastCG
             RenderingSystem::GetInstance()->UnregisterRenderable(this);
             mSkybox = skybox;
             RenderingSystem::GetInstance()->RegisterRenderable(this);
+            WorldSystem::GetInstance()->UpdateSpatialIndex(GetGameObject());
         }
 
     protected:
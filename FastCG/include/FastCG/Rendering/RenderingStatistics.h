@@ -9,11 +9,19 @@ namespace FastCG
     {
         uint32_t drawCalls{0};
         uint32_t triangles{0};
+        uint32_t visibleRenderables{0};
+        uint32_t culledRenderables{0};
+        uint32_t culledShadowCasters{0};
+        uint32_t uploadedInstances{0};
 
         void Reset()
         {
             drawCalls = 0;
             triangles = 0;
+            visibleRenderables = 0;
+            culledRenderables = 0;
+            culledShadowCasters = 0;
+            uploadedInstances = 0;
         }
     };
 
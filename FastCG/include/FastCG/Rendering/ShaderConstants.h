@@ -2,6 +2,7 @@
 #define FASTCG_SHADER_STRUCTURES_H
 
 #include <FastCG/Core/Colors.h>
+#include <FastCG/Graphics/BaseShader.h>
 
 #include <glm/glm.hpp>
 
@@ -14,15 +15,29 @@ namespace FastCG
     static constexpr uint32_t UV_VERTEX_INPUT_LOCATION = 2;
     static constexpr uint32_t TANGENT_VERTEX_INPUT_LOCATION = 3;
     static constexpr uint32_t COLOR_SHADER_INPUT_INDEX = 4;
-    static constexpr const char *const SCENE_CONSTANTS_SHADER_RESOURCE_NAME = "SceneConstants";
-    static constexpr const char *const INSTANCE_CONSTANTS_SHADER_RESOURCE_NAME = "InstanceConstants";
-    static constexpr const char *const FOG_CONSTANTS_SHADER_RESOURCE_NAME = "FogConstants";
-    static constexpr const char *const PCSS_CONSTANTS_SHADER_RESOURCE_NAME = "PCSSConstants";
-    static constexpr const char *const LIGHTING_CONSTANTS_SHADER_RESOURCE_NAME = "LightingConstants";
-    static constexpr const char *const MATERIAL_CONSTANTS_SHADER_RESOURCE_NAME = "MaterialConstants";
-    static constexpr const char *const SHADOW_MAP_PASS_CONSTANTS_SHADER_RESOURCE_NAME = "ShadowMapPassConstants";
-    static constexpr const char *const SSAO_HIGH_FREQUENCY_PASS_CONSTANTS_SHADER_RESOURCE_NAME =
-        "SSAOHighFrequencyPassConstants";
+    static constexpr ShaderResourceId SCENE_CONSTANTS_SHADER_RESOURCE_ID = GetShaderResourceId("SceneConstants");
+    static constexpr ShaderResourceId INSTANCE_CONSTANTS_SHADER_RESOURCE_ID = GetShaderResourceId("InstanceConstants");
+    static constexpr ShaderResourceId FOG_CONSTANTS_SHADER_RESOURCE_ID = GetShaderResourceId("FogConstants");
+    static constexpr ShaderResourceId PCSS_CONSTANTS_SHADER_RESOURCE_ID = GetShaderResourceId("PCSSConstants");
+    static constexpr ShaderResourceId LIGHTING_CONSTANTS_SHADER_RESOURCE_ID = GetShaderResourceId("LightingConstants");
+    static constexpr ShaderResourceId MATERIAL_CONSTANTS_SHADER_RESOURCE_ID = GetShaderResourceId("MaterialConstants");
+    static constexpr ShaderResourceId SHADOW_MAP_PASS_CONSTANTS_SHADER_RESOURCE_ID =
+        GetShaderResourceId("ShadowMapPassConstants");
+    static constexpr ShaderResourceId SSAO_HIGH_FREQUENCY_PASS_CONSTANTS_SHADER_RESOURCE_ID =
+        GetShaderResourceId("SSAOHighFrequencyPassConstants");
+    static constexpr ShaderResourceId INSTANCE_CULLING_CONSTANTS_SHADER_RESOURCE_ID =
+        GetShaderResourceId("InstanceCullingConstants");
+    static constexpr ShaderResourceId HI_Z_PYRAMID_SHADER_RESOURCE_ID = GetShaderResourceId("HiZPyramid");
+    static constexpr ShaderResourceId CULLED_INSTANCE_CONSTANTS_SHADER_RESOURCE_ID =
+        GetShaderResourceId("CulledInstanceConstants");
+    static constexpr ShaderResourceId INDIRECT_DRAW_COMMANDS_SHADER_RESOURCE_ID =
+        GetShaderResourceId("IndirectDrawCommands");
+    static constexpr ShaderResourceId SHADOW_MAP_SHADER_RESOURCE_ID = GetShaderResourceId("uShadowMap");
+    static constexpr ShaderResourceId AMBIENT_OCCLUSION_MAP_SHADER_RESOURCE_ID =
+        GetShaderResourceId("uAmbientOcclusionMap");
+    static constexpr ShaderResourceId DEPTH_SHADER_RESOURCE_ID = GetShaderResourceId("uDepth");
+    static constexpr ShaderResourceId SOURCE_SHADER_RESOURCE_ID = GetShaderResourceId("uSource");
+    static constexpr ShaderResourceId NOISE_MAP_SHADER_RESOURCE_ID = GetShaderResourceId("uNoiseMap");
 
     struct ShadowMapData
     {
@@ -77,16 +92,16 @@ namespace FastCG
             glm::mat4 inverseView;
             glm::mat4 projection;
             glm::mat4 inverseProjection;
+            glm::mat4 viewProjection;
             glm::vec2 screenSize;
             float pointSize;
         };
 
+        // camera independent, so it can stay resident in GPU memory while transforms don't change
         struct InstanceData
         {
             glm::mat4 model;
             glm::mat4 modelInverseTranspose;
-            glm::mat4 viewProjection;
-            glm::mat4 modelViewProjection;
         };
 
         struct InstanceConstants
@@ -140,6 +155,24 @@ namespace FastCG
         float tanHalfFov{};
     };
 
+    // each Hi-Z cell covers HI_Z_CELL_SIZE << level pixels of the depth buffer
+    constexpr uint32_t HI_Z_CELL_SIZE = 8;
+    constexpr uint32_t HI_Z_LEVEL_COUNT = 4;
+    constexpr uint32_t INSTANCE_CULLING_GROUP_SIZE = 64;
+
+    struct InstanceCullingConstants
+    {
+        glm::vec4 frustumPlanes[6];
+        glm::mat4 hiZViewProjection;
+        glm::vec4 boundsMin; // w = 0 if the mesh has no bounds
+        glm::vec4 boundsMax;
+        glm::vec2 hiZDepthSize;
+        uint32_t hiZEnabled;
+        uint32_t instanceCount;
+        uint32_t drawCommandIdx;
+        uint32_t padding[3];
+    };
+
     struct ImGuiConstants
     {
         glm::mat4 projection;
@@ -0,0 +1,51 @@
+#ifndef FASTCG_UNIFORM_ALLOCATOR_H
+#define FASTCG_UNIFORM_ALLOCATOR_H
+
+#include <FastCG/Graphics/GraphicsSystem.h>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace FastCG
+{
+    // range of a uniform buffer holding a block of constants
+    struct UniformSlice
+    {
+        const Buffer *pBuffer{nullptr};
+        size_t offset{0};
+        size_t size{0};
+    };
+
+    // Linear allocator that sub-allocates blocks of constants from a few large dynamic uniform buffers (pages), so
+    // that each block doesn't need a buffer (and a descriptor) of its own.
+    // Slices are bound w/ GraphicsContext::BindResource(pBuffer, offset, size, pName) and are only valid until the
+    // next Reset().
+    class UniformAllocator final
+    {
+    public:
+        // the largest minimum uniform buffer offset alignment a Vulkan implementation can require
+        static constexpr size_t OFFSET_ALIGNMENT = 256;
+
+        UniformAllocator(const std::string &rName, size_t pageSize);
+
+        // allocates a slice of size bytes and uploads the first dataSize bytes of pData into it
+        UniformSlice Allocate(const void *pData, size_t size, size_t dataSize, GraphicsContext *pGraphicsContext);
+        inline UniformSlice Allocate(const void *pData, size_t size, GraphicsContext *pGraphicsContext)
+        {
+            return Allocate(pData, size, size, pGraphicsContext);
+        }
+        void Reset();
+        void Release();
+
+    private:
+        const std::string mName;
+        const size_t mPageSize;
+        std::vector<const Buffer *> mPages;
+        size_t mLastPageIdx{0};
+        size_t mOffset{0};
+    };
+
+}
+
+#endif
@@ -63,6 +63,8 @@ namespace FastCG
             return mComponents;
         }
         AABB GetBounds() const;
+        // world-space bounds of this game object's renderable (empty if there's none)
+        AABB GetWorldBounds() const;
         friend class Component;
 
     private:
@@ -9,6 +9,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstdint>
 #include <vector>
 
 namespace FastCG
@@ -156,9 +157,14 @@ namespace FastCG
             return glm::normalize(mWorldTransform.rotation * glm::vec3(0, 0, 1));
         }
 
-        inline glm::mat4 GetModel() const
+        inline const glm::mat4 &GetModel() const
         {
-            return mWorldTransform.ToMat4();
+            return mModel;
+        }
+
+        inline const glm::mat4 &GetModelInverseTranspose() const
+        {
+            return mModelInverseTranspose;
         }
 
         inline void SetModel(const glm::mat4 &rModel)
@@ -191,6 +197,13 @@ namespace FastCG
             return mHasUpdated;
         }
 
+        // bumped every time the model matrix changes, so copies of it can be validated across frames (unlike
+        // HasUpdated(), which is reset by the next hierarchy update)
+        inline uint64_t GetModelGeneration() const
+        {
+            return mModelGeneration;
+        }
+
         friend class GameObject;
         friend class WorldSystem;
 
@@ -241,14 +254,19 @@ namespace FastCG
         std::vector<Transform *> mChildren;
         SRT mLocalTransform;
         SRT mWorldTransform;
+        // cached on update, so renderers don't recompute them every pass
+        glm::mat4 mModel;
+        glm::mat4 mModelInverseTranspose;
         bool mNeedUpdate{false};
         bool mHasUpdated{false};
+        uint64_t mModelGeneration{0};
 
         Transform(GameObject *pGameObject, const glm::vec3 &rScale = glm::vec3{1, 1, 1},
                   const glm::quat &rRotation = glm::quat{1, 0, 0, 0}, const glm::vec3 &rPosition = glm::vec3{0, 0, 0})
             : mpGameObject(pGameObject), mLocalTransform(rScale, rRotation, rPosition),
               mWorldTransform(rScale, rRotation, rPosition)
         {
+            UpdateModel();
         }
 
         void Update(bool forceUpdate = false)
@@ -268,6 +286,7 @@ namespace FastCG
                 {
                     mWorldTransform = mLocalTransform;
                 }
+                UpdateModel();
                 mNeedUpdate = false;
                 mHasUpdated = true;
             }
@@ -278,6 +297,13 @@ namespace FastCG
             }
         }
 
+        inline void UpdateModel()
+        {
+            mModel = mWorldTransform.ToMat4();
+            mModelInverseTranspose = glm::transpose(glm::inverse(mModel));
+            mModelGeneration++;
+        }
+
         inline void AddChild(Transform *pChild)
         {
             assert(pChild);
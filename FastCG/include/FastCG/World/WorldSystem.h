@@ -1,6 +1,7 @@
 #ifndef FASTCG_WORLD_SYSTEM
 #define FASTCG_WORLD_SYSTEM
 
+#include <FastCG/Core/BVH.h>
 #include <FastCG/Core/System.h>
 #include <FastCG/Reflection/Inspectable.h>
 #include <FastCG/World/GameObject.h>
@@ -11,6 +12,7 @@
 #endif
 
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #define FASTCG_COMPONENT_TRACKING(className)                                                                           \
@@ -96,6 +98,13 @@ namespace FastCG
                 }
             }
         }
+        // spatial queries (only game objects with a renderable are indexed)
+        void FindGameObjects(const AABB &rBounds, std::vector<GameObject *> &rGameObjects) const;
+        void FindGameObjects(const Frustum &rFrustum, std::vector<GameObject *> &rGameObjects) const;
+        void FindGameObjects(const glm::vec3 &rCenter, float radius, std::vector<GameObject *> &rGameObjects) const;
+        // returns the game object whose world bounds are hit first by the ray (if any)
+        GameObject *Raycast(const glm::vec3 &rOrigin, const glm::vec3 &rDirection, float maxDistance,
+                            float &rDistance) const;
         template <typename ComponentT>
         inline void FindComponents(std::vector<ComponentT *> &rComponents) const
         {
@@ -125,6 +134,8 @@ namespace FastCG
         Camera *mpMainCamera{nullptr};
         std::vector<GameObject *> mGameObjects;
         std::vector<Component *> mComponents;
+        BVH<GameObject *> mSpatialIndex;
+        std::unordered_map<GameObject *, BVHProxyId> mSpatialIndexProxies;
 #if _DEBUG
         GameObject *mpSelectedGameObject{nullptr};
         bool mShowSceneHierarchy{false};
@@ -153,6 +164,8 @@ namespace FastCG
         void UnregisterGameObject(GameObject *pGameObject);
         void RegisterComponent(Component *pComponent);
         void UnregisterComponent(Component *pComponent);
+        void UpdateSpatialIndex(GameObject *pGameObject);
+        void RefitSpatialIndex();
         void Update(float time, float deltaTime);
         void Resize();
 #if _DEBUG
@@ -163,6 +176,7 @@ namespace FastCG
 
         friend class GameObject;
         friend class Component;
+        friend class Renderable;
     };
 
 }
@@ -0,0 +1,166 @@
+#include <FastCG/Core/ThreadPool.h>
+
+#include <cassert>
+
+namespace FastCG
+{
+    ThreadPool::ThreadPool(uint32_t threadCount)
+    {
+        for (uint32_t i = 0; i < threadCount; ++i)
+        {
+            mThreads.emplace_back(&ThreadPool::RunWorker, this, i);
+        }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mStop = true;
+        }
+        mWorkAvailable.notify_all();
+        for (auto &rThread : mThreads)
+        {
+            rThread.join();
+        }
+    }
+
+    void ThreadPool::ParallelFor(size_t count, const Callback &rCallback)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+
+        // not worth waking up the workers
+        if (count == 1 || mThreads.empty())
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                rCallback(i, GetThreadCount());
+            }
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            assert(mpCallback == nullptr);
+            mpCallback = &rCallback;
+            mCount = count;
+            mNextIndex = 0;
+            mDoneCount = 0;
+            mException = nullptr;
+            mGeneration++;
+        }
+        mWorkAvailable.notify_all();
+
+        RunCallbacks(GetThreadCount());
+
+        std::exception_ptr exception;
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mWorkDone.wait(lock, [this]() { return mDoneCount == mCount; });
+            mpCallback = nullptr;
+            exception = mException;
+        }
+
+        if (exception)
+        {
+            std::rethrow_exception(exception);
+        }
+    }
+
+    void ThreadPool::Enqueue(Task task)
+    {
+        if (mThreads.empty())
+        {
+            task();
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mTasks.emplace_back(std::move(task));
+        }
+        mWorkAvailable.notify_one();
+    }
+
+    void ThreadPool::RunWorker(uint32_t threadIdx)
+    {
+        uint64_t lastGeneration = 0;
+        while (true)
+        {
+            Task task;
+            {
+                std::unique_lock<std::mutex> lock(mMutex);
+                mWorkAvailable.wait(lock,
+                                    [&]() { return mStop || mGeneration != lastGeneration || !mTasks.empty(); });
+                if (mStop)
+                {
+                    return;
+                }
+                // index ranges go first, as the calling thread is waiting on them
+                if (mGeneration != lastGeneration)
+                {
+                    lastGeneration = mGeneration;
+                }
+                else
+                {
+                    task = std::move(mTasks.front());
+                    mTasks.pop_front();
+                }
+            }
+
+            if (task)
+            {
+                task();
+            }
+            else
+            {
+                RunCallbacks(threadIdx);
+            }
+        }
+    }
+
+    void ThreadPool::RunCallbacks(uint32_t threadIdx)
+    {
+        while (true)
+        {
+            size_t index;
+            const Callback *pCallback;
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                if (mpCallback == nullptr || mNextIndex == mCount)
+                {
+                    return;
+                }
+                index = mNextIndex++;
+                pCallback = mpCallback;
+            }
+
+            try
+            {
+                (*pCallback)(index, threadIdx);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                if (!mException)
+                {
+                    mException = std::current_exception();
+                }
+            }
+
+            bool done;
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                done = ++mDoneCount == mCount;
+            }
+            if (done)
+            {
+                mWorkDone.notify_one();
+            }
+        }
+    }
+
+}
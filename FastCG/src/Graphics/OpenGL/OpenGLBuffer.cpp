@@ -2,6 +2,7 @@
 
 #include <FastCG/Graphics/OpenGL/OpenGLBuffer.h>
 #include <FastCG/Graphics/OpenGL/OpenGLErrorHandling.h>
+#include <FastCG/Graphics/OpenGL/OpenGLGraphicsSystem.h>
 #include <FastCG/Graphics/OpenGL/OpenGLUtils.h>
 
 #include <cstring>
@@ -14,7 +15,7 @@ namespace FastCG
 
         FASTCG_CHECK_OPENGL_CALL(glGenBuffers(1, &mBufferId));
 
-        FASTCG_CHECK_OPENGL_CALL(glBindBuffer(target, mBufferId));
+        OpenGLGraphicsSystem::GetInstance()->GetStateCache().BindBuffer(target, mBufferId);
 
 #if _DEBUG
         {
@@ -41,6 +42,7 @@ namespace FastCG
         if (mBufferId != ~0u)
         {
             glDeleteBuffers(1, &mBufferId);
+            OpenGLGraphicsSystem::GetInstance()->GetStateCache().OnBufferDeleted(mBufferId);
         }
     }
 
@@ -15,12 +15,17 @@
 
 namespace
 {
+    FastCG::OpenGLStateCache &GetStateCache()
+    {
+        return FastCG::OpenGLGraphicsSystem::GetInstance()->GetStateCache();
+    }
+
     struct TemporaryDepthWriteStateChanger
     {
-        TemporaryDepthWriteStateChanger(GLboolean newDepthWrite, FastCG::OpenGLGraphicsContext &rContext)
+        TemporaryDepthWriteStateChanger(bool newDepthWrite, FastCG::OpenGLGraphicsContext &rContext)
             : mrContext(rContext)
         {
-            FASTCG_CHECK_OPENGL_CALL(glGetBooleanv(GL_DEPTH_WRITEMASK, &mOldDepthWrite));
+            mOldDepthWrite = GetStateCache().GetDepthMask();
             if (mOldDepthWrite != newDepthWrite)
             {
                 mrContext.SetDepthWrite(newDepthWrite);
@@ -36,7 +41,7 @@ namespace
         }
 
     private:
-        GLboolean mOldDepthWrite;
+        bool mOldDepthWrite;
         FastCG::OpenGLGraphicsContext &mrContext;
         bool mChangedDepthWrite{false};
     };
@@ -47,23 +52,23 @@ namespace
         static constexpr uint8_t STENCIL_TEST_MASK = 1 << 1;
         static constexpr uint8_t SCISSOR_TEST_MASK = 1 << 2;
 
-        TemporaryFragmentTestStateChanger(GLboolean newDepthTest, GLboolean newStencilTest, GLboolean newScissorTest,
+        TemporaryFragmentTestStateChanger(bool newDepthTest, bool newStencilTest, bool newScissorTest,
                                           FastCG::OpenGLGraphicsContext &rContext)
             : mrContext(rContext)
         {
-            FASTCG_CHECK_OPENGL_CALL(glGetBooleanv(GL_DEPTH_TEST, &mOldDepthTest));
+            mOldDepthTest = GetStateCache().IsEnabled(GL_DEPTH_TEST);
             if (newDepthTest != mOldDepthTest)
             {
                 mrContext.SetDepthTest(newDepthTest);
                 mChangeMask |= DEPTH_TEST_MASK;
             }
-            FASTCG_CHECK_OPENGL_CALL(glGetBooleanv(GL_STENCIL_TEST, &mOldStencilTest));
+            mOldStencilTest = GetStateCache().IsEnabled(GL_STENCIL_TEST);
             if (newStencilTest != mOldStencilTest)
             {
                 mrContext.SetStencilTest(newStencilTest);
                 mChangeMask |= STENCIL_TEST_MASK;
             }
-            FASTCG_CHECK_OPENGL_CALL(glGetBooleanv(GL_SCISSOR_TEST, &mOldScissorTest));
+            mOldScissorTest = GetStateCache().IsEnabled(GL_SCISSOR_TEST);
             if (newScissorTest != mOldScissorTest)
             {
                 mrContext.SetScissorTest(newScissorTest);
@@ -87,9 +92,9 @@ namespace
         }
 
     private:
-        GLboolean mOldDepthTest;
-        GLboolean mOldStencilTest;
-        GLboolean mOldScissorTest;
+        bool mOldDepthTest;
+        bool mOldStencilTest;
+        bool mOldScissorTest;
         FastCG::OpenGLGraphicsContext &mrContext;
         uint8_t mChangeMask{0};
     };
@@ -147,145 +152,118 @@ namespace FastCG
 
     void OpenGLGraphicsContext::SetViewport(int32_t x, int32_t y, uint32_t width, uint32_t height)
     {
-        FASTCG_CHECK_OPENGL_CALL(glViewport((GLint)x, (GLint)y, (GLsizei)width, (GLsizei)height));
+        GetStateCache().SetViewport((GLint)x, (GLint)y, (GLsizei)width, (GLsizei)height);
     }
 
     void OpenGLGraphicsContext::SetScissor(int32_t x, int32_t y, uint32_t width, uint32_t height)
     {
-        FASTCG_CHECK_OPENGL_CALL(glScissor((GLint)x, (GLint)y, (GLsizei)width, (GLsizei)height));
+        GetStateCache().SetScissor((GLint)x, (GLint)y, (GLsizei)width, (GLsizei)height);
     }
 
     void OpenGLGraphicsContext::SetBlend(bool blend)
     {
-        if (blend)
-        {
-            FASTCG_CHECK_OPENGL_CALL(glEnable(GL_BLEND));
-        }
-        else
-        {
-            FASTCG_CHECK_OPENGL_CALL(glDisable(GL_BLEND));
-        }
+        GetStateCache().SetEnabled(GL_BLEND, blend);
     }
 
     void OpenGLGraphicsContext::SetBlendFunc(BlendFunc color, BlendFunc alpha)
     {
         assert(color != BlendFunc::NONE);
-        if (alpha == BlendFunc::NONE)
-        {
-            FASTCG_CHECK_OPENGL_CALL(glBlendEquation(GetOpenGLBlendFunc(color)));
-        }
-        else
-        {
-            FASTCG_CHECK_OPENGL_CALL(glBlendEquationSeparate(GetOpenGLBlendFunc(color), GetOpenGLBlendFunc(alpha)));
-        }
+        GetStateCache().SetBlendEquation(GetOpenGLBlendFunc(color),
+                                         GetOpenGLBlendFunc(alpha == BlendFunc::NONE ? color : alpha));
     }
 
     void OpenGLGraphicsContext::SetBlendFactors(BlendFactor srcColor, BlendFactor dstColor, BlendFactor srcAlpha,
                                                 BlendFactor dstAlpha)
     {
-        FASTCG_CHECK_OPENGL_CALL(glBlendFuncSeparate(GetOpenGLBlendFactor(srcColor), GetOpenGLBlendFactor(dstColor),
-                                                     GetOpenGLBlendFactor(srcAlpha), GetOpenGLBlendFactor(dstAlpha)));
+        GetStateCache().SetBlendFunc(GetOpenGLBlendFactor(srcColor), GetOpenGLBlendFactor(dstColor),
+                                     GetOpenGLBlendFactor(srcAlpha), GetOpenGLBlendFactor(dstAlpha));
     }
 
     void OpenGLGraphicsContext::SetStencilTest(bool stencilTest)
     {
-        if (stencilTest)
-        {
-            FASTCG_CHECK_OPENGL_CALL(glEnable(GL_STENCIL_TEST));
-        }
-        else
-        {
-            FASTCG_CHECK_OPENGL_CALL(glDisable(GL_STENCIL_TEST));
-        }
+        GetStateCache().SetEnabled(GL_STENCIL_TEST, stencilTest);
     }
 
     void OpenGLGraphicsContext::SetStencilFunc(Face face, CompareOp stencilFunc, int32_t ref, uint32_t mask)
     {
         assert(face != Face::NONE);
-        auto compareOp = GetOpenGLCompareOp(stencilFunc);
-        if (face == Face::BACK || face == Face::FRONT)
-        {
-            FASTCG_CHECK_OPENGL_CALL(glStencilFuncSeparate(GetOpenGLFace(face), compareOp, (GLint)ref, (GLuint)mask));
-        }
-        else
-        {
-            FASTCG_CHECK_OPENGL_CALL(glStencilFunc(compareOp, (GLint)ref, (GLuint)mask));
-        }
+        GetStateCache().SetStencilFunc(GetOpenGLFace(face), GetOpenGLCompareOp(stencilFunc), (GLint)ref, (GLuint)mask);
     }
 
     void OpenGLGraphicsContext::SetStencilOp(Face face, StencilOp stencilFail, StencilOp depthFail, StencilOp depthPass)
     {
         assert(face != Face::NONE);
-        FASTCG_CHECK_OPENGL_CALL(glStencilOpSeparate(GetOpenGLFace(face), GetOpenGLStencilFunc(stencilFail),
-                                                     GetOpenGLStencilFunc(depthFail), GetOpenGLStencilFunc(depthPass)));
+        GetStateCache().SetStencilOp(GetOpenGLFace(face), GetOpenGLStencilFunc(stencilFail),
+                                     GetOpenGLStencilFunc(depthFail), GetOpenGLStencilFunc(depthPass));
     }
 
     void OpenGLGraphicsContext::SetStencilWriteMask(Face face, uint32_t mask)
     {
         assert(face != Face::NONE);
-        FASTCG_CHECK_OPENGL_CALL(glStencilMaskSeparate(GetOpenGLFace(face), mask));
+        GetStateCache().SetStencilWriteMask(GetOpenGLFace(face), (GLuint)mask);
     }
 
     void OpenGLGraphicsContext::SetDepthTest(bool depthTest)
     {
-        if (depthTest)
-        {
-            FASTCG_CHECK_OPENGL_CALL(glEnable(GL_DEPTH_TEST));
-        }
-        else
-        {
-            FASTCG_CHECK_OPENGL_CALL(glDisable(GL_DEPTH_TEST));
-        }
+        GetStateCache().SetEnabled(GL_DEPTH_TEST, depthTest);
     }
 
     void OpenGLGraphicsContext::SetDepthWrite(bool depthWrite)
     {
-        if (depthWrite)
-        {
-            FASTCG_CHECK_OPENGL_CALL(glDepthMask(GL_TRUE));
-        }
-        else
-        {
-            FASTCG_CHECK_OPENGL_CALL(glDepthMask(GL_FALSE));
-        }
+        GetStateCache().SetDepthMask(depthWrite);
     }
 
     void OpenGLGraphicsContext::SetDepthFunc(CompareOp depthFunc)
     {
-        FASTCG_CHECK_OPENGL_CALL(glDepthFunc(GetOpenGLCompareOp(depthFunc)));
+        GetStateCache().SetDepthFunc(GetOpenGLCompareOp(depthFunc));
     }
 
     void OpenGLGraphicsContext::SetScissorTest(bool scissorTest)
     {
-        if (scissorTest)
-        {
-            FASTCG_CHECK_OPENGL_CALL(glEnable(GL_SCISSOR_TEST));
-        }
-        else
-        {
-            FASTCG_CHECK_OPENGL_CALL(glDisable(GL_SCISSOR_TEST));
-        }
+        GetStateCache().SetEnabled(GL_SCISSOR_TEST, scissorTest);
     }
 
     void OpenGLGraphicsContext::SetCullMode(Face face)
     {
         if (face == Face::NONE)
         {
-            FASTCG_CHECK_OPENGL_CALL(glDisable(GL_CULL_FACE));
+            GetStateCache().SetEnabled(GL_CULL_FACE, false);
         }
         else
         {
-            FASTCG_CHECK_OPENGL_CALL(glEnable(GL_CULL_FACE));
-            FASTCG_CHECK_OPENGL_CALL(glCullFace(GetOpenGLFace(face)));
+            GetStateCache().SetEnabled(GL_CULL_FACE, true);
+            GetStateCache().SetCullFace(GetOpenGLFace(face));
         }
     }
 
     void OpenGLGraphicsContext::Copy(const OpenGLBuffer *pDst, const void *pSrc, size_t size)
+    {
+        Copy(pDst, pSrc, 0, size);
+    }
+
+    void OpenGLGraphicsContext::Copy(const OpenGLBuffer *pDst, const void *pSrc, size_t offset, size_t size)
     {
         assert(pDst != nullptr);
+        assert(offset + size <= pDst->GetDataSize());
+        size_t ringOffset;
+        if (OpenGLGraphicsSystem::GetInstance()->CopyToUploadRing(pSrc, size, ringOffset))
+        {
+            // the GPU-side copy is ordered w/ the commands that still use the destination, so nothing waits on them
+            GetStateCache().BindBuffer(GL_COPY_READ_BUFFER, OpenGLGraphicsSystem::GetInstance()->GetUploadRingId());
+            GetStateCache().BindBuffer(GL_COPY_WRITE_BUFFER, *pDst);
+            FASTCG_CHECK_OPENGL_CALL(glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+                                                         (GLintptr)ringOffset, (GLintptr)offset, (GLsizeiptr)size));
+            return;
+        }
         auto target = GetOpenGLTarget(pDst->GetUsage());
-        FASTCG_CHECK_OPENGL_CALL(glBindBuffer(target, *pDst));
-        FASTCG_CHECK_OPENGL_CALL(glBufferSubData(target, 0, (GLsizeiptr)size, (const GLvoid *)pSrc));
+        GetStateCache().BindBuffer(target, *pDst);
+        if (offset == 0 && size == pDst->GetDataSize())
+        {
+            // orphan the old storage, so the driver doesn't have to wait for the commands that still use it
+            FASTCG_CHECK_OPENGL_CALL(
+                glBufferData(target, (GLsizeiptr)size, nullptr, GetOpenGLUsageHint(pDst->GetUsage())));
+        }
+        FASTCG_CHECK_OPENGL_CALL(glBufferSubData(target, (GLintptr)offset, (GLsizeiptr)size, (const GLvoid *)pSrc));
     }
 
     void OpenGLGraphicsContext::Copy(const OpenGLTexture *pDst, const void *pSrc, size_t size)
@@ -293,7 +271,7 @@ namespace FastCG
         FASTCG_UNUSED(size);
         assert(pDst != nullptr);
         auto target = GetOpenGLTarget(pDst->GetType());
-        FASTCG_CHECK_OPENGL_CALL(glBindTexture(target, *pDst));
+        GetStateCache().BindTexture(0, target, *pDst);
         FASTCG_CHECK_OPENGL_CALL(glTexSubImage2D(target, 0, 0, 0, (GLsizei)pDst->GetWidth(), (GLsizei)pDst->GetHeight(),
                                                  GetOpenGLFormat(pDst->GetFormat()),
                                                  GetOpenGLDataType(pDst->GetFormat()), (const GLvoid *)pSrc));
@@ -306,7 +284,7 @@ namespace FastCG
         assert(size > 0);
 
         auto target = GetOpenGLTarget(pSrc->GetUsage());
-        FASTCG_CHECK_OPENGL_CALL(glBindBuffer(target, *pSrc));
+        GetStateCache().BindBuffer(target, *pSrc);
         void *pMapped = glMapBufferRange(target, (GLintptr)offset, (GLsizeiptr)size, GL_MAP_READ_BIT);
         FASTCG_CHECK_OPENGL_ERROR("TODO");
         if (pMapped)
@@ -329,32 +307,53 @@ namespace FastCG
         {
             return;
         }
-        FASTCG_CHECK_OPENGL_CALL(glUseProgram(pShader->GetProgramId()));
+        GetStateCache().UseProgram(pShader->GetProgramId());
         mpBoundShader = pShader;
         mResourceUsage.clear();
     }
 
-    void OpenGLGraphicsContext::BindResource(const OpenGLBuffer *pBuffer, const char *pName)
+    void OpenGLGraphicsContext::BindResource(const OpenGLBuffer *pBuffer, ShaderResourceId id)
     {
         assert(pBuffer != nullptr);
-        assert(pName != nullptr);
+        BindResource(pBuffer, 0, pBuffer->GetDataSize(), id);
+    }
+
+    void OpenGLGraphicsContext::BindResource(const OpenGLBuffer *pBuffer, size_t offset, size_t size,
+                                             ShaderResourceId id)
+    {
+        assert(pBuffer != nullptr);
+        assert(offset + size <= pBuffer->GetDataSize());
         assert(mpBoundShader != nullptr);
-        const auto &rResourceInfo = mpBoundShader->GetResourceInfo(pName);
+        const auto &rResourceInfo = mpBoundShader->GetResourceInfo(id);
         if (rResourceInfo.binding == -1)
         {
             return;
         }
-        FASTCG_CHECK_OPENGL_CALL(
-            glBindBufferBase(GetOpenGLTarget(pBuffer->GetUsage()), rResourceInfo.binding, *pBuffer));
-        mResourceUsage.emplace(pName);
+        // buffers w/ more than one usage are bound to the target of the shader interface they're bound to
+        GLenum target;
+        if (rResourceInfo.iface == GL_SHADER_STORAGE_BLOCK)
+        {
+            target = GL_SHADER_STORAGE_BUFFER;
+        }
+        else if (rResourceInfo.iface == GL_UNIFORM_BLOCK)
+        {
+            target = GL_UNIFORM_BUFFER;
+        }
+        else
+        {
+            target = GetOpenGLTarget(pBuffer->GetUsage());
+        }
+        GetStateCache().BindBufferRange(target, (GLuint)rResourceInfo.binding, *pBuffer, (GLintptr)offset,
+                                        (GLsizeiptr)size);
+        mResourceUsage.emplace(id);
     }
 
-    void OpenGLGraphicsContext::BindResource(const OpenGLTexture *pTexture, const char *pName)
+    void OpenGLGraphicsContext::BindResource(const OpenGLTexture *pTexture, ShaderResourceId id)
     {
         assert(mpBoundShader != nullptr);
-        const auto &rResourceInfo = mpBoundShader->GetResourceInfo(pName);
+        const auto &rResourceInfo = mpBoundShader->GetResourceInfo(id);
         BindResource(pTexture, rResourceInfo);
-        mResourceUsage.emplace(pName);
+        mResourceUsage.emplace(id);
     }
 
     void OpenGLGraphicsContext::BindResource(const OpenGLTexture *pTexture, const OpenGLResourceInfo &rResourceInfo)
@@ -364,14 +363,13 @@ namespace FastCG
         {
             return;
         }
-        FASTCG_CHECK_OPENGL_CALL(glActiveTexture(GL_TEXTURE0 + rResourceInfo.binding));
         if (pTexture == nullptr)
         {
             // TODO: check the texture type from shader reflection
             pTexture = OpenGLGraphicsSystem::GetInstance()->GetMissingTexture(TextureType::TEXTURE_2D);
         }
-        FASTCG_CHECK_OPENGL_CALL(glBindTexture(GetOpenGLTarget(pTexture->GetType()), *pTexture));
-        FASTCG_CHECK_OPENGL_CALL(glUniform1i(rResourceInfo.location, rResourceInfo.binding));
+        // no need to set the sampler uniform, its value is the binding that was read from the program
+        GetStateCache().BindTexture((GLuint)rResourceInfo.binding, GetOpenGLTarget(pTexture->GetType()), *pTexture);
         FASTCG_CHECK_OPENGL_ERROR("Couldn't bind texture to resource (texture: %s, location: %d, binding: %d)",
                                   pTexture->GetName().c_str(), rResourceInfo.location, rResourceInfo.binding);
     }
@@ -383,31 +381,35 @@ namespace FastCG
         GLint srcWidth, srcHeight;
         if (pSrc == pBackbuffer)
         {
-            FASTCG_CHECK_OPENGL_CALL(glBindFramebuffer(GL_READ_FRAMEBUFFER, 0));
+            GetStateCache().BindFramebuffer(GL_READ_FRAMEBUFFER, 0);
             srcWidth = (GLint)OpenGLGraphicsSystem::GetInstance()->GetScreenWidth();
             srcHeight = (GLint)OpenGLGraphicsSystem::GetInstance()->GetScreenHeight();
         }
         else
         {
             auto readFbo = OpenGLGraphicsSystem::GetInstance()->GetOrCreateFramebuffer(&pSrc, 1, nullptr);
-            FASTCG_CHECK_OPENGL_CALL(glBindFramebuffer(GL_READ_FRAMEBUFFER, readFbo));
-            FASTCG_CHECK_OPENGL_CALL(glReadBuffer(GL_COLOR_ATTACHMENT0));
+            if (GetStateCache().BindFramebuffer(GL_READ_FRAMEBUFFER, readFbo))
+            {
+                FASTCG_CHECK_OPENGL_CALL(glReadBuffer(GL_COLOR_ATTACHMENT0));
+            }
             srcWidth = (GLint)pSrc->GetWidth();
             srcHeight = (GLint)pSrc->GetHeight();
         }
         GLint dstWidth, dstHeight;
         if (pDst == pBackbuffer)
         {
-            FASTCG_CHECK_OPENGL_CALL(glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0));
+            GetStateCache().BindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
             dstWidth = (GLint)OpenGLGraphicsSystem::GetInstance()->GetScreenWidth();
             dstHeight = (GLint)OpenGLGraphicsSystem::GetInstance()->GetScreenHeight();
         }
         else
         {
             auto drawFbo = OpenGLGraphicsSystem::GetInstance()->GetOrCreateFramebuffer(&pDst, 1, nullptr);
-            FASTCG_CHECK_OPENGL_CALL(glBindFramebuffer(GL_DRAW_FRAMEBUFFER, drawFbo));
-            GLenum drawBuffers[1] = {GL_COLOR_ATTACHMENT0};
-            FASTCG_CHECK_OPENGL_CALL(glDrawBuffers(1, drawBuffers));
+            if (GetStateCache().BindFramebuffer(GL_DRAW_FRAMEBUFFER, drawFbo))
+            {
+                GLenum drawBuffers[1] = {GL_COLOR_ATTACHMENT0};
+                FASTCG_CHECK_OPENGL_CALL(glDrawBuffers(1, drawBuffers));
+            }
             dstWidth = (GLint)pDst->GetWidth();
             dstHeight = (GLint)pDst->GetHeight();
         }
@@ -464,14 +466,18 @@ namespace FastCG
         if (renderTargetCount == 1 && ppRenderTargets[0] == OpenGLGraphicsSystem::GetInstance()->GetBackbuffer() &&
             pDepthStencilBuffer == nullptr)
         {
-            FASTCG_CHECK_OPENGL_CALL(glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0));
+            GetStateCache().BindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
             return;
         }
 
         auto fbId = OpenGLGraphicsSystem::GetInstance()->GetOrCreateFramebuffer(ppRenderTargets, renderTargetCount,
                                                                                 pDepthStencilBuffer);
         assert(fbId != ~0u);
-        FASTCG_CHECK_OPENGL_CALL(glBindFramebuffer(GL_DRAW_FRAMEBUFFER, fbId));
+        // draw buffers are framebuffer state and an FBO always has the same attachments
+        if (!GetStateCache().BindFramebuffer(GL_DRAW_FRAMEBUFFER, fbId))
+        {
+            return;
+        }
 
         std::vector<GLenum> attachments;
         attachments.reserve(renderTargetCount);
@@ -494,7 +500,7 @@ namespace FastCG
         assert(bufferCount > 0);
         auto vaoId = OpenGLGraphicsSystem::GetInstance()->GetOrCreateVertexArray(pBuffers, bufferCount);
         assert(vaoId != ~0u);
-        FASTCG_CHECK_OPENGL_CALL(glBindVertexArray(vaoId));
+        GetStateCache().BindVertexArray(vaoId);
     }
 
     void OpenGLGraphicsContext::SetIndexBuffer(const OpenGLBuffer *pBuffer)
@@ -503,7 +509,7 @@ namespace FastCG
         assert(mpBoundShader != nullptr);
         auto target = GetOpenGLTarget(pBuffer->GetUsage());
         assert(target == GL_ELEMENT_ARRAY_BUFFER);
-        FASTCG_CHECK_OPENGL_CALL(glBindBuffer(target, *pBuffer));
+        GetStateCache().BindBuffer(target, *pBuffer);
     }
 
     void OpenGLGraphicsContext::SetupDraw()
@@ -511,8 +517,7 @@ namespace FastCG
         assert(mpBoundShader != nullptr);
         for (const auto &rEntry : mpBoundShader->GetResourceInfoMap())
         {
-            const auto &rResourceName = rEntry.first;
-            if (mResourceUsage.find(rResourceName) != mResourceUsage.end())
+            if (mResourceUsage.find(rEntry.first) != mResourceUsage.end())
             {
                 continue;
             }
@@ -554,6 +559,44 @@ namespace FastCG
             (GLvoid *)(uintptr_t)(firstIndex * sizeof(uint32_t)), (GLsizei)instanceCount, (GLint)vertexOffset));
     }
 
+    void OpenGLGraphicsContext::DrawIndexedIndirect(PrimitiveType primitiveType, const OpenGLBuffer *pIndirectBuffer,
+                                                    size_t offset)
+    {
+        assert(pIndirectBuffer != nullptr);
+        assert((pIndirectBuffer->GetUsage() & BufferUsageFlagBit::INDIRECT) != 0);
+        assert(offset + sizeof(DrawIndexedIndirectCommand) <= pIndirectBuffer->GetDataSize());
+        SetupDraw();
+        GetStateCache().BindBuffer(GL_DRAW_INDIRECT_BUFFER, *pIndirectBuffer);
+        FASTCG_CHECK_OPENGL_CALL(glDrawElementsIndirect(GetOpenGLPrimitiveType(primitiveType), GL_UNSIGNED_INT,
+                                                        (const GLvoid *)(uintptr_t)offset));
+    }
+
+    void OpenGLGraphicsContext::MultiDrawIndexedIndirect(PrimitiveType primitiveType,
+                                                         const OpenGLBuffer *pIndirectBuffer, size_t offset,
+                                                         uint32_t drawCount, uint32_t stride)
+    {
+        assert(pIndirectBuffer != nullptr);
+        assert((pIndirectBuffer->GetUsage() & BufferUsageFlagBit::INDIRECT) != 0);
+        assert(drawCount > 0);
+        assert(stride == 0 || stride >= sizeof(DrawIndexedIndirectCommand));
+        SetupDraw();
+        GetStateCache().BindBuffer(GL_DRAW_INDIRECT_BUFFER, *pIndirectBuffer);
+        // baseInstance must be 0 in the draw arguments since shaders index the instance constants w/ gl_InstanceID
+#if defined FASTCG_ANDROID
+        // no glMultiDrawElementsIndirect in GLES 3.2
+        stride = stride == 0 ? (uint32_t)sizeof(DrawIndexedIndirectCommand) : stride;
+        for (uint32_t i = 0; i < drawCount; ++i)
+        {
+            FASTCG_CHECK_OPENGL_CALL(glDrawElementsIndirect(GetOpenGLPrimitiveType(primitiveType), GL_UNSIGNED_INT,
+                                                            (const GLvoid *)(uintptr_t)(offset + i * stride)));
+        }
+#else
+        FASTCG_CHECK_OPENGL_CALL(glMultiDrawElementsIndirect(GetOpenGLPrimitiveType(primitiveType), GL_UNSIGNED_INT,
+                                                             (const GLvoid *)(uintptr_t)offset, (GLsizei)drawCount,
+                                                             (GLsizei)stride));
+#endif
+    }
+
     void OpenGLGraphicsContext::Dispatch(uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ)
     {
         assert(groupCountX > 0);
@@ -19,11 +19,14 @@
 #endif
 
 #include <algorithm>
+#include <cstring>
 #include <iostream>
 #include <stdio.h>
 
 namespace
 {
+    constexpr size_t UPLOAD_RING_ALIGNMENT = 16;
+
 #if defined FASTCG_LINUX
     int GLXContextErrorHandler(Display *pDisplay, XErrorEvent *pErrorEvent)
     {
@@ -229,6 +232,30 @@ namespace FastCG
 #endif
 
         QueryDeviceProperties();
+
+        CreateUploadRing();
+    }
+
+    void OpenGLGraphicsSystem::OnPreFinalize()
+    {
+        DestroyUploadRing();
+
+        BaseGraphicsSystem::OnPreFinalize();
+    }
+
+    void OpenGLGraphicsSystem::ConstructShaders(const std::vector<OpenGLShader::Args> &rArgs,
+                                                std::vector<OpenGLShader *> &rShaders)
+    {
+        // start compiling and linking all programs before waiting on any of them, so that drivers w/
+        // GL_KHR_parallel_shader_compile can work on them in the background
+        for (size_t i = 0; i < rArgs.size(); ++i)
+        {
+            rShaders[i] = new OpenGLShader(rArgs[i], false);
+        }
+        for (size_t i = 0; i < rArgs.size(); ++i)
+        {
+            rShaders[i]->FinishLinking(rArgs[i]);
+        }
     }
 
 #define DECLARE_DESTROY_METHOD(className, containerMember)                                                             \
@@ -288,6 +315,9 @@ namespace FastCG
         }
         FASTCG_CHECK_OPENGL_CALL(glDeleteSync(fence));
 
+        // the GPU is idle, so the whole upload ring is free
+        mUploadRingOffset = 0;
+
 #if !defined FASTCG_DISABLE_GPU_TIMING
         for (auto *pGraphicsContext : GetGraphicsContexts())
         {
@@ -344,12 +374,11 @@ namespace FastCG
             return it->second;
         }
 
-        GLint oldFboId;
-        FASTCG_CHECK_OPENGL_CALL(glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &oldFboId));
+        auto oldFboId = mStateCache.GetFramebuffer(GL_DRAW_FRAMEBUFFER);
 
         GLuint fboId;
         FASTCG_CHECK_OPENGL_CALL(glGenFramebuffers(1, &fboId));
-        FASTCG_CHECK_OPENGL_CALL(glBindFramebuffer(GL_DRAW_FRAMEBUFFER, fboId));
+        mStateCache.BindFramebuffer(GL_DRAW_FRAMEBUFFER, fboId);
 #if _DEBUG
         {
             auto framebufferLabel = std::string("FBO ") + std::to_string(mFboIds.size()) + " (GL_FRAMEBUFFER)";
@@ -399,7 +428,7 @@ namespace FastCG
             mFboIdToTextureIds[fboId].emplace_back(depthStencilBufferId);
         }
 
-        FASTCG_CHECK_OPENGL_CALL(glBindFramebuffer(GL_DRAW_FRAMEBUFFER, oldFboId));
+        mStateCache.BindFramebuffer(GL_DRAW_FRAMEBUFFER, oldFboId);
 
         return fboId;
     }
@@ -425,7 +454,7 @@ namespace FastCG
 
         GLuint vaoId;
         FASTCG_CHECK_OPENGL_CALL(glGenVertexArrays(1, &vaoId));
-        FASTCG_CHECK_OPENGL_CALL(glBindVertexArray(vaoId));
+        mStateCache.BindVertexArray(vaoId);
 #if _DEBUG
         {
             auto vertexArrayLabel = std::string("VAO ") + std::to_string(mVaoIds.size()) + " (GL_VERTEX_ARRAY)";
@@ -434,8 +463,8 @@ namespace FastCG
         }
 #endif
 
-        std::for_each(pBuffers, pBuffers + bufferCount, [](const auto *pBuffer) {
-            FASTCG_CHECK_OPENGL_CALL(glBindBuffer(GetOpenGLTarget(pBuffer->GetUsage()), *pBuffer));
+        std::for_each(pBuffers, pBuffers + bufferCount, [this](const auto *pBuffer) {
+            mStateCache.BindBuffer(GetOpenGLTarget(pBuffer->GetUsage()), *pBuffer);
             for (const auto &rVbDesc : pBuffer->GetVertexBindingDescriptors())
             {
                 assert(rVbDesc.size > 0);
@@ -455,6 +484,7 @@ namespace FastCG
     {
         assert(rFbo.second > 0);
         FASTCG_CHECK_OPENGL_CALL(glDeleteFramebuffers(1, &rFbo.second));
+        mStateCache.OnFramebufferDeleted(rFbo.second);
         auto it1 = mFboIdToTextureIds.find(rFbo.second);
         if (it1 != mFboIdToTextureIds.end())
         {
@@ -991,6 +1021,71 @@ namespace FastCG
             glGetIntegerv(GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS, &mDeviceProperties.maxTextureUnits));
     }
 
+    void OpenGLGraphicsSystem::CreateUploadRing()
+    {
+#if defined FASTCG_ANDROID
+        // no glBufferStorage in GLES 3.2, uploads fallback to glBufferSubData (w/ orphaning)
+#else
+        if (mArgs.stagingBufferSize == 0 || !GLEW_ARB_buffer_storage)
+        {
+            return;
+        }
+
+        auto size = (GLsizeiptr)(mArgs.stagingBufferSize * GetMaxSimultaneousFrames());
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        FASTCG_CHECK_OPENGL_CALL(glGenBuffers(1, &mUploadRingId));
+        mStateCache.BindBuffer(GL_COPY_READ_BUFFER, mUploadRingId);
+#if _DEBUG
+        {
+            const char UPLOAD_RING_LABEL[] = "Upload Ring (GL_BUFFER)";
+            FASTCG_CHECK_OPENGL_CALL(
+                glObjectLabel(GL_BUFFER, mUploadRingId, (GLsizei)(sizeof(UPLOAD_RING_LABEL) - 1), UPLOAD_RING_LABEL));
+        }
+#endif
+        FASTCG_CHECK_OPENGL_CALL(glBufferStorage(GL_COPY_READ_BUFFER, size, nullptr, flags));
+        mpUploadRingData = (uint8_t *)glMapBufferRange(GL_COPY_READ_BUFFER, 0, size, flags);
+        FASTCG_CHECK_OPENGL_ERROR("Couldn't map the upload ring");
+        assert(mpUploadRingData != nullptr);
+        mUploadRingOffset = 0;
+#endif
+    }
+
+    void OpenGLGraphicsSystem::DestroyUploadRing()
+    {
+        if (mUploadRingId == 0)
+        {
+            return;
+        }
+
+        mStateCache.BindBuffer(GL_COPY_READ_BUFFER, mUploadRingId);
+        FASTCG_CHECK_OPENGL_CALL(glUnmapBuffer(GL_COPY_READ_BUFFER));
+        FASTCG_CHECK_OPENGL_CALL(glDeleteBuffers(1, &mUploadRingId));
+        mStateCache.OnBufferDeleted(mUploadRingId);
+        mUploadRingId = 0;
+        mpUploadRingData = nullptr;
+    }
+
+    bool OpenGLGraphicsSystem::CopyToUploadRing(const void *pSrc, size_t size, size_t &rOffset)
+    {
+        if (mpUploadRingData == nullptr)
+        {
+            return false;
+        }
+
+        auto offset = (mUploadRingOffset + UPLOAD_RING_ALIGNMENT - 1) & ~(UPLOAD_RING_ALIGNMENT - 1);
+        if (offset + size > mArgs.stagingBufferSize)
+        {
+            return false;
+        }
+
+        // coherent mapping, so the write is visible to the commands issued after it w/o any flush
+        rOffset = mCurrentFrame * mArgs.stagingBufferSize + offset;
+        std::memcpy(mpUploadRingData + rOffset, pSrc, size);
+
+        mUploadRingOffset = offset + size;
+        return true;
+    }
+
     void OpenGLGraphicsSystem::DestroyOpenGLContext(void *pWindow)
     {
 #if defined FASTCG_WINDOWS
@@ -1070,6 +1165,7 @@ namespace FastCG
         assert(mFrameFences[mCurrentFrame] != 0);
         SwapBuffers();
         mCurrentFrame ^= 1;
+        mStateCache.OnFrameEnd();
 
         if (mFrameFences[mCurrentFrame] != nullptr)
         {
@@ -1083,6 +1179,9 @@ namespace FastCG
             mFrameFences[mCurrentFrame] = nullptr;
         }
 
+        // the frame that last used the current frame's region of the upload ring is done
+        mUploadRingOffset = 0;
+
 #if !defined FASTCG_DISABLE_GPU_TIMING
         for (auto *pGraphicsContext : GetGraphicsContexts())
         {
@@ -1140,6 +1239,17 @@ namespace FastCG
 
     void OpenGLGraphicsSystem::NotifyPostContextCreate()
     {
+        // a new context comes w/ its own state
+        mStateCache.Invalidate();
+
+#if !defined FASTCG_ANDROID
+        if (GLEW_KHR_parallel_shader_compile)
+        {
+            // let the driver use as many threads as it sees fit
+            FASTCG_CHECK_OPENGL_CALL(glMaxShaderCompilerThreadsKHR(0xffffffff));
+        }
+#endif
+
         for (auto *pGraphicsContext : GetGraphicsContexts())
         {
             pGraphicsContext->OnPostContextCreate();
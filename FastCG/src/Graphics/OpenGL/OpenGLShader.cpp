@@ -1,16 +1,28 @@
 #ifdef FASTCG_OPENGL
 
 #include <FastCG/Core/CollectionUtils.h>
+#include <FastCG/Core/Log.h>
 #include <FastCG/Core/Macros.h>
 #include <FastCG/Core/StringUtils.h>
 #include <FastCG/Graphics/OpenGL/OpenGLErrorHandling.h>
+#include <FastCG/Graphics/OpenGL/OpenGLGraphicsSystem.h>
 #include <FastCG/Graphics/OpenGL/OpenGLShader.h>
 #include <FastCG/Graphics/OpenGL/OpenGLUtils.h>
+#include <FastCG/Graphics/RenderingPath.h>
+#include <FastCG/Platform/Application.h>
 #include <FastCG/Platform/FileReader.h>
+#include <FastCG/Platform/FileWriter.h>
 
+#include <algorithm>
 #include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <string>
 #include <vector>
 
+// defined in the application's Config.cpp
+extern const char *const APPLICATION_NAME;
+
 namespace
 {
 #define DECLARE_CHECK_STATUS_FN(object)                                                                                \
@@ -37,9 +49,14 @@ namespace
     DECLARE_CHECK_STATUS_FN(Program)
 
     void GetShaderResourceLocations(const std::string &rIdentifier, GLuint programId,
-                                    std::unordered_map<std::string, FastCG::OpenGLResourceInfo> &rResourceInfos)
+                                    FastCG::OpenGLResourceInfoMap &rResourceInfos)
     {
         FASTCG_UNUSED(rIdentifier);
+#if _DEBUG
+        // resource ids are hashes of the resource names, so two different names must never share one
+        std::unordered_map<FastCG::ShaderResourceId, std::string, FastCG::IdentityHasher<FastCG::ShaderResourceId>>
+            resourceNames;
+#endif
         for (GLenum iface : {GL_UNIFORM_BLOCK, GL_SHADER_STORAGE_BLOCK, GL_UNIFORM})
         {
             GLint activeResourcesCount = 0;
@@ -54,9 +71,16 @@ namespace
                 FASTCG_CHECK_OPENGL_CALL(
                     glGetProgramResourceName(programId, iface, i, FASTCG_ARRAYSIZE(buffer), &length, buffer));
 
-                std::string resourceName(buffer, length);
+                buffer[length] = '\0';
+                auto resourceId = FastCG::GetShaderResourceId(buffer);
+#if _DEBUG
+                {
+                    auto it = resourceNames.emplace(resourceId, buffer).first;
+                    assert(it->second == buffer);
+                }
+#endif
 
-                auto it = rResourceInfos.find(resourceName);
+                auto it = rResourceInfos.find(resourceId);
                 if (it != rResourceInfos.end())
                 {
                     continue;
@@ -95,18 +119,210 @@ namespace
                     continue;
                 }
 
-                rResourceInfos[resourceName] = {location, binding, iface, type};
+                rResourceInfos[resourceId] = {location, binding, iface, type};
             }
         }
     }
 
+    constexpr uint32_t PROGRAM_BINARY_FILE_MAGIC = 0x46434742; // "FCGB"
+
+    // prefixes the reflected resources and the program binary in the file.
+    // a program binary can only be loaded by the driver that produced it, so the driver (vendor, renderer and version
+    // strings) is part of the key, along with the sources
+    struct ProgramBinaryFileHeader
+    {
+        uint32_t magic;
+        uint32_t binaryFormat;
+        uint64_t driverHash;
+        uint64_t sourceHash;
+        uint32_t resourceCount;
+        uint32_t binarySize;
+    };
+
+    struct ProgramBinaryResource
+    {
+        FastCG::ShaderResourceId id;
+        FastCG::OpenGLResourceInfo info;
+    };
+
+    std::filesystem::path GetProgramBinaryPath(const std::string &rProgramName)
+    {
+        // program names are only unique within a rendering path (e.g., forward and deferred lighting shaders)
+        const auto *pRenderingPath =
+            FastCG::GetRenderingPathString(FastCG::Application::GetInstance()->GetRenderingPath());
+        return FastCG::Application::GetInstance()->GetDataPath() / "cache" /
+               (std::string(APPLICATION_NAME) + "_" + pRenderingPath + "_" + rProgramName + "_OpenGLProgram.bin");
+    }
+
+    bool IsProgramBinarySupported()
+    {
+        // drivers can expose the API without supporting any binary format
+        GLint formatCount = 0;
+        FASTCG_CHECK_OPENGL_CALL(glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount));
+        return formatCount > 0;
+    }
+
+    uint64_t GetDriverHash()
+    {
+        std::string driver;
+        for (GLenum name : {GL_VENDOR, GL_RENDERER, GL_VERSION})
+        {
+            auto pString = (const char *)glGetString(name);
+            driver += pString != nullptr ? pString : "";
+            driver += '\n';
+        }
+        return FastCG::MurmurHash64A(driver.data(), driver.size());
+    }
+
+    uint64_t GetSourceHash(const FastCG::OpenGLShader::Args &rArgs)
+    {
+        // every stage is chained into the hash (even the empty ones), so moving code between stages changes it
+        uint64_t hash = rArgs.text ? 1 : 0;
+        for (const auto &rProgramData : rArgs.programsData)
+        {
+            hash = FastCG::MurmurHash64A(rProgramData.pData, rProgramData.dataSize, hash);
+        }
+        return hash;
+    }
+
+    bool LoadProgramBinary(const std::string &rProgramName, uint64_t driverHash, uint64_t sourceHash, GLuint programId,
+                           FastCG::OpenGLResourceInfoMap &rResourceInfos)
+    {
+        size_t fileSize;
+        auto pFileData = FastCG::FileReader::ReadBinary(GetProgramBinaryPath(rProgramName), fileSize);
+        if (pFileData == nullptr || fileSize < sizeof(ProgramBinaryFileHeader))
+        {
+            return false;
+        }
+
+        ProgramBinaryFileHeader header;
+        std::memcpy(&header, pFileData.get(), sizeof(header));
+        auto resourcesSize = (size_t)header.resourceCount * sizeof(ProgramBinaryResource);
+        if (header.magic != PROGRAM_BINARY_FILE_MAGIC || header.driverHash != driverHash ||
+            header.sourceHash != sourceHash || fileSize != sizeof(header) + resourcesSize + header.binarySize)
+        {
+            FASTCG_LOG_DEBUG(OpenGLShader, "Discarding stale program binary (program: %s)", rProgramName.c_str());
+            return false;
+        }
+
+        // drivers may still reject their own binaries (e.g., after an update that kept the version string), in which
+        // case the program is simply compiled again
+        glProgramBinary(programId, (GLenum)header.binaryFormat, pFileData.get() + sizeof(header) + resourcesSize,
+                        (GLsizei)header.binarySize);
+        glGetError();
+        std::string infoLog;
+        if (!CheckProgramStatus(programId, GL_LINK_STATUS, infoLog))
+        {
+            FASTCG_LOG_DEBUG(OpenGLShader, "Discarding rejected program binary (program: %s)", rProgramName.c_str());
+            return false;
+        }
+
+        for (uint32_t i = 0; i < header.resourceCount; ++i)
+        {
+            ProgramBinaryResource resource;
+            std::memcpy(&resource, pFileData.get() + sizeof(header) + i * sizeof(resource), sizeof(resource));
+            rResourceInfos[resource.id] = resource.info;
+        }
+
+        return true;
+    }
+
+    void SaveProgramBinary(const std::string &rProgramName, uint64_t driverHash, uint64_t sourceHash, GLuint programId,
+                           const FastCG::OpenGLResourceInfoMap &rResourceInfos)
+    {
+        GLint binarySize = 0;
+        FASTCG_CHECK_OPENGL_CALL(glGetProgramiv(programId, GL_PROGRAM_BINARY_LENGTH, &binarySize));
+        if (binarySize <= 0)
+        {
+            return;
+        }
+
+        ProgramBinaryFileHeader header{};
+        header.magic = PROGRAM_BINARY_FILE_MAGIC;
+        header.driverHash = driverHash;
+        header.sourceHash = sourceHash;
+        header.resourceCount = (uint32_t)rResourceInfos.size();
+        auto resourcesSize = (size_t)header.resourceCount * sizeof(ProgramBinaryResource);
+
+        std::vector<uint8_t> fileData(sizeof(header) + resourcesSize + (size_t)binarySize);
+        GLenum binaryFormat;
+        FASTCG_CHECK_OPENGL_CALL(glGetProgramBinary(programId, binarySize, &binarySize, &binaryFormat,
+                                                    fileData.data() + sizeof(header) + resourcesSize));
+        header.binaryFormat = (uint32_t)binaryFormat;
+        header.binarySize = (uint32_t)binarySize;
+        std::memcpy(fileData.data(), &header, sizeof(header));
+
+        auto *pResource = fileData.data() + sizeof(header);
+        for (const auto &rEntry : rResourceInfos)
+        {
+            ProgramBinaryResource resource{rEntry.first, rEntry.second};
+            std::memcpy(pResource, &resource, sizeof(resource));
+            pResource += sizeof(resource);
+        }
+
+        // failing to persist the binary only costs a shader compilation on the next run
+        try
+        {
+            FastCG::FileWriter::WriteBinary(GetProgramBinaryPath(rProgramName), fileData.data(),
+                                            sizeof(header) + resourcesSize + (size_t)binarySize);
+        }
+        catch (const std::exception &rException)
+        {
+            FASTCG_UNUSED(rException);
+            FASTCG_LOG_DEBUG(OpenGLShader, "Couldn't save program binary (program: %s): %s", rProgramName.c_str(),
+                             rException.what());
+        }
+    }
+
 }
 
 namespace FastCG
 {
-    OpenGLShader::OpenGLShader(const Args &rArgs) : BaseShader(rArgs)
+    OpenGLShader::OpenGLShader(const Args &rArgs) : OpenGLShader(rArgs, true)
+    {
+    }
+
+    OpenGLShader::OpenGLShader(const Args &rArgs, bool finishLinking) : BaseShader(rArgs)
     {
         std::fill(mShadersIds.begin(), mShadersIds.end(), ~0u);
+
+        mProgramId = glCreateProgram();
+        FASTCG_CHECK_OPENGL_ERROR("Failed to create program");
+        assert(mProgramId != 0);
+
+        // a cached program binary replaces both compilation and reflection
+        auto programBinarySupported = IsProgramBinarySupported();
+        if (!programBinarySupported ||
+            !LoadProgramBinary(mName, GetDriverHash(), GetSourceHash(rArgs), mProgramId, mResourceInfo))
+        {
+            Compile(rArgs, programBinarySupported);
+        }
+
+        if (finishLinking)
+        {
+            FinishLinking(rArgs);
+        }
+    }
+
+    OpenGLShader::~OpenGLShader()
+    {
+        for (auto shaderId : mShadersIds)
+        {
+            if (shaderId != ~0u)
+            {
+                glDeleteShader(shaderId);
+            }
+        }
+
+        if (mProgramId != ~0u)
+        {
+            glDeleteProgram(mProgramId);
+            OpenGLGraphicsSystem::GetInstance()->GetStateCache().OnProgramDeleted(mProgramId);
+        }
+    }
+
+    void OpenGLShader::Compile(const Args &rArgs, bool retrievable)
+    {
         for (ShaderTypeInt i = 0; i < (ShaderTypeInt)ShaderType::LAST; ++i)
         {
             auto shaderType = (ShaderType)i;
@@ -126,39 +342,6 @@ namespace FastCG
             {
                 FASTCG_CHECK_OPENGL_CALL(glShaderSource(shaderId, 1, (const char **)&rProgramData.pData, nullptr));
                 FASTCG_CHECK_OPENGL_CALL(glCompileShader(shaderId));
-
-                std::string infoLog;
-                if (!CheckShaderStatus(shaderId, GL_COMPILE_STATUS, infoLog))
-                {
-                    std::vector<std::string> tokens;
-                    StringUtils::Split(infoLog, ":", tokens);
-                    assert(tokens.size() >= 4);
-
-                    std::vector<std::string> lines;
-                    StringUtils::Split((const char *)rProgramData.pData, "\n", lines);
-
-                    auto errorLine = (size_t)atoll(tokens[1].c_str());
-                    assert(errorLine > 0);
-                    assert(lines.size() > errorLine);
-                    std::string snippet;
-                    if (errorLine > 1)
-                    {
-                        snippet = "    " + lines[errorLine - 2] + "\n";
-                    }
-                    snippet += "--> " + lines[errorLine - 1] + "\n";
-                    if (lines.size() > errorLine)
-                    {
-                        snippet += "    " + lines[errorLine] + "\n";
-                    }
-
-                    std::vector<std::string> subTokens;
-                    CollectionUtils::Slice(tokens, 2, tokens.size(), subTokens);
-                    auto cause = StringUtils::Join(subTokens, ":");
-
-                    FASTCG_THROW_EXCEPTION(
-                        FastCG::Exception, "Couldn't compile shader module (program: %s, type: %s):\n%s\n%s",
-                        mName.c_str(), GetShaderTypeString(shaderType), cause.c_str(), snippet.c_str());
-                }
             }
 #if defined FASTCG_ANDROID
             else
@@ -180,13 +363,6 @@ namespace FastCG
                     FASTCG_THROW_EXCEPTION(Exception, "Can't use shader SPIR-V module (program: %s, type: %s)",
                                            mName.c_str(), GetShaderTypeString(shaderType));
                 }
-
-                std::string infoLog;
-                if (!CheckShaderStatus(shaderId, GL_COMPILE_STATUS, infoLog))
-                {
-                    FASTCG_THROW_EXCEPTION(Exception, "Couldn't compile shader module (program: %s, type: %s):\n%s",
-                                           mName.c_str(), GetShaderTypeString(shaderType), infoLog.c_str());
-                }
             }
 #endif
 
@@ -199,10 +375,6 @@ namespace FastCG
 #endif
         }
 
-        mProgramId = glCreateProgram();
-        FASTCG_CHECK_OPENGL_ERROR("Failed to create program");
-        assert(mProgramId != 0);
-
         for (const auto &shaderId : mShadersIds)
         {
             if (shaderId != ~0u)
@@ -211,23 +383,43 @@ namespace FastCG
             }
         }
 
+        if (retrievable)
+        {
+            FASTCG_CHECK_OPENGL_CALL(glProgramParameteri(mProgramId, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE));
+        }
+
         FASTCG_CHECK_OPENGL_CALL(glLinkProgram(mProgramId));
+    }
+
+    void OpenGLShader::FinishLinking(const Args &rArgs)
+    {
+        // shaders are only created when the program didn't come from a cached binary
+        if (std::any_of(mShadersIds.cbegin(), mShadersIds.cend(), [](auto shaderId) { return shaderId != ~0u; }))
         {
-            std::string infoLog;
-            if (!CheckProgramStatus(mProgramId, GL_LINK_STATUS, infoLog))
+            CheckCompileStatus(rArgs);
+
             {
-                FASTCG_THROW_EXCEPTION(Exception, "Couldn't link shader program (program: %s):\n%s", mName.c_str(),
-                                       infoLog.c_str());
+                std::string infoLog;
+                if (!CheckProgramStatus(mProgramId, GL_LINK_STATUS, infoLog))
+                {
+                    FASTCG_THROW_EXCEPTION(Exception, "Couldn't link shader program (program: %s):\n%s",
+                                           mName.c_str(), infoLog.c_str());
+                }
             }
-        }
 
-        GetShaderResourceLocations(mName, mProgramId, mResourceInfo);
+            GetShaderResourceLocations(mName, mProgramId, mResourceInfo);
 
-        for (const auto &shaderId : mShadersIds)
-        {
-            if (shaderId != ~0u)
+            for (const auto &shaderId : mShadersIds)
+            {
+                if (shaderId != ~0u)
+                {
+                    FASTCG_CHECK_OPENGL_CALL(glDetachShader(mProgramId, shaderId));
+                }
+            }
+
+            if (IsProgramBinarySupported())
             {
-                FASTCG_CHECK_OPENGL_CALL(glDetachShader(mProgramId, shaderId));
+                SaveProgramBinary(mName, GetDriverHash(), GetSourceHash(rArgs), mProgramId, mResourceInfo);
             }
         }
 
@@ -250,19 +442,60 @@ namespace FastCG
 #endif
     }
 
-    OpenGLShader::~OpenGLShader()
+    void OpenGLShader::CheckCompileStatus(const Args &rArgs)
     {
-        for (auto shaderId : mShadersIds)
+        for (ShaderTypeInt i = 0; i < (ShaderTypeInt)ShaderType::LAST; ++i)
         {
-            if (shaderId != ~0u)
+            auto shaderId = mShadersIds[i];
+            if (shaderId == ~0u)
             {
-                glDeleteShader(shaderId);
+                continue;
             }
-        }
 
-        if (mProgramId != ~0u)
-        {
-            glDeleteProgram(mProgramId);
+            auto shaderType = (ShaderType)i;
+
+            std::string infoLog;
+            if (CheckShaderStatus(shaderId, GL_COMPILE_STATUS, infoLog))
+            {
+                continue;
+            }
+
+            if (rArgs.text)
+            {
+                std::vector<std::string> tokens;
+                StringUtils::Split(infoLog, ":", tokens);
+                assert(tokens.size() >= 4);
+
+                std::vector<std::string> lines;
+                StringUtils::Split((const char *)rArgs.programsData[i].pData, "\n", lines);
+
+                auto errorLine = (size_t)atoll(tokens[1].c_str());
+                assert(errorLine > 0);
+                assert(lines.size() > errorLine);
+                std::string snippet;
+                if (errorLine > 1)
+                {
+                    snippet = "    " + lines[errorLine - 2] + "\n";
+                }
+                snippet += "--> " + lines[errorLine - 1] + "\n";
+                if (lines.size() > errorLine)
+                {
+                    snippet += "    " + lines[errorLine] + "\n";
+                }
+
+                std::vector<std::string> subTokens;
+                CollectionUtils::Slice(tokens, 2, tokens.size(), subTokens);
+                auto cause = StringUtils::Join(subTokens, ":");
+
+                FASTCG_THROW_EXCEPTION(FastCG::Exception,
+                                       "Couldn't compile shader module (program: %s, type: %s):\n%s\n%s",
+                                       mName.c_str(), GetShaderTypeString(shaderType), cause.c_str(), snippet.c_str());
+            }
+            else
+            {
+                FASTCG_THROW_EXCEPTION(Exception, "Couldn't compile shader module (program: %s, type: %s):\n%s",
+                                       mName.c_str(), GetShaderTypeString(shaderType), infoLog.c_str());
+            }
         }
     }
 
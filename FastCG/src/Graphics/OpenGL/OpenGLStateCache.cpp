@@ -0,0 +1,343 @@
+#ifdef FASTCG_OPENGL
+
+#include <FastCG/Core/Exception.h>
+#include <FastCG/Graphics/OpenGL/OpenGLErrorHandling.h>
+#include <FastCG/Graphics/OpenGL/OpenGLStateCache.h>
+
+#include <cassert>
+
+namespace
+{
+    size_t GetCapabilityIndex(GLenum capability)
+    {
+        switch (capability)
+        {
+        case GL_BLEND:
+            return 0;
+        case GL_CULL_FACE:
+            return 1;
+        case GL_DEPTH_TEST:
+            return 2;
+        case GL_SCISSOR_TEST:
+            return 3;
+        case GL_STENCIL_TEST:
+            return 4;
+        default:
+            FASTCG_THROW_EXCEPTION(FastCG::Exception, "OpenGL: Untracked capability (capability: %d)", (int)capability);
+            return 0;
+        }
+    }
+
+    uint64_t GetBufferRangeKey(GLenum target, GLuint index)
+    {
+        return ((uint64_t)target << 32) | (uint64_t)index;
+    }
+}
+
+namespace FastCG
+{
+    void OpenGLStateCache::Invalidate()
+    {
+        mState = {};
+    }
+
+    bool OpenGLStateCache::IsEnabled(GLenum capability)
+    {
+        auto &rEnabled = mState.enabled[GetCapabilityIndex(capability)];
+        if (!rEnabled.valid)
+        {
+            GLboolean enabled = glIsEnabled(capability);
+            FASTCG_CHECK_OPENGL_ERROR("Couldn't query capability (capability: %d)", (int)capability);
+            rEnabled = {enabled == GL_TRUE, true};
+        }
+        return rEnabled.value;
+    }
+
+    void OpenGLStateCache::SetEnabled(GLenum capability, bool enabled)
+    {
+        if (!Changes(mState.enabled[GetCapabilityIndex(capability)], enabled))
+        {
+            return;
+        }
+        if (enabled)
+        {
+            FASTCG_CHECK_OPENGL_CALL(glEnable(capability));
+        }
+        else
+        {
+            FASTCG_CHECK_OPENGL_CALL(glDisable(capability));
+        }
+    }
+
+    void OpenGLStateCache::SetBlendEquation(GLenum color, GLenum alpha)
+    {
+        if (!Changes(mState.blendEquation, {color, alpha}))
+        {
+            return;
+        }
+        if (color == alpha)
+        {
+            FASTCG_CHECK_OPENGL_CALL(glBlendEquation(color));
+        }
+        else
+        {
+            FASTCG_CHECK_OPENGL_CALL(glBlendEquationSeparate(color, alpha));
+        }
+    }
+
+    void OpenGLStateCache::SetBlendFunc(GLenum srcColor, GLenum dstColor, GLenum srcAlpha, GLenum dstAlpha)
+    {
+        if (!Changes(mState.blendFunc, {srcColor, dstColor, srcAlpha, dstAlpha}))
+        {
+            return;
+        }
+        FASTCG_CHECK_OPENGL_CALL(glBlendFuncSeparate(srcColor, dstColor, srcAlpha, dstAlpha));
+    }
+
+    void OpenGLStateCache::SetStencilFunc(GLenum face, GLenum func, GLint ref, GLuint mask)
+    {
+        if (!Changes(face, mState.stencilFunc, {func, (GLuint)ref, mask}))
+        {
+            return;
+        }
+        if (face == GL_FRONT_AND_BACK)
+        {
+            FASTCG_CHECK_OPENGL_CALL(glStencilFunc(func, ref, mask));
+        }
+        else
+        {
+            FASTCG_CHECK_OPENGL_CALL(glStencilFuncSeparate(face, func, ref, mask));
+        }
+    }
+
+    void OpenGLStateCache::SetStencilOp(GLenum face, GLenum stencilFail, GLenum depthFail, GLenum depthPass)
+    {
+        if (!Changes(face, mState.stencilOp, {stencilFail, depthFail, depthPass}))
+        {
+            return;
+        }
+        FASTCG_CHECK_OPENGL_CALL(glStencilOpSeparate(face, stencilFail, depthFail, depthPass));
+    }
+
+    void OpenGLStateCache::SetStencilWriteMask(GLenum face, GLuint mask)
+    {
+        if (!Changes(face, mState.stencilWriteMask, mask))
+        {
+            return;
+        }
+        FASTCG_CHECK_OPENGL_CALL(glStencilMaskSeparate(face, mask));
+    }
+
+    bool OpenGLStateCache::GetDepthMask()
+    {
+        if (!mState.depthMask.valid)
+        {
+            GLboolean depthMask;
+            FASTCG_CHECK_OPENGL_CALL(glGetBooleanv(GL_DEPTH_WRITEMASK, &depthMask));
+            mState.depthMask = {depthMask == GL_TRUE, true};
+        }
+        return mState.depthMask.value;
+    }
+
+    void OpenGLStateCache::SetDepthMask(bool depthMask)
+    {
+        if (!Changes(mState.depthMask, depthMask))
+        {
+            return;
+        }
+        FASTCG_CHECK_OPENGL_CALL(glDepthMask(depthMask ? GL_TRUE : GL_FALSE));
+    }
+
+    void OpenGLStateCache::SetDepthFunc(GLenum func)
+    {
+        if (!Changes(mState.depthFunc, func))
+        {
+            return;
+        }
+        FASTCG_CHECK_OPENGL_CALL(glDepthFunc(func));
+    }
+
+    void OpenGLStateCache::SetCullFace(GLenum face)
+    {
+        if (!Changes(mState.cullFace, face))
+        {
+            return;
+        }
+        FASTCG_CHECK_OPENGL_CALL(glCullFace(face));
+    }
+
+    void OpenGLStateCache::SetViewport(GLint x, GLint y, GLsizei width, GLsizei height)
+    {
+        if (!Changes(mState.viewport, {x, y, (GLint)width, (GLint)height}))
+        {
+            return;
+        }
+        FASTCG_CHECK_OPENGL_CALL(glViewport(x, y, width, height));
+    }
+
+    void OpenGLStateCache::SetScissor(GLint x, GLint y, GLsizei width, GLsizei height)
+    {
+        if (!Changes(mState.scissor, {x, y, (GLint)width, (GLint)height}))
+        {
+            return;
+        }
+        FASTCG_CHECK_OPENGL_CALL(glScissor(x, y, width, height));
+    }
+
+    void OpenGLStateCache::UseProgram(GLuint programId)
+    {
+        if (!Changes(mState.program, programId))
+        {
+            return;
+        }
+        FASTCG_CHECK_OPENGL_CALL(glUseProgram(programId));
+    }
+
+    GLuint OpenGLStateCache::GetFramebuffer(GLenum target)
+    {
+        assert(target == GL_DRAW_FRAMEBUFFER || target == GL_READ_FRAMEBUFFER);
+        auto &rFbo = target == GL_DRAW_FRAMEBUFFER ? mState.drawFbo : mState.readFbo;
+        if (!rFbo.valid)
+        {
+            GLint fboId;
+            FASTCG_CHECK_OPENGL_CALL(glGetIntegerv(
+                target == GL_DRAW_FRAMEBUFFER ? GL_DRAW_FRAMEBUFFER_BINDING : GL_READ_FRAMEBUFFER_BINDING, &fboId));
+            rFbo = {(GLuint)fboId, true};
+        }
+        return rFbo.value;
+    }
+
+    bool OpenGLStateCache::BindFramebuffer(GLenum target, GLuint fboId)
+    {
+        assert(target == GL_DRAW_FRAMEBUFFER || target == GL_READ_FRAMEBUFFER);
+        if (!Changes(target == GL_DRAW_FRAMEBUFFER ? mState.drawFbo : mState.readFbo, fboId))
+        {
+            return false;
+        }
+        FASTCG_CHECK_OPENGL_CALL(glBindFramebuffer(target, fboId));
+        return true;
+    }
+
+    void OpenGLStateCache::BindVertexArray(GLuint vaoId)
+    {
+        if (!Changes(mState.vao, vaoId))
+        {
+            return;
+        }
+        FASTCG_CHECK_OPENGL_CALL(glBindVertexArray(vaoId));
+        // the element array buffer binding is part of the VAO state
+        mState.buffers.erase(GL_ELEMENT_ARRAY_BUFFER);
+    }
+
+    void OpenGLStateCache::BindBuffer(GLenum target, GLuint bufferId)
+    {
+        auto it = mState.buffers.find(target);
+        if (it != mState.buffers.end() && it->second == bufferId)
+        {
+            mElidedCallCount++;
+            return;
+        }
+        mState.buffers[target] = bufferId;
+        FASTCG_CHECK_OPENGL_CALL(glBindBuffer(target, bufferId));
+    }
+
+    void OpenGLStateCache::BindBufferRange(GLenum target, GLuint index, GLuint bufferId, GLintptr offset,
+                                           GLsizeiptr size)
+    {
+        std::array<uint64_t, 3> range{(uint64_t)bufferId, (uint64_t)offset, (uint64_t)size};
+        auto key = GetBufferRangeKey(target, index);
+        auto it = mState.bufferRanges.find(key);
+        if (it != mState.bufferRanges.end() && it->second == range)
+        {
+            mElidedCallCount++;
+            return;
+        }
+        mState.bufferRanges[key] = range;
+        // also binds the buffer to the generic binding point
+        mState.buffers[target] = bufferId;
+        FASTCG_CHECK_OPENGL_CALL(glBindBufferRange(target, index, bufferId, offset, size));
+    }
+
+    void OpenGLStateCache::BindTexture(GLuint unit, GLenum target, GLuint textureId)
+    {
+        if (unit >= mState.textures.size())
+        {
+            mState.textures.resize(unit + 1);
+        }
+        if (!Changes(mState.textures[unit], {target, textureId}))
+        {
+            return;
+        }
+        if (Changes(mState.activeTextureUnit, unit))
+        {
+            FASTCG_CHECK_OPENGL_CALL(glActiveTexture(GL_TEXTURE0 + unit));
+        }
+        FASTCG_CHECK_OPENGL_CALL(glBindTexture(target, textureId));
+    }
+
+    void OpenGLStateCache::OnBufferDeleted(GLuint bufferId)
+    {
+        // deleting a buffer resets the bindings to it in the current context
+        for (auto &rEntry : mState.buffers)
+        {
+            if (rEntry.second == bufferId)
+            {
+                rEntry.second = 0;
+            }
+        }
+        for (auto it = mState.bufferRanges.begin(); it != mState.bufferRanges.end();)
+        {
+            if (it->second[0] == (uint64_t)bufferId)
+            {
+                it = mState.bufferRanges.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
+    void OpenGLStateCache::OnTextureDeleted(GLuint textureId)
+    {
+        // deleting a texture reverts the units it's bound to to the default texture
+        for (auto &rTexture : mState.textures)
+        {
+            if (rTexture.valid && rTexture.value.second == textureId)
+            {
+                rTexture.value.second = 0;
+            }
+        }
+    }
+
+    void OpenGLStateCache::OnFramebufferDeleted(GLuint fboId)
+    {
+        // deleting a framebuffer reverts the bindings to it to the default framebuffer
+        if (mState.drawFbo.valid && mState.drawFbo.value == fboId)
+        {
+            mState.drawFbo.value = 0;
+        }
+        if (mState.readFbo.valid && mState.readFbo.value == fboId)
+        {
+            mState.readFbo.value = 0;
+        }
+    }
+
+    void OpenGLStateCache::OnProgramDeleted(GLuint programId)
+    {
+        // a program in use is only flagged for deletion, so just forget about it
+        if (mState.program.valid && mState.program.value == programId)
+        {
+            mState.program.valid = false;
+        }
+    }
+
+    void OpenGLStateCache::OnFrameEnd()
+    {
+        mLastElidedCallCount = mElidedCallCount;
+        mElidedCallCount = 0;
+    }
+
+}
+
+#endif
@@ -1,6 +1,7 @@
 #ifdef FASTCG_OPENGL
 
 #include <FastCG/Graphics/OpenGL/OpenGLErrorHandling.h>
+#include <FastCG/Graphics/OpenGL/OpenGLGraphicsSystem.h>
 #include <FastCG/Graphics/OpenGL/OpenGLTexture.h>
 #include <FastCG/Graphics/OpenGL/OpenGLUtils.h>
 
@@ -12,7 +13,7 @@ namespace FastCG
 
         FASTCG_CHECK_OPENGL_CALL(glGenTextures(1, &mTextureId));
 
-        FASTCG_CHECK_OPENGL_CALL(glBindTexture(glTarget, mTextureId));
+        OpenGLGraphicsSystem::GetInstance()->GetStateCache().BindTexture(0, glTarget, mTextureId);
 #if _DEBUG
         {
             std::string textureLabel = GetName() + " (GL_TEXTURE)";
@@ -170,6 +171,7 @@ namespace FastCG
         if (mTextureId != ~0u)
         {
             glDeleteTextures(1, &mTextureId);
+            OpenGLGraphicsSystem::GetInstance()->GetStateCache().OnTextureDeleted(mTextureId);
         }
     }
 }
@@ -2,6 +2,7 @@
 #include <FastCG/Core/Enums.h>
 #include <FastCG/Core/Log.h>
 #include <FastCG/Core/Macros.h>
+#include <FastCG/Core/ThreadPool.h>
 #include <FastCG/Graphics/GraphicsUtils.h>
 #include <FastCG/Graphics/RenderingPath.h>
 #include <FastCG/Graphics/ShaderImporter.h>
@@ -111,39 +112,61 @@ namespace FastCG
 
         FASTCG_LOG_DEBUG(ShaderImporter, "Importing shaders (%s):", GetRenderingPathString(renderingPath));
 
+        std::vector<const std::pair<const std::string, ShaderInfo> *> entries;
+        entries.reserve(shaderInfos.size());
         for (const auto &rEntry : shaderInfos)
         {
-            const auto &rShaderInfo = rEntry.second;
-            Shader::Args shaderArgs{};
-            shaderArgs.name = rEntry.first;
-            shaderArgs.text = rShaderInfo.text;
-            ShaderTypeValueArray<std::unique_ptr<uint8_t[]>> programsData;
+            entries.emplace_back(&rEntry);
+
             for (ShaderTypeInt i = 0; i < (ShaderTypeInt)ShaderType::LAST; ++i)
             {
-                if (rShaderInfo.programFilePaths[i].empty())
+                if (!rEntry.second.programFilePaths[i].empty())
                 {
-                    continue;
+                    FASTCG_LOG_DEBUG(ShaderImporter, "- %s [%s] (%s)", rEntry.first.c_str(), ShaderType_STRINGS[i],
+                                     rEntry.second.text ? "t" : "b");
                 }
+            }
+        }
 
-                FASTCG_LOG_DEBUG(ShaderImporter, "- %s [%s] (%s)", shaderArgs.name.c_str(), ShaderType_STRINGS[i],
-                                 shaderArgs.text ? "t" : "b");
-
-                if (shaderArgs.text)
-                {
-                    auto programSource = ShaderSource::ParseFile(rShaderInfo.programFilePaths[i]);
-                    shaderArgs.programsData[i].dataSize = programSource.size() + 1;
-                    programsData[i] = std::make_unique<uint8_t[]>(shaderArgs.programsData[i].dataSize);
-                    std::copy(programSource.cbegin(), programSource.cend(), (char *)programsData[i].get());
-                    programsData[i][shaderArgs.programsData[i].dataSize - 1] = '\0';
-                }
-                else
+        // reading and parsing (i.e., expanding the includes of) the shader files is independent from the graphics
+        // backend, so it's done on all cores. shaders are then created in a single batch, which lets the backend
+        // overlap their compilation
+        std::vector<Shader::Args> shadersArgs(entries.size());
+        std::vector<ShaderTypeValueArray<std::unique_ptr<uint8_t[]>>> programsData(entries.size());
+        {
+            auto *pThreadPool = GraphicsSystem::GetInstance()->GetThreadPool();
+            pThreadPool->ParallelFor(entries.size(), [&](size_t shaderIdx, uint32_t threadIdx) {
+                FASTCG_UNUSED(threadIdx);
+                const auto &rShaderInfo = entries[shaderIdx]->second;
+                auto &rShaderArgs = shadersArgs[shaderIdx];
+                auto &rProgramsData = programsData[shaderIdx];
+                rShaderArgs.name = entries[shaderIdx]->first;
+                rShaderArgs.text = rShaderInfo.text;
+                for (ShaderTypeInt i = 0; i < (ShaderTypeInt)ShaderType::LAST; ++i)
                 {
-                    programsData[i] =
-                        FileReader::ReadBinary(rShaderInfo.programFilePaths[i], shaderArgs.programsData[i].dataSize);
+                    if (rShaderInfo.programFilePaths[i].empty())
+                    {
+                        continue;
+                    }
+
+                    if (rShaderArgs.text)
+                    {
+                        auto programSource = ShaderSource::ParseFile(rShaderInfo.programFilePaths[i]);
+                        rShaderArgs.programsData[i].dataSize = programSource.size() + 1;
+                        rProgramsData[i] = std::make_unique<uint8_t[]>(rShaderArgs.programsData[i].dataSize);
+                        std::copy(programSource.cbegin(), programSource.cend(), (char *)rProgramsData[i].get());
+                        rProgramsData[i][rShaderArgs.programsData[i].dataSize - 1] = '\0';
+                    }
+                    else
+                    {
+                        rProgramsData[i] = FileReader::ReadBinary(rShaderInfo.programFilePaths[i],
+                                                                  rShaderArgs.programsData[i].dataSize);
+                    }
+                    rShaderArgs.programsData[i].pData = (void *)rProgramsData[i].get();
                 }
-                shaderArgs.programsData[i].pData = (void *)programsData[i].get();
-            }
-            GraphicsSystem::GetInstance()->CreateShader(shaderArgs);
+            });
         }
+
+        GraphicsSystem::GetInstance()->CreateShaders(shadersArgs);
     }
 }
@@ -27,9 +27,20 @@ namespace FastCG
         bufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
         bufferCreateInfo.pNext = nullptr;
         bufferCreateInfo.flags = 0;
-        bufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-        bufferCreateInfo.queueFamilyIndexCount = 0;
-        bufferCreateInfo.pQueueFamilyIndices = nullptr;
+        // shared with the dedicated queues (if any) instead of transferring ownership between them
+        const auto &rQueueFamilyIndices = VulkanGraphicsSystem::GetInstance()->GetQueueFamilyIndices();
+        if (rQueueFamilyIndices.size() > 1)
+        {
+            bufferCreateInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+            bufferCreateInfo.queueFamilyIndexCount = (uint32_t)rQueueFamilyIndices.size();
+            bufferCreateInfo.pQueueFamilyIndices = &rQueueFamilyIndices[0];
+        }
+        else
+        {
+            bufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+            bufferCreateInfo.queueFamilyIndexCount = 0;
+            bufferCreateInfo.pQueueFamilyIndices = nullptr;
+        }
         bufferCreateInfo.usage = GetVkBufferUsageFlags(GetUsage());
         bufferCreateInfo.size = GetDataSize();
 
@@ -41,7 +52,8 @@ namespace FastCG
             VmaAllocationCreateInfo allocationCreateInfo;
             if (UsesMappableMemory())
             {
-                allocationCreateInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT;
+                allocationCreateInfo.flags =
+                    VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
             }
             else
             {
@@ -58,9 +70,21 @@ namespace FastCG
                                                    &bufferCreateInfo, &allocationCreateInfo, &mFrameData[i].buffer,
                                                    &mFrameData[i].allocation, &mFrameData[i].allocationInfo));
 
+            if (UsesMappableMemory())
+            {
+                VkMemoryPropertyFlags memPropFlags;
+                vmaGetAllocationMemoryProperties(VulkanGraphicsSystem::GetInstance()->GetAllocator(),
+                                                 mFrameData[i].allocation, &memPropFlags);
+                mFrameData[i].hostCoherent = (memPropFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) != 0;
+            }
+            else
+            {
+                mFrameData[i].hostCoherent = false;
+            }
+
             if (GetData() != nullptr)
             {
-                pGraphicsContext->Copy(this, GetData(), i, GetDataSize());
+                pGraphicsContext->Copy(this, GetData(), i, 0, GetDataSize());
             }
 
 #if _DEBUG
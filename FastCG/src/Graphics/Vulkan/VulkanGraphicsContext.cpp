@@ -26,8 +26,73 @@ namespace FastCG
         return pBuffer->GetFrameData(frameIndex).buffer;
     }
 
+    // whether two pipeline layouts would result in the same descriptor writes (dynamic offsets aside)
+    bool HasSameDescriptors(const VulkanPipelineLayoutDescription &rLayoutDescription,
+                            const VulkanPipelineLayout &rPipelineLayout0, const VulkanPipelineLayout &rPipelineLayout1)
+    {
+        for (uint32_t i = 0; i < rLayoutDescription.setLayoutCount; ++i)
+        {
+            const auto &rSetLayout = rLayoutDescription.pSetLayouts[i];
+            const auto &rSet0 = rPipelineLayout0.pSet[i];
+            const auto &rSet1 = rPipelineLayout1.pSet[i];
+            for (uint32_t j = 0; j < rSetLayout.bindingLayoutCount; ++j)
+            {
+                const auto &rBindingLayout = rSetLayout.pBindingLayouts[j];
+                auto binding = rBindingLayout.binding;
+                auto *pBinding0 = rSet0.bindingCount > binding ? &rSet0.pBindings[binding] : nullptr;
+                auto *pBinding1 = rSet1.bindingCount > binding ? &rSet1.pBindings[binding] : nullptr;
+                if (pBinding0 == nullptr || pBinding1 == nullptr)
+                {
+                    if (pBinding0 != pBinding1)
+                    {
+                        return false;
+                    }
+                    continue;
+                }
+                if (pBinding0->pBuffer != pBinding1->pBuffer || pBinding0->size != pBinding1->size ||
+                    (rBindingLayout.type != VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC &&
+                     pBinding0->offset != pBinding1->offset))
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    // drops the stages and accesses a queue without graphics support doesn't understand
+    void FilterVkBarrierMasks(QueueType queueType, VkAccessFlags &rAccessMask, VkPipelineStageFlags &rStageMask)
+    {
+        VkPipelineStageFlags supportedStageMask = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT |
+                                                  VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT |
+                                                  VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_HOST_BIT |
+                                                  VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+        VkAccessFlags supportedAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT |
+                                            VK_ACCESS_HOST_READ_BIT | VK_ACCESS_HOST_WRITE_BIT |
+                                            VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+        switch (queueType)
+        {
+        case QueueType::GRAPHICS:
+            return;
+        case QueueType::COMPUTE:
+            supportedStageMask |= VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+            supportedAccessMask |= VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_UNIFORM_READ_BIT |
+                                   VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+            break;
+        default:
+            break;
+        }
+        if ((rStageMask & ~supportedStageMask) != 0)
+        {
+            rStageMask = (rStageMask & supportedStageMask) | VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+        }
+        rAccessMask &= supportedAccessMask;
+    }
+
     VulkanGraphicsContext::VulkanGraphicsContext(const Args &rArgs)
-        : BaseGraphicsContext<VulkanBuffer, VulkanShader, VulkanTexture>(rArgs)
+        : BaseGraphicsContext<VulkanBuffer, VulkanShader, VulkanTexture>(rArgs),
+          mQueueType(VulkanGraphicsSystem::GetInstance()->HasDedicatedQueue(rArgs.queueType) ? rArgs.queueType
+                                                                                               : QueueType::GRAPHICS)
     {
 #if !defined FASTCG_DISABLE_GPU_TIMING
         InitializeTimeElapsedData();
@@ -48,10 +113,14 @@ namespace FastCG
         {
             InitializeTimeElapsedData();
         }
-        mTimeElapsedQueries[VulkanGraphicsSystem::GetInstance()->GetCurrentFrame()] = {
-            VulkanGraphicsSystem::GetInstance()->NextQuery(), VulkanGraphicsSystem::GetInstance()->NextQuery()};
-        EnqueueTimestampQuery(mTimeElapsedQueries[VulkanGraphicsSystem::GetInstance()->GetCurrentFrame()].start,
-                              VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT);
+        // the query pool is reset on the graphics queue, after the dedicated queues are submitted
+        if (mQueueType == QueueType::GRAPHICS)
+        {
+            mTimeElapsedQueries[VulkanGraphicsSystem::GetInstance()->GetCurrentFrame()] = {
+                VulkanGraphicsSystem::GetInstance()->NextQuery(), VulkanGraphicsSystem::GetInstance()->NextQuery()};
+            EnqueueTimestampQuery(mTimeElapsedQueries[VulkanGraphicsSystem::GetInstance()->GetCurrentFrame()].start,
+                                  VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT);
+        }
         mElapsedTimes[VulkanGraphicsSystem::GetInstance()->GetCurrentFrame()] = 0;
 #endif
         mEnded = false;
@@ -180,6 +249,11 @@ namespace FastCG
     }
 
     void VulkanGraphicsContext::Copy(const VulkanBuffer *pDst, const void *pSrc, size_t size)
+    {
+        Copy(pDst, pSrc, 0, size);
+    }
+
+    void VulkanGraphicsContext::Copy(const VulkanBuffer *pDst, const void *pSrc, size_t offset, size_t size)
     {
         assert(pDst != nullptr);
         uint32_t frameIndex;
@@ -191,50 +265,55 @@ namespace FastCG
         {
             frameIndex = 0;
         }
-        Copy(pDst, pSrc, frameIndex, size);
+        Copy(pDst, pSrc, frameIndex, offset, size);
     }
 
-    void VulkanGraphicsContext::Copy(const VulkanBuffer *pDst, const void *pSrc, uint32_t frameIndex, size_t size)
+    void VulkanGraphicsContext::Copy(const VulkanBuffer *pDst, const void *pSrc, uint32_t frameIndex, size_t offset,
+                                     size_t size)
     {
         assert(pDst != nullptr);
         assert(pSrc != nullptr);
         assert(size > 0);
+        assert(offset + size <= pDst->GetDataSize());
 
         auto &rBufferFrameData = pDst->GetFrameData(frameIndex);
         assert(rBufferFrameData.allocation != VK_NULL_HANDLE);
 
         if (pDst->UsesMappableMemory())
         {
-            void *pMappedDst;
-            FASTCG_CHECK_VK_RESULT(vmaMapMemory(VulkanGraphicsSystem::GetInstance()->GetAllocator(),
-                                                rBufferFrameData.allocation, &pMappedDst));
-            std::memcpy(pMappedDst, pSrc, size);
-            vmaUnmapMemory(VulkanGraphicsSystem::GetInstance()->GetAllocator(), rBufferFrameData.allocation);
-
-            VkMemoryPropertyFlags memPropFlags;
-            vmaGetAllocationMemoryProperties(VulkanGraphicsSystem::GetInstance()->GetAllocator(),
-                                             rBufferFrameData.allocation, &memPropFlags);
-            if ((memPropFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) == 0)
+            assert(rBufferFrameData.allocationInfo.pMappedData != nullptr);
+            std::memcpy((char *)rBufferFrameData.allocationInfo.pMappedData + offset, pSrc, size);
+            if (!rBufferFrameData.hostCoherent)
             {
                 FASTCG_CHECK_VK_RESULT(vmaFlushAllocation(VulkanGraphicsSystem::GetInstance()->GetAllocator(),
-                                                          rBufferFrameData.allocation, 0, size));
+                                                          rBufferFrameData.allocation, offset, size));
             }
         }
         else
         {
-            auto *pStagingBuffer = VulkanGraphicsSystem::GetInstance()->CreateBuffer(
-                {"Staging Buffer for " + pDst->GetName() +
-                     (frameIndex > 0 ? " (" + std::to_string(frameIndex) + ")" : ""),
-                 BufferUsageFlagBit::DYNAMIC,
-                 size,
-                 pSrc,
-                 {},
-                 true});
-
-            EnqueueCopyCommand(CopyCommandType::BUFFER_TO_BUFFER,
-                               CopyCommandArgs{{pStagingBuffer, 0}, {pDst, frameIndex}});
-
-            VulkanGraphicsSystem::GetInstance()->DestroyBuffer(pStagingBuffer);
+            CopyCommandArgs::BufferData stagingBufferData;
+            if (StageData(pSrc, size, 1, stagingBufferData))
+            {
+                EnqueueCopyCommand(CopyCommandType::BUFFER_TO_BUFFER,
+                                   CopyCommandArgs{stagingBufferData, {pDst, frameIndex, offset}});
+            }
+            else
+            {
+                // doesn't fit in the staging ring, fallback to a one-off staging buffer
+                auto *pStagingBuffer = VulkanGraphicsSystem::GetInstance()->CreateBuffer(
+                    {"Staging Buffer for " + pDst->GetName() +
+                         (frameIndex > 0 ? " (" + std::to_string(frameIndex) + ")" : ""),
+                     BufferUsageFlagBit::DYNAMIC,
+                     size,
+                     pSrc,
+                     {},
+                     true});
+
+                EnqueueCopyCommand(CopyCommandType::BUFFER_TO_BUFFER,
+                                   CopyCommandArgs{{pStagingBuffer, 0, 0, size}, {pDst, frameIndex, offset}});
+
+                VulkanGraphicsSystem::GetInstance()->DestroyBuffer(pStagingBuffer);
+            }
         }
     }
 
@@ -264,12 +343,23 @@ namespace FastCG
         }
         else
         {
-            auto *pStagingBuffer = VulkanGraphicsSystem::GetInstance()->CreateBuffer(
-                {"Staging Buffer for " + pDst->GetName(), BufferUsageFlagBit::DYNAMIC, size, pSrc, {}, true});
+            CopyCommandArgs::BufferData stagingBufferData;
+            // the buffer offset of a copy into an image has to be a multiple of the texel block size
+            if (StageData(pSrc, size, GetBytesPerBlock(pDst->GetFormat()), stagingBufferData))
+            {
+                EnqueueCopyCommand(CopyCommandType::BUFFER_TO_IMAGE, CopyCommandArgs{stagingBufferData, {pDst}});
+            }
+            else
+            {
+                // doesn't fit in the staging ring, fallback to a one-off staging buffer
+                auto *pStagingBuffer = VulkanGraphicsSystem::GetInstance()->CreateBuffer(
+                    {"Staging Buffer for " + pDst->GetName(), BufferUsageFlagBit::DYNAMIC, size, pSrc, {}, true});
 
-            EnqueueCopyCommand(CopyCommandType::BUFFER_TO_IMAGE, CopyCommandArgs{{pStagingBuffer, 0}, {pDst}});
+                EnqueueCopyCommand(CopyCommandType::BUFFER_TO_IMAGE,
+                                   CopyCommandArgs{{pStagingBuffer, 0, 0, size}, {pDst}});
 
-            VulkanGraphicsSystem::GetInstance()->DestroyBuffer(pStagingBuffer);
+                VulkanGraphicsSystem::GetInstance()->DestroyBuffer(pStagingBuffer);
+            }
         }
     }
 
@@ -300,21 +390,14 @@ namespace FastCG
 
         if (pSrc->UsesMappableMemory())
         {
-            void *pMappedData;
-            FASTCG_CHECK_VK_RESULT(vmaMapMemory(VulkanGraphicsSystem::GetInstance()->GetAllocator(),
-                                                rBufferFrameData.allocation, &pMappedData));
-            pMappedData = (void *)((char *)pMappedData + offset);
-            std::memcpy(pDst, pMappedData, size);
-            vmaUnmapMemory(VulkanGraphicsSystem::GetInstance()->GetAllocator(), rBufferFrameData.allocation);
-
-            VkMemoryPropertyFlags memPropFlags;
-            vmaGetAllocationMemoryProperties(VulkanGraphicsSystem::GetInstance()->GetAllocator(),
-                                             rBufferFrameData.allocation, &memPropFlags);
-            if ((memPropFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) == 0)
+            assert(rBufferFrameData.allocationInfo.pMappedData != nullptr);
+            // make device writes visible before reading them
+            if (!rBufferFrameData.hostCoherent)
             {
                 FASTCG_CHECK_VK_RESULT(vmaInvalidateAllocation(VulkanGraphicsSystem::GetInstance()->GetAllocator(),
-                                                               rBufferFrameData.allocation, 0, VK_WHOLE_SIZE));
+                                                               rBufferFrameData.allocation, offset, size));
             }
+            std::memcpy(pDst, (const char *)rBufferFrameData.allocationInfo.pMappedData + offset, size);
         }
         else
         {
@@ -325,6 +408,9 @@ namespace FastCG
     void VulkanGraphicsContext::AddMemoryBarrier()
     {
         mAddMemoryBarrier = true;
+        // barriers are resolved before each pass batch, so dispatches that read the results of previous ones must
+        // go into a new one
+        mNewComputePassBatch = true;
     }
 
     void VulkanGraphicsContext::BindShader(const VulkanShader *pShader)
@@ -339,12 +425,19 @@ namespace FastCG
         mPipelineLayout.setCount = 0;
     }
 
-    void VulkanGraphicsContext::BindResource(const VulkanBuffer *pBuffer, const char *pName)
+    void VulkanGraphicsContext::BindResource(const VulkanBuffer *pBuffer, ShaderResourceId id)
     {
         assert(pBuffer != nullptr);
-        assert(pName != nullptr);
+        BindResource(pBuffer, 0, pBuffer->GetDataSize(), id);
+    }
+
+    void VulkanGraphicsContext::BindResource(const VulkanBuffer *pBuffer, size_t offset, size_t size,
+                                             ShaderResourceId id)
+    {
+        assert(pBuffer != nullptr);
+        assert(offset + size <= pBuffer->GetDataSize());
         assert(mPipelineDescription.pShader != nullptr);
-        auto location = mPipelineDescription.pShader->GetResourceLocation(pName);
+        auto location = mPipelineDescription.pShader->GetResourceLocation(id);
         if (location.set == ~0u && location.binding == ~0u)
         {
             return;
@@ -368,13 +461,14 @@ namespace FastCG
         }
         auto &rBinding = rDescriptorSet.pBindings[location.binding];
         rBinding.pBuffer = pBuffer;
+        rBinding.offset = (uint32_t)offset;
+        rBinding.size = (uint32_t)size;
     }
 
-    void VulkanGraphicsContext::BindResource(const VulkanTexture *pTexture, const char *pName)
+    void VulkanGraphicsContext::BindResource(const VulkanTexture *pTexture, ShaderResourceId id)
     {
-        assert(pName != nullptr);
         assert(mPipelineDescription.pShader != nullptr);
-        auto location = mPipelineDescription.pShader->GetResourceLocation(pName);
+        auto location = mPipelineDescription.pShader->GetResourceLocation(id);
         if (location.set == ~0u && location.binding == ~0u)
         {
             return;
@@ -398,12 +492,15 @@ namespace FastCG
         }
         auto &rBinding = rDescriptorSet.pBindings[location.binding];
         rBinding.pTexture = pTexture;
+        rBinding.offset = 0;
+        rBinding.size = 0;
     }
 
     void VulkanGraphicsContext::Blit(const VulkanTexture *pSrc, const VulkanTexture *pDst)
     {
         assert(pSrc != nullptr);
         assert(pDst != nullptr);
+        assert(mQueueType == QueueType::GRAPHICS);
         EnqueueCopyCommand(CopyCommandType::BLIT, CopyCommandArgs{{pSrc}, {pDst}});
     }
 
@@ -451,6 +548,8 @@ namespace FastCG
         if (mNoDrawSinceLastRenderTargetsSet &&
             (mRenderPassDescription.renderTargetCount > 0 || mRenderPassDescription.pDepthStencilBuffer != nullptr))
         {
+            // clears need a graphics or compute queue
+            assert(mQueueType != QueueType::TRANSFER);
             for (uint32_t i = 0; i < mRenderPassDescription.renderTargetCount; ++i)
             {
                 const auto &rClearRequest = mRenderPassDescription.colorClearRequests[i];
@@ -473,6 +572,8 @@ namespace FastCG
             if (mRenderPassDescription.pDepthStencilBuffer != nullptr &&
                 mRenderPassDescription.depthStencilClearRequest.flags != VulkanClearRequestFlagBit::NONE)
             {
+                // vkCmdClearDepthStencilImage is only supported by graphics queues
+                assert(mQueueType == QueueType::GRAPHICS);
                 mClearCommands.emplace_back(ClearCommand {
 #if _DEBUG
                     mMarkerCommands.size(),
@@ -527,11 +628,54 @@ namespace FastCG
                            indexCount, vertexOffset);
     }
 
+    void VulkanGraphicsContext::DrawIndexedIndirect(PrimitiveType primitiveType, const VulkanBuffer *pIndirectBuffer,
+                                                    size_t offset)
+    {
+        MultiDrawIndexedIndirect(primitiveType, pIndirectBuffer, offset, 1,
+                                 (uint32_t)sizeof(DrawIndexedIndirectCommand));
+    }
+
+    void VulkanGraphicsContext::MultiDrawIndexedIndirect(PrimitiveType primitiveType,
+                                                         const VulkanBuffer *pIndirectBuffer, size_t offset,
+                                                         uint32_t drawCount, uint32_t stride)
+    {
+        assert(pIndirectBuffer != nullptr);
+        assert((pIndirectBuffer->GetUsage() & BufferUsageFlagBit::INDIRECT) != 0);
+        assert(drawCount > 0);
+        assert(offset % 4 == 0);
+        stride = stride == 0 ? (uint32_t)sizeof(DrawIndexedIndirectCommand) : stride;
+        assert(stride % 4 == 0 && stride >= sizeof(DrawIndexedIndirectCommand));
+        auto *pInvokeCommand = EnqueueDrawCommand(DrawCommandType::INDEXED_INDIRECT, primitiveType, 0, 0, 0, 0, 0);
+        if (pInvokeCommand == nullptr)
+        {
+            return;
+        }
+        auto &rDrawInfo = pInvokeCommand->drawInfo;
+        rDrawInfo.indirectBuffer = GetCurrentVkBuffer(pIndirectBuffer);
+        rDrawInfo.indirectOffset = (VkDeviceSize)offset;
+        rDrawInfo.drawCount = drawCount;
+        rDrawInfo.stride = stride;
+    }
+
     void VulkanGraphicsContext::Dispatch(uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ)
     {
+        assert(mQueueType != QueueType::TRANSFER);
         EnqueueDispatchCommand(groupCountX, groupCountY, groupCountZ);
     }
 
+    bool VulkanGraphicsContext::StageData(const void *pSrc, size_t size, size_t alignment,
+                                          CopyCommandArgs::BufferData &rStagingBufferData)
+    {
+        size_t offset;
+        if (!VulkanGraphicsSystem::GetInstance()->CopyToStagingRing(pSrc, size, alignment, offset))
+        {
+            return false;
+        }
+        rStagingBufferData = {VulkanGraphicsSystem::GetInstance()->GetStagingRing(),
+                              VulkanGraphicsSystem::GetInstance()->GetCurrentFrame(), offset, size};
+        return true;
+    }
+
     void VulkanGraphicsContext::EnqueueCopyCommand(CopyCommandType type, const CopyCommandArgs &rArgs)
     {
         mCopyCommands.emplace_back(CopyCommand {
@@ -542,43 +686,68 @@ namespace FastCG
         });
     }
 
-    void VulkanGraphicsContext::EnqueueDrawCommand(DrawCommandType type, PrimitiveType primitiveType,
-                                                   uint32_t firstInstance, uint32_t instanceCount, uint32_t firstIndex,
-                                                   uint32_t indexCount, int32_t vertexOffset)
+    VulkanGraphicsContext::InvokeCommand *VulkanGraphicsContext::EnqueueDrawCommand(
+        DrawCommandType type, PrimitiveType primitiveType, uint32_t firstInstance, uint32_t instanceCount,
+        uint32_t firstIndex, uint32_t indexCount, int32_t vertexOffset)
     {
+        assert(mQueueType == QueueType::GRAPHICS);
         assert(mPipelineDescription.pShader != nullptr);
 
-        auto &rFragmentOutputDescription = mPipelineDescription.pShader->GetOutputDescription();
-        auto renderPassDescription = mRenderPassDescription;
-        for (size_t i = 0; i < renderPassDescription.renderTargetCount; ++i)
-        {
-            auto it = rFragmentOutputDescription.find((uint32_t)i);
-            if (it == rFragmentOutputDescription.end())
-            {
-                renderPassDescription.ppRenderTargets[i] = nullptr;
-            }
-        }
-
-        bool depthWrite = mPipelineDescription.graphicsInfo.depthWrite;
-        bool stencilWrite = mPipelineDescription.graphicsInfo.stencilTest &&
-                            (mPipelineDescription.graphicsInfo.stencilBackState.writeMask != 0 ||
-                             mPipelineDescription.graphicsInfo.stencilFrontState.writeMask != 0);
+        VulkanRenderPassDescription renderPassDescription;
+        bool depthWrite, stencilWrite;
+        uint32_t renderTargetCount;
+        VulkanGraphicsSystem::GetDrawRenderPassDescription(mPipelineDescription, mRenderPassDescription,
+                                                           renderPassDescription, depthWrite, stencilWrite,
+                                                           renderTargetCount);
 
         auto renderPass = VulkanGraphicsSystem::GetInstance()
                               ->GetOrCreateRenderPass(renderPassDescription, depthWrite, stencilWrite)
                               .second;
         assert(renderPass != VK_NULL_HANDLE);
 
+        // pipelines only need a compatible render pass, so they're shared by load/store op variants
+        auto compatibleRenderPass = VulkanGraphicsSystem::GetInstance()->GetOrCreateCompatibleRenderPass(
+            renderPassDescription, depthWrite, stencilWrite);
+        auto pipeline =
+            VulkanGraphicsSystem::GetInstance()
+                ->GetOrCreateGraphicsPipeline(mPipelineDescription, compatibleRenderPass, renderTargetCount)
+                .second;
+        if (pipeline.pipeline == VK_NULL_HANDLE)
+        {
+            // still being compiled in the background (see VulkanGraphicsSystem::PrewarmGraphicsPipelines())
+            return nullptr;
+        }
+
         auto frameBuffer = VulkanGraphicsSystem::GetInstance()
                                ->GetOrCreateFrameBuffer(renderPassDescription, depthWrite, stencilWrite)
                                .second;
         assert(frameBuffer != VK_NULL_HANDLE);
 
+        // imageless frame buffers are shared by render targets alike
+        auto HasSameRenderTargets = [&renderPassDescription](const PassBatch &rPassBatch) {
+            uint32_t renderTargetCount = 0;
+            for (uint32_t i = 0; i < renderPassDescription.renderTargetCount; ++i)
+            {
+                auto *pRenderTarget = renderPassDescription.ppRenderTargets[i];
+                if (pRenderTarget == nullptr)
+                {
+                    continue;
+                }
+                if (renderTargetCount == rPassBatch.renderInfo.renderTargetCount ||
+                    rPassBatch.renderInfo.ppRenderTargets[renderTargetCount++] != pRenderTarget)
+                {
+                    return false;
+                }
+            }
+            return renderTargetCount == rPassBatch.renderInfo.renderTargetCount &&
+                   rPassBatch.renderInfo.pDepthStencilBuffer == renderPassDescription.pDepthStencilBuffer;
+        };
+
         auto newPassBatch = false;
         PassBatch *pPassBatch;
         if (mPassBatches.empty() || mPassBatches.back().type != PassType::RENDER ||
             mPassBatches.back().renderInfo.frameBuffer != frameBuffer ||
-            mPassBatches.back().renderInfo.renderPass != renderPass)
+            mPassBatches.back().renderInfo.renderPass != renderPass || !HasSameRenderTargets(mPassBatches.back()))
         {
             mPassBatches.emplace_back();
             pPassBatch = &mPassBatches.back();
@@ -645,23 +814,6 @@ namespace FastCG
             pPassBatch = &mPassBatches.back();
         }
 
-        uint32_t renderTargetCount = 0;
-        for (uint32_t i = 0; i < renderPassDescription.renderTargetCount; ++i)
-        {
-            auto *pRenderTarget = renderPassDescription.ppRenderTargets[i];
-            if (pRenderTarget == nullptr)
-            {
-                continue;
-            }
-
-            renderTargetCount++;
-        }
-
-        auto pipeline = VulkanGraphicsSystem::GetInstance()
-                            ->GetOrCreateGraphicsPipeline(mPipelineDescription, renderPass, renderTargetCount)
-                            .second;
-        assert(pipeline.pipeline != VK_NULL_HANDLE);
-
         PipelineBatch *pPipelineBatch;
         if (mPipelineBatches.empty() || newPassBatch || mPipelineBatches.back().pipeline.pipeline != pipeline.pipeline)
         {
@@ -691,6 +843,7 @@ namespace FastCG
         pInvokeCommand->lastMarkerCommandIdx = mMarkerCommands.size();
 #endif
 
+        pInvokeCommand->drawInfo.type = type;
         pInvokeCommand->drawInfo.primitiveType = primitiveType;
         pInvokeCommand->drawInfo.firstInstance = firstInstance;
         pInvokeCommand->drawInfo.instanceCount = instanceCount;
@@ -721,8 +874,14 @@ namespace FastCG
                 GetCurrentVkBuffer(mPipelineDescription.graphicsInfo.ppVertexBuffers[i]);
         }
         pInvokeCommand->drawInfo.indexBuffer = GetCurrentVkBuffer(mPipelineDescription.graphicsInfo.pIndexBuffer);
+        pInvokeCommand->drawInfo.indirectBuffer = VK_NULL_HANDLE;
+        pInvokeCommand->drawInfo.indirectOffset = 0;
+        pInvokeCommand->drawInfo.drawCount = 0;
+        pInvokeCommand->drawInfo.stride = 0;
 
         mNoDrawSinceLastRenderTargetsSet = false;
+
+        return pInvokeCommand;
     }
 
     void VulkanGraphicsContext::EnqueueDispatchCommand(uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ)
@@ -733,11 +892,12 @@ namespace FastCG
         assert(mPipelineDescription.pShader != nullptr);
 
         PassBatch *pPassBatch;
-        if (mPassBatches.empty() || mPassBatches.back().type != PassType::COMPUTE)
+        if (mPassBatches.empty() || mPassBatches.back().type != PassType::COMPUTE || mNewComputePassBatch)
         {
             mPassBatches.emplace_back();
             pPassBatch = &mPassBatches.back();
             pPassBatch->type = PassType::COMPUTE;
+            mNewComputePassBatch = false;
         }
         else
         {
@@ -788,6 +948,8 @@ namespace FastCG
         // TODO: make this less brittle and possibly dynamic
         constexpr size_t MAX_WRITES = 128;
         constexpr size_t MAX_RESOURCES = MAX_WRITES;
+        // passes with fewer invokes per recording thread are recorded inline
+        constexpr size_t MIN_INVOKES_PER_SECONDARY_COMMAND_BUFFER = 64;
 
         VkWriteDescriptorSet pSetWrites[MAX_WRITES];
         VkDescriptorImageInfo pImageInfos[MAX_RESOURCES];
@@ -803,11 +965,11 @@ namespace FastCG
                 {
                 case MarkerCommandType::PUSH:
                     VulkanGraphicsSystem::GetInstance()->PushDebugMarker(
-                        VulkanGraphicsSystem::GetInstance()->GetCurrentCommandBuffer(), rMarkerCommand.name.c_str());
+                        GetCommandBuffer(), rMarkerCommand.name.c_str());
                     break;
                 case MarkerCommandType::POP:
                     VulkanGraphicsSystem::GetInstance()->PopDebugMarker(
-                        VulkanGraphicsSystem::GetInstance()->GetCurrentCommandBuffer());
+                        GetCommandBuffer());
                     break;
                 default:
                     FASTCG_THROW_EXCEPTION(Exception, "Vulkan: Unhandled marker command type %d",
@@ -865,7 +1027,7 @@ namespace FastCG
                         subresourceRange.aspectMask |= VK_IMAGE_ASPECT_STENCIL_BIT;
                     }
 
-                    vkCmdClearDepthStencilImage(VulkanGraphicsSystem::GetInstance()->GetCurrentCommandBuffer(),
+                    vkCmdClearDepthStencilImage(GetCommandBuffer(),
                                                 pTexture->GetImage(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
                                                 &rClearRequest.value.depthStencil, 1, &subresourceRange);
                 }
@@ -874,7 +1036,7 @@ namespace FastCG
                     assert((rClearRequest.flags & VulkanClearRequestFlagBit::COLOR_OR_DEPTH) != 0);
 
                     subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-                    vkCmdClearColorImage(VulkanGraphicsSystem::GetInstance()->GetCurrentCommandBuffer(),
+                    vkCmdClearColorImage(GetCommandBuffer(),
                                          pTexture->GetImage(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
                                          &rClearRequest.value.color, 1, &subresourceRange);
                 }
@@ -904,9 +1066,9 @@ namespace FastCG
                                        rCopyCommand.args.srcBufferData.pBuffer->GetName().c_str(),
                                        rCopyCommand.args.dstBufferData.pBuffer->GetName().c_str());
                     VkBufferCopy copyRegion;
-                    copyRegion.srcOffset = 0;
-                    copyRegion.dstOffset = 0;
-                    copyRegion.size = rCopyCommand.args.srcBufferData.pBuffer->GetDataSize();
+                    copyRegion.srcOffset = (VkDeviceSize)rCopyCommand.args.srcBufferData.offset;
+                    copyRegion.dstOffset = (VkDeviceSize)rCopyCommand.args.dstBufferData.offset;
+                    copyRegion.size = (VkDeviceSize)rCopyCommand.args.srcBufferData.size;
                     auto &rSrcBufferFrameData = rCopyCommand.args.srcBufferData.pBuffer->GetFrameData(
                         rCopyCommand.args.srcBufferData.frameIndex);
                     auto &rDstBufferFrameData = rCopyCommand.args.dstBufferData.pBuffer->GetFrameData(
@@ -926,7 +1088,7 @@ namespace FastCG
                     AddBufferMemoryBarrier(rDstBufferFrameData.buffer, lastBufferMemoryBarrier.stageMask,
                                            VK_ACCESS_TRANSFER_WRITE_BIT, lastBufferMemoryBarrier.stageMask,
                                            VK_PIPELINE_STAGE_TRANSFER_BIT);
-                    vkCmdCopyBuffer(VulkanGraphicsSystem::GetInstance()->GetCurrentCommandBuffer(),
+                    vkCmdCopyBuffer(GetCommandBuffer(),
                                     rSrcBufferFrameData.buffer, rDstBufferFrameData.buffer, 1, &copyRegion);
                 }
                 break;
@@ -963,7 +1125,7 @@ namespace FastCG
                     if (pDstTexture->GetMipCount() > 1)
                     {
                         // 1D/2D potentially mipped textures
-                        size_t dataOffset = 0;
+                        size_t dataOffset = rCopyCommand.args.srcBufferData.offset;
                         bufferCopyRegions.resize(pDstTexture->GetMipCount());
                         for (uint8_t mip = 0; mip < pDstTexture->GetMipCount(); ++mip)
                         {
@@ -984,7 +1146,7 @@ namespace FastCG
                     else if (pDstTexture->GetSlices() > 1)
                     {
                         // 2D array/cubemap textures
-                        size_t dataOffset = 0;
+                        size_t dataOffset = rCopyCommand.args.srcBufferData.offset;
                         bufferCopyRegions.resize(pDstTexture->GetSlices());
                         for (uint32_t slice = 0; slice < pDstTexture->GetSlices(); ++slice)
                         {
@@ -1007,7 +1169,7 @@ namespace FastCG
                         // 3D textures
                         bufferCopyRegions.emplace_back(VkBufferImageCopy{});
                         auto &rBufferCopyRegion = bufferCopyRegions.back();
-                        rBufferCopyRegion.bufferOffset = 0;
+                        rBufferCopyRegion.bufferOffset = (VkDeviceSize)rCopyCommand.args.srcBufferData.offset;
                         rBufferCopyRegion.bufferRowLength = 0;
                         rBufferCopyRegion.bufferImageHeight = 0;
                         rBufferCopyRegion.imageSubresource.aspectMask = pDstTexture->GetAspectFlags();
@@ -1018,7 +1180,7 @@ namespace FastCG
                         rBufferCopyRegion.imageExtent = {pDstTexture->GetWidth(), pDstTexture->GetHeight(),
                                                          pDstTexture->GetDepth()};
                     }
-                    vkCmdCopyBufferToImage(VulkanGraphicsSystem::GetInstance()->GetCurrentCommandBuffer(),
+                    vkCmdCopyBufferToImage(GetCommandBuffer(),
                                            rCopyCommand.args.srcBufferData.pBuffer
                                                ->GetFrameData(rCopyCommand.args.srcBufferData.frameIndex)
                                                .buffer,
@@ -1120,7 +1282,7 @@ namespace FastCG
                         rImageCopyRegion.extent.depth = pSrcTexture->GetDepth();
                     }
 
-                    vkCmdCopyImage(VulkanGraphicsSystem::GetInstance()->GetCurrentCommandBuffer(),
+                    vkCmdCopyImage(GetCommandBuffer(),
                                    pSrcTexture->GetImage(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
                                    pDstTexture->GetImage(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
                                    (uint32_t)imageCopyRegions.size(), &imageCopyRegions[0]);
@@ -1174,7 +1336,7 @@ namespace FastCG
                     imageBlit.dstOffsets[1] = {(int32_t)pDstTexture->GetWidth(), (int32_t)pDstTexture->GetHeight(),
                                                1}; // TODO: support 3D textures
 
-                    vkCmdBlitImage(VulkanGraphicsSystem::GetInstance()->GetCurrentCommandBuffer(),
+                    vkCmdBlitImage(GetCommandBuffer(),
                                    pSrcTexture->GetImage(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
                                    pDstTexture->GetImage(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &imageBlit,
                                    GetVkFilter(pSrcTexture->GetFilter()));
@@ -1207,6 +1369,101 @@ namespace FastCG
             return flags;
         };
 
+        auto GetVkPipelineBindPoint = [](PassType passType) {
+            switch (passType)
+            {
+            case PassType::RENDER:
+                return VK_PIPELINE_BIND_POINT_GRAPHICS;
+            case PassType::COMPUTE:
+                return VK_PIPELINE_BIND_POINT_COMPUTE;
+            default:
+                FASTCG_THROW_EXCEPTION(Exception, "Vulkan: Unhandled pass type %d", (int)passType);
+                return (VkPipelineBindPoint)0;
+            }
+        };
+
+        // only reads the context, so it can be called from the worker threads
+        auto RecordInvokeCommand = [](VkCommandBuffer commandBuffer, PassType passType,
+                                      VkPipelineBindPoint pipelineBindPoint, VkPipelineLayout pipelineLayout,
+                                      const InvokeCommand &rInvokeCommand) {
+            // TODO: avoid binding and setting stuff unecessarily
+
+            if (passType == PassType::RENDER)
+            {
+                // set dynamic graphics pipeline attributes
+
+                vkCmdSetViewport(commandBuffer, 0, 1, &rInvokeCommand.drawInfo.viewport);
+                vkCmdSetScissor(commandBuffer, 0, 1, &rInvokeCommand.drawInfo.scissor);
+
+                if (rInvokeCommand.drawInfo.vertexBufferCount > 0)
+                {
+                    // vertex buffers are always bound from their start
+                    static constexpr VkDeviceSize OFFSETS[MAX_VERTEX_BUFFER_COUNT]{};
+                    vkCmdBindVertexBuffers(commandBuffer, 0, rInvokeCommand.drawInfo.vertexBufferCount,
+                                           &rInvokeCommand.drawInfo.pVertexBuffers[0], OFFSETS);
+                }
+                if (rInvokeCommand.drawInfo.indexBuffer != VK_NULL_HANDLE)
+                {
+                    vkCmdBindIndexBuffer(commandBuffer, rInvokeCommand.drawInfo.indexBuffer, 0,
+                                         VK_INDEX_TYPE_UINT32); // TODO: support other index types
+                }
+            }
+
+            if (rInvokeCommand.setCount > 0)
+            {
+                vkCmdBindDescriptorSets(commandBuffer, pipelineBindPoint, pipelineLayout, 0, rInvokeCommand.setCount,
+                                        rInvokeCommand.pSets, rInvokeCommand.dynamicOffsetCount,
+                                        rInvokeCommand.pDynamicOffsets);
+            }
+
+            switch (passType)
+            {
+            case PassType::RENDER:
+                switch (rInvokeCommand.drawInfo.type)
+                {
+                case DrawCommandType::INSTANCED_INDEXED:
+                    vkCmdDrawIndexed(commandBuffer, rInvokeCommand.drawInfo.indexCount,
+                                     rInvokeCommand.drawInfo.instanceCount, rInvokeCommand.drawInfo.firstIndex,
+                                     rInvokeCommand.drawInfo.vertexOffset, rInvokeCommand.drawInfo.firstInstance);
+                    break;
+                case DrawCommandType::INDEXED_INDIRECT: {
+                    auto multiDrawIndirect =
+                        VulkanGraphicsSystem::GetInstance()->GetEnabledPhysicalDeviceFeatures().multiDrawIndirect;
+                    if (rInvokeCommand.drawInfo.drawCount == 1 || multiDrawIndirect)
+                    {
+                        vkCmdDrawIndexedIndirect(commandBuffer, rInvokeCommand.drawInfo.indirectBuffer,
+                                                 rInvokeCommand.drawInfo.indirectOffset,
+                                                 rInvokeCommand.drawInfo.drawCount, rInvokeCommand.drawInfo.stride);
+                    }
+                    else
+                    {
+                        // one draw per command when multiDrawIndirect isn't supported
+                        for (uint32_t l = 0; l < rInvokeCommand.drawInfo.drawCount; ++l)
+                        {
+                            vkCmdDrawIndexedIndirect(commandBuffer, rInvokeCommand.drawInfo.indirectBuffer,
+                                                     rInvokeCommand.drawInfo.indirectOffset +
+                                                         (VkDeviceSize)l * rInvokeCommand.drawInfo.stride,
+                                                     1, rInvokeCommand.drawInfo.stride);
+                        }
+                    }
+                }
+                break;
+                default:
+                    FASTCG_THROW_EXCEPTION(Exception, "Vulkan: Unhandled draw command type %d",
+                                           (int)rInvokeCommand.drawInfo.type);
+                    break;
+                }
+                break;
+            case PassType::COMPUTE:
+                vkCmdDispatch(commandBuffer, rInvokeCommand.dispatchInfo.groupCountX,
+                              rInvokeCommand.dispatchInfo.groupCountY, rInvokeCommand.dispatchInfo.groupCountZ);
+                break;
+            default:
+                FASTCG_THROW_EXCEPTION(Exception, "Vulkan: Unhandled pass type %d", (int)passType);
+                break;
+            }
+        };
+
         FASTCG_LOG_VERBOSE(VulkanGraphicsContext, "Iterating over passes (%zu)", mPassBatches.size());
 
         for (size_t i = 0; i < mPassBatches.size(); ++i)
@@ -1237,6 +1494,7 @@ namespace FastCG
 
                 auto &rPipelineBatch = mPipelineBatches[j];
 
+                const InvokeCommand *pLastInvokeCommand = nullptr;
                 for (size_t k = savedLastUsedInvokeCommandIdx, kc = 0;
                      savedLastUsedInvokeCommandIdx < rPipelineBatch.lastInvokeCommandIdx;
                      ++savedLastUsedInvokeCommandIdx, ++kc)
@@ -1250,6 +1508,14 @@ namespace FastCG
                     auto &rInvokeCommand = mInvokeCommands[savedLastUsedInvokeCommandIdx];
 
                     rInvokeCommand.setCount = rPipelineBatch.layoutDescription.setLayoutCount;
+                    rInvokeCommand.dynamicOffsetCount = 0;
+
+                    // consecutive invokes often bind the same resources and only change the offsets of dynamic
+                    // uniform buffers, in which case the descriptor sets of the previous invoke can be reused as is
+                    bool reuseSets = pLastInvokeCommand != nullptr &&
+                                     HasSameDescriptors(rPipelineBatch.layoutDescription,
+                                                        pLastInvokeCommand->pipelineLayout,
+                                                        rInvokeCommand.pipelineLayout);
 
                     uint32_t setWritesCount = 0;
                     uint32_t lastImageInfoIdx = 0;
@@ -1267,13 +1533,29 @@ namespace FastCG
                             rSet = VK_NULL_HANDLE;
                             continue;
                         }
-                        rSet = VulkanGraphicsSystem::GetInstance()->GetOrCreateDescriptorSet(rSetLayout).second;
+                        if (reuseSets)
+                        {
+                            rSet = pLastInvokeCommand->pSets[l];
+                        }
+                        auto firstSetWriteIdx = setWritesCount;
                         for (uint32_t m = 0; m < rSetLayout.bindingLayoutCount; ++m)
                         {
                             auto &rBindingLayout = rSetLayout.pBindingLayouts[m];
                             auto *pBinding = rSetUsage.bindingCount > rBindingLayout.binding
                                                  ? &rSetUsage.pBindings[rBindingLayout.binding]
                                                  : nullptr;
+                            if (rBindingLayout.type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC)
+                            {
+                                assert(pBinding != nullptr);
+                                assert(rInvokeCommand.dynamicOffsetCount <
+                                       VulkanPipelineLayout::MAX_DYNAMIC_UNIFORM_BUFFER_COUNT);
+                                rInvokeCommand.pDynamicOffsets[rInvokeCommand.dynamicOffsetCount++] =
+                                    pBinding->offset;
+                            }
+                            if (reuseSets)
+                            {
+                                continue;
+                            }
                             auto &rSetWrite = pSetWrites[setWritesCount++];
                             rSetWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
                             rSetWrite.pNext = nullptr;
@@ -1281,7 +1563,10 @@ namespace FastCG
                             rSetWrite.descriptorType = rBindingLayout.type;
                             rSetWrite.dstArrayElement = 0;
                             rSetWrite.dstBinding = rBindingLayout.binding;
-                            rSetWrite.dstSet = rSet;
+                            // set by the descriptor set cache
+                            rSetWrite.dstSet = VK_NULL_HANDLE;
+                            rSetWrite.pImageInfo = nullptr;
+                            rSetWrite.pBufferInfo = nullptr;
                             if (rBindingLayout.type == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER)
                             {
                                 auto &rImageInfo = pImageInfos[lastImageInfoIdx++];
@@ -1322,7 +1607,8 @@ namespace FastCG
                                                         GetVkPipelineStageFlags(rBindingLayout.stageFlags));
                             }
                             else if (rBindingLayout.type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER ||
-                                     rBindingLayout.type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER)
+                                     rBindingLayout.type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER ||
+                                     rBindingLayout.type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC)
                             {
                                 auto &rBufferInfo = pBufferInfos[lastBufferInfoIdx++];
                                 assert(lastBufferInfoIdx < MAX_RESOURCES);
@@ -1330,14 +1616,29 @@ namespace FastCG
                                 assert(pBinding->pBuffer != nullptr);
                                 auto buffer = GetCurrentVkBuffer(pBinding->pBuffer);
                                 rBufferInfo.buffer = buffer;
-                                rBufferInfo.offset = 0;
-                                rBufferInfo.range = VK_WHOLE_SIZE;
+                                // the offset of dynamic uniform buffers is only provided when binding the set
+                                if (rBindingLayout.type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC)
+                                {
+                                    rBufferInfo.offset = 0;
+                                }
+                                else
+                                {
+                                    rBufferInfo.offset = (VkDeviceSize)pBinding->offset;
+                                }
+                                rBufferInfo.range = (VkDeviceSize)pBinding->size;
                                 rSetWrite.pBufferInfo = &rBufferInfo;
 
+                                // storage buffers can be written, so later reads must wait for them
+                                VkAccessFlags dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+                                if (rBindingLayout.type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER)
+                                {
+                                    dstAccessMask |= VK_ACCESS_SHADER_WRITE_BIT;
+                                }
+
                                 auto lastBufferMemoryBarrier =
                                     VulkanGraphicsSystem::GetInstance()->GetLastBufferMemoryBarrier(buffer);
-                                AddBufferMemoryBarrier(buffer, lastBufferMemoryBarrier.accessMask,
-                                                       VK_ACCESS_SHADER_READ_BIT, lastBufferMemoryBarrier.stageMask,
+                                AddBufferMemoryBarrier(buffer, lastBufferMemoryBarrier.accessMask, dstAccessMask,
+                                                       lastBufferMemoryBarrier.stageMask,
                                                        GetVkPipelineStageFlags(rBindingLayout.stageFlags));
                             }
                             else
@@ -1347,12 +1648,23 @@ namespace FastCG
                             }
                             rSetWrite.pTexelBufferView = nullptr;
                         }
+                        if (!reuseSets)
+                        {
+                            // only written if no set with the same resources is cached
+                            rSet = VulkanGraphicsSystem::GetInstance()->GetOrCreateDescriptorSet(
+                                rSetLayout, &pSetWrites[firstSetWriteIdx], setWritesCount - firstSetWriteIdx);
+                        }
                     }
+                    pLastInvokeCommand = &rInvokeCommand;
 
-                    if (setWritesCount > 0)
+                    if (rPassBatch.type == PassType::RENDER &&
+                        rInvokeCommand.drawInfo.type == DrawCommandType::INDEXED_INDIRECT)
                     {
-                        vkUpdateDescriptorSets(VulkanGraphicsSystem::GetInstance()->GetDevice(), setWritesCount,
-                                               pSetWrites, 0, nullptr);
+                        auto lastBufferMemoryBarrier = VulkanGraphicsSystem::GetInstance()->GetLastBufferMemoryBarrier(
+                            rInvokeCommand.drawInfo.indirectBuffer);
+                        AddBufferMemoryBarrier(rInvokeCommand.drawInfo.indirectBuffer,
+                                               lastBufferMemoryBarrier.accessMask, VK_ACCESS_INDIRECT_COMMAND_READ_BIT,
+                                               lastBufferMemoryBarrier.stageMask, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT);
                     }
                 }
             }
@@ -1387,7 +1699,10 @@ namespace FastCG
                 }
                 auto lastImageMemoryBarrier =
                     VulkanGraphicsSystem::GetInstance()->GetLastImageMemoryBarrier(pRenderTarget);
-                if (!IsVkReadOnlyAccessFlags(lastImageMemoryBarrier.accessMask))
+                // render targets sampled since they were last written (e.g., by a compute pass) still need a layout
+                // transition
+                if (!IsVkReadOnlyAccessFlags(lastImageMemoryBarrier.accessMask) ||
+                    lastImageMemoryBarrier.layout != newLayout)
                 {
                     AddTextureMemoryBarrier(pRenderTarget, lastImageMemoryBarrier.layout, newLayout,
                                             lastImageMemoryBarrier.accessMask, dstAccessMask,
@@ -1413,6 +1728,90 @@ namespace FastCG
 
             FASTCG_LOG_VERBOSE(VulkanGraphicsContext, "\tRecording invoke commands");
 
+            auto pipelineBindPoint = GetVkPipelineBindPoint(rPassBatch.type);
+
+            // big passes are split into chunks of consecutive invokes that are recorded in parallel into secondary
+            // command buffers (descriptor sets and barriers were already resolved above)
+            auto *pThreadPool = VulkanGraphicsSystem::GetInstance()->GetThreadPool();
+            auto firstInvokeCommandIdx = lastUsedInvokeCommandIdx;
+            auto invokeCount =
+                mPipelineBatches[rPassBatch.lastPipelineBatchIdx - 1].lastInvokeCommandIdx - firstInvokeCommandIdx;
+            // (the secondary command buffer pools belong to the graphics queue family)
+            auto chunkCount = mQueueType == QueueType::GRAPHICS
+                                  ? std::min<size_t>(pThreadPool->GetThreadCount() + 1,
+                                                     invokeCount / MIN_INVOKES_PER_SECONDARY_COMMAND_BUFFER)
+                                  : 0;
+
+            if (chunkCount > 1)
+            {
+                FASTCG_LOG_VERBOSE(VulkanGraphicsContext, "\t\tRecording secondary command buffers (%zu)", chunkCount);
+
+#if _DEBUG
+                // nothing but secondary command buffers can be recorded inside the pass
+                ProccessMarkers(mInvokeCommands[firstInvokeCommandIdx + invokeCount - 1].lastMarkerCommandIdx);
+#endif
+
+                auto firstPipelineBatchIdx = lastUsedPipelineBatchIdx;
+                mSecondaryCommandBuffers.resize(chunkCount);
+                pThreadPool->ParallelFor(chunkCount, [&](size_t chunkIdx, uint32_t threadIdx) {
+                    auto commandBuffer = VulkanGraphicsSystem::GetInstance()->AcquireSecondaryCommandBuffer(threadIdx);
+
+                    VkCommandBufferInheritanceInfo commandBufferInheritanceInfo;
+                    commandBufferInheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+                    commandBufferInheritanceInfo.pNext = nullptr;
+                    commandBufferInheritanceInfo.subpass = 0;
+                    commandBufferInheritanceInfo.occlusionQueryEnable = VK_FALSE;
+                    commandBufferInheritanceInfo.queryFlags = 0;
+                    commandBufferInheritanceInfo.pipelineStatistics = 0;
+
+                    VkCommandBufferBeginInfo commandBufferBeginInfo;
+                    commandBufferBeginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+                    commandBufferBeginInfo.pNext = nullptr;
+                    commandBufferBeginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+                    commandBufferBeginInfo.pInheritanceInfo = &commandBufferInheritanceInfo;
+                    if (rPassBatch.type == PassType::RENDER)
+                    {
+                        commandBufferInheritanceInfo.renderPass = rPassBatch.renderInfo.renderPass;
+                        commandBufferInheritanceInfo.framebuffer = rPassBatch.renderInfo.frameBuffer;
+                        commandBufferBeginInfo.flags |= VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+                    }
+                    else
+                    {
+                        commandBufferInheritanceInfo.renderPass = VK_NULL_HANDLE;
+                        commandBufferInheritanceInfo.framebuffer = VK_NULL_HANDLE;
+                    }
+                    FASTCG_CHECK_VK_RESULT(vkBeginCommandBuffer(commandBuffer, &commandBufferBeginInfo));
+
+                    auto invokeBegin = firstInvokeCommandIdx + invokeCount * chunkIdx / chunkCount;
+                    auto invokeEnd = firstInvokeCommandIdx + invokeCount * (chunkIdx + 1) / chunkCount;
+                    auto pipelineBatchIdx = firstPipelineBatchIdx;
+                    // secondary command buffers don't inherit the bound pipeline
+                    bool bindPipeline = true;
+                    for (auto k = invokeBegin; k < invokeEnd; ++k)
+                    {
+                        while (mPipelineBatches[pipelineBatchIdx].lastInvokeCommandIdx <= k)
+                        {
+                            ++pipelineBatchIdx;
+                            bindPipeline = true;
+                        }
+
+                        const auto &rPipelineBatch = mPipelineBatches[pipelineBatchIdx];
+                        if (bindPipeline)
+                        {
+                            vkCmdBindPipeline(commandBuffer, pipelineBindPoint, rPipelineBatch.pipeline.pipeline);
+                            bindPipeline = false;
+                        }
+
+                        RecordInvokeCommand(commandBuffer, rPassBatch.type, pipelineBindPoint,
+                                            rPipelineBatch.pipeline.layout, mInvokeCommands[k]);
+                    }
+
+                    FASTCG_CHECK_VK_RESULT(vkEndCommandBuffer(commandBuffer));
+
+                    mSecondaryCommandBuffers[chunkIdx] = commandBuffer;
+                });
+            }
+
             if (rPassBatch.type == PassType::RENDER)
             {
                 VkRenderPassBeginInfo renderPassBeginInfo;
@@ -1424,15 +1823,48 @@ namespace FastCG
                 renderPassBeginInfo.clearValueCount = rPassBatch.renderInfo.clearValueCount;
                 renderPassBeginInfo.pClearValues = rPassBatch.renderInfo.pClearValues;
 
+                VkImageView pAttachments[VulkanRenderPassDescription::MAX_RENDER_TARGET_COUNT + 1];
+                VkRenderPassAttachmentBeginInfoKHR renderPassAttachmentBeginInfo;
+                if (VulkanGraphicsSystem::GetInstance()->IsImagelessFrameBufferSupported())
+                {
+                    const auto &rRenderInfo = rPassBatch.renderInfo;
+                    uint32_t attachmentCount = 0;
+                    for (uint32_t j = 0; j < rRenderInfo.renderTargetCount; ++j)
+                    {
+                        pAttachments[attachmentCount++] = rRenderInfo.ppRenderTargets[j]->GetDefaultImageView();
+                    }
+                    if (rRenderInfo.pDepthStencilBuffer != nullptr)
+                    {
+                        pAttachments[attachmentCount++] = rRenderInfo.pDepthStencilBuffer->GetDefaultImageView();
+                    }
+
+                    renderPassAttachmentBeginInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_ATTACHMENT_BEGIN_INFO_KHR;
+                    renderPassAttachmentBeginInfo.pNext = nullptr;
+                    renderPassAttachmentBeginInfo.attachmentCount = attachmentCount;
+                    renderPassAttachmentBeginInfo.pAttachments = pAttachments;
+
+                    renderPassBeginInfo.pNext = &renderPassAttachmentBeginInfo;
+                }
+
                 VkSubpassBeginInfoKHR subpassBeginInfo;
                 subpassBeginInfo.sType = VK_STRUCTURE_TYPE_SUBPASS_BEGIN_INFO_KHR;
                 subpassBeginInfo.pNext = nullptr;
-                subpassBeginInfo.contents = VK_SUBPASS_CONTENTS_INLINE;
+                subpassBeginInfo.contents =
+                    chunkCount > 1 ? VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS : VK_SUBPASS_CONTENTS_INLINE;
 
-                VkExt::vkCmdBeginRenderPass2KHR(VulkanGraphicsSystem::GetInstance()->GetCurrentCommandBuffer(),
+                VkExt::vkCmdBeginRenderPass2KHR(GetCommandBuffer(),
                                                 &renderPassBeginInfo, &subpassBeginInfo);
             }
 
+            if (chunkCount > 1)
+            {
+                vkCmdExecuteCommands(GetCommandBuffer(),
+                                     (uint32_t)mSecondaryCommandBuffers.size(), &mSecondaryCommandBuffers[0]);
+
+                lastUsedPipelineBatchIdx = rPassBatch.lastPipelineBatchIdx;
+                lastUsedInvokeCommandIdx = firstInvokeCommandIdx + invokeCount;
+            }
+
             for (size_t j = lastUsedPipelineBatchIdx, jc = 0;
                  lastUsedPipelineBatchIdx < rPassBatch.lastPipelineBatchIdx; ++lastUsedPipelineBatchIdx, ++jc)
             {
@@ -1449,22 +1881,7 @@ namespace FastCG
                     continue;
                 }
 
-                auto GetVkPipelineBindPoint = [](PassType passType) {
-                    switch (passType)
-                    {
-                    case PassType::RENDER:
-                        return VK_PIPELINE_BIND_POINT_GRAPHICS;
-                    case PassType::COMPUTE:
-                        return VK_PIPELINE_BIND_POINT_COMPUTE;
-                    default:
-                        FASTCG_THROW_EXCEPTION(Exception, "Vulkan: Unhandled pass type %d", (int)passType);
-                        return (VkPipelineBindPoint)0;
-                    }
-                };
-
-                auto pipelineBindPoint = GetVkPipelineBindPoint(rPassBatch.type);
-
-                vkCmdBindPipeline(VulkanGraphicsSystem::GetInstance()->GetCurrentCommandBuffer(), pipelineBindPoint,
+                vkCmdBindPipeline(GetCommandBuffer(), pipelineBindPoint,
                                   rPipelineBatch.pipeline.pipeline);
 
                 for (size_t k = lastUsedInvokeCommandIdx, kc = 0;
@@ -1482,65 +1899,9 @@ namespace FastCG
                     ProccessMarkers(rInvokeCommand.lastMarkerCommandIdx);
 #endif
 
-                    // TODO: avoid binding and setting stuff unecessarily
-
-                    if (rPassBatch.type == PassType::RENDER)
-                    {
-                        // set dynamic graphics pipeline attributes
-
-                        vkCmdSetViewport(VulkanGraphicsSystem::GetInstance()->GetCurrentCommandBuffer(), 0, 1,
-                                         &rInvokeCommand.drawInfo.viewport);
-                        vkCmdSetScissor(VulkanGraphicsSystem::GetInstance()->GetCurrentCommandBuffer(), 0, 1,
-                                        &rInvokeCommand.drawInfo.scissor);
-
-                        if (rInvokeCommand.drawInfo.vertexBufferCount > 0)
-                        {
-                            std::vector<VkDeviceSize> offsets(rInvokeCommand.drawInfo.vertexBufferCount);
-                            vkCmdBindVertexBuffers(VulkanGraphicsSystem::GetInstance()->GetCurrentCommandBuffer(), 0,
-                                                   rInvokeCommand.drawInfo.vertexBufferCount,
-                                                   &rInvokeCommand.drawInfo.pVertexBuffers[0], &offsets[0]);
-                        }
-                        if (rInvokeCommand.drawInfo.indexBuffer != VK_NULL_HANDLE)
-                        {
-                            vkCmdBindIndexBuffer(VulkanGraphicsSystem::GetInstance()->GetCurrentCommandBuffer(),
-                                                 rInvokeCommand.drawInfo.indexBuffer, 0,
-                                                 VK_INDEX_TYPE_UINT32); // TODO: support other index types
-                        }
-                    }
-
-                    if (rInvokeCommand.setCount > 0)
-                    {
-                        vkCmdBindDescriptorSets(VulkanGraphicsSystem::GetInstance()->GetCurrentCommandBuffer(),
-                                                pipelineBindPoint, rPipelineBatch.pipeline.layout, 0,
-                                                rInvokeCommand.setCount, rInvokeCommand.pSets, 0, nullptr);
-                    }
-
-                    switch (rPassBatch.type)
-                    {
-                    case PassType::RENDER:
-                        switch (rInvokeCommand.drawInfo.type)
-                        {
-                        case DrawCommandType::INSTANCED_INDEXED:
-                            vkCmdDrawIndexed(VulkanGraphicsSystem::GetInstance()->GetCurrentCommandBuffer(),
-                                             rInvokeCommand.drawInfo.indexCount, rInvokeCommand.drawInfo.instanceCount,
-                                             rInvokeCommand.drawInfo.firstIndex, rInvokeCommand.drawInfo.vertexOffset,
-                                             rInvokeCommand.drawInfo.firstInstance);
-                            break;
-                        default:
-                            FASTCG_THROW_EXCEPTION(Exception, "Vulkan: Unhandled draw command type %d",
-                                                   (int)rInvokeCommand.drawInfo.type);
-                            break;
-                        }
-                        break;
-                    case PassType::COMPUTE:
-                        vkCmdDispatch(VulkanGraphicsSystem::GetInstance()->GetCurrentCommandBuffer(),
-                                      rInvokeCommand.dispatchInfo.groupCountX, rInvokeCommand.dispatchInfo.groupCountY,
-                                      rInvokeCommand.dispatchInfo.groupCountZ);
-                        break;
-                    default:
-                        FASTCG_THROW_EXCEPTION(Exception, "Vulkan: Unhandled pass type %d", (int)rPassBatch.type);
-                        break;
-                    }
+                    RecordInvokeCommand(GetCommandBuffer(),
+                                        rPassBatch.type, pipelineBindPoint, rPipelineBatch.pipeline.layout,
+                                        rInvokeCommand);
                 }
             }
 
@@ -1549,7 +1910,7 @@ namespace FastCG
                 VkSubpassEndInfoKHR subpassEndInfo;
                 subpassEndInfo.sType = VK_STRUCTURE_TYPE_SUBPASS_END_INFO_KHR;
                 subpassEndInfo.pNext = nullptr;
-                VkExt::vkCmdEndRenderPass2KHR(VulkanGraphicsSystem::GetInstance()->GetCurrentCommandBuffer(),
+                VkExt::vkCmdEndRenderPass2KHR(GetCommandBuffer(),
                                               &subpassEndInfo);
             }
 
@@ -1617,7 +1978,7 @@ namespace FastCG
             barrier.pNext = nullptr;
             barrier.srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT | VK_ACCESS_MEMORY_READ_BIT;
             barrier.dstAccessMask = VK_ACCESS_MEMORY_WRITE_BIT | VK_ACCESS_MEMORY_READ_BIT;
-            vkCmdPipelineBarrier(VulkanGraphicsSystem::GetInstance()->GetCurrentCommandBuffer(),
+            vkCmdPipelineBarrier(GetCommandBuffer(),
                                  VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 1, &barrier,
                                  0, nullptr, 0, nullptr);
             mAddMemoryBarrier = false;
@@ -1626,11 +1987,15 @@ namespace FastCG
 #if !defined FASTCG_DISABLE_GPU_TIMING
         FASTCG_LOG_VERBOSE(VulkanGraphicsContext, "Enqueing timestamp queries");
 
-        EnqueueTimestampQuery(mTimeElapsedQueries[VulkanGraphicsSystem::GetInstance()->GetCurrentFrame()].end,
-                              VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+        if (mQueueType == QueueType::GRAPHICS)
+        {
+            EnqueueTimestampQuery(mTimeElapsedQueries[VulkanGraphicsSystem::GetInstance()->GetCurrentFrame()].end,
+                                  VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+        }
 #endif
 
         mPassBatches.resize(0);
+        mNewComputePassBatch = false;
         mPipelineBatches.resize(0);
         mInvokeCommands.resize(0);
         mCopyCommands.resize(0);
@@ -1688,6 +2053,9 @@ namespace FastCG
                                                        VkAccessFlags dstAccessMask, VkPipelineStageFlags srcStageMask,
                                                        VkPipelineStageFlags dstStageMask)
     {
+        FilterVkBarrierMasks(mQueueType, srcAccessMask, srcStageMask);
+        FilterVkBarrierMasks(mQueueType, dstAccessMask, dstStageMask);
+
         VkBufferMemoryBarrier bufferMemoryBarrier;
         bufferMemoryBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
         bufferMemoryBarrier.pNext = nullptr;
@@ -1699,7 +2067,7 @@ namespace FastCG
         bufferMemoryBarrier.offset = 0;
         bufferMemoryBarrier.size = VK_WHOLE_SIZE;
 
-        vkCmdPipelineBarrier(VulkanGraphicsSystem::GetInstance()->GetCurrentCommandBuffer(), srcStageMask, dstStageMask,
+        vkCmdPipelineBarrier(GetCommandBuffer(), srcStageMask, dstStageMask,
                              0, 0, nullptr, 1, &bufferMemoryBarrier, 0, nullptr);
 
         VulkanGraphicsSystem::GetInstance()->NotifyBufferMemoryBarrier(buffer, {dstAccessMask, dstStageMask});
@@ -1710,6 +2078,9 @@ namespace FastCG
                                                         VkAccessFlags dstAccessMask, VkPipelineStageFlags srcStageMask,
                                                         VkPipelineStageFlags dstStageMask)
     {
+        FilterVkBarrierMasks(mQueueType, srcAccessMask, srcStageMask);
+        FilterVkBarrierMasks(mQueueType, dstAccessMask, dstStageMask);
+
         VkImageMemoryBarrier imageMemoryBarrier;
         imageMemoryBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
         imageMemoryBarrier.pNext = nullptr;
@@ -1726,17 +2097,22 @@ namespace FastCG
         imageMemoryBarrier.subresourceRange.baseArrayLayer = 0;
         imageMemoryBarrier.subresourceRange.layerCount = pTexture->GetSlices();
 
-        vkCmdPipelineBarrier(VulkanGraphicsSystem::GetInstance()->GetCurrentCommandBuffer(), srcStageMask, dstStageMask,
+        vkCmdPipelineBarrier(GetCommandBuffer(), srcStageMask, dstStageMask,
                              0, 0, nullptr, 0, nullptr, 1, &imageMemoryBarrier);
 
         VulkanGraphicsSystem::GetInstance()->NotifyImageMemoryBarrier(pTexture,
                                                                       {newLayout, dstAccessMask, dstStageMask});
     }
 
+    VkCommandBuffer VulkanGraphicsContext::GetCommandBuffer() const
+    {
+        return VulkanGraphicsSystem::GetInstance()->GetCurrentCommandBuffer(mQueueType);
+    }
+
     void VulkanGraphicsContext::EnqueueTimestampQuery(uint32_t query, VkPipelineStageFlagBits pipelineStage)
     {
         vkCmdWriteTimestamp(
-            VulkanGraphicsSystem::GetInstance()->GetCurrentCommandBuffer(), pipelineStage,
+            GetCommandBuffer(), pipelineStage,
             VulkanGraphicsSystem::GetInstance()->GetQueryPool(VulkanGraphicsSystem::GetInstance()->GetCurrentFrame()),
             query);
     }
@@ -8,15 +8,55 @@
 #include <FastCG/Graphics/Vulkan/VulkanGraphicsSystem.h>
 #include <FastCG/Graphics/Vulkan/VulkanUtils.h>
 #include <FastCG/Platform/Application.h>
+#include <FastCG/Platform/FileReader.h>
+#include <FastCG/Platform/FileWriter.h>
 
 #include <algorithm>
 #include <cassert>
+#include <cstring>
+#include <filesystem>
 #include <limits>
+#include <numeric>
 #include <sstream>
 #include <string>
+#include <vector>
 
 namespace
 {
+    constexpr uint32_t PIPELINE_CACHE_FILE_MAGIC = 0x46435043; // "FCPC"
+
+    // prefixes the pipeline cache data in the file, so that caches from other devices or drivers are never fed to
+    // vkCreatePipelineCache (the header of the data itself doesn't have the driver version)
+    struct PipelineCacheFileHeader
+    {
+        uint32_t magic;
+        uint32_t vendorID;
+        uint32_t deviceID;
+        uint32_t driverVersion;
+        uint8_t pipelineCacheUUID[VK_UUID_SIZE];
+        uint64_t dataSize;
+    };
+
+    PipelineCacheFileHeader CreatePipelineCacheFileHeader(const VkPhysicalDeviceProperties &rPhysicalDeviceProperties)
+    {
+        PipelineCacheFileHeader header{};
+        header.magic = PIPELINE_CACHE_FILE_MAGIC;
+        header.vendorID = rPhysicalDeviceProperties.vendorID;
+        header.deviceID = rPhysicalDeviceProperties.deviceID;
+        header.driverVersion = rPhysicalDeviceProperties.driverVersion;
+        std::memcpy(header.pipelineCacheUUID, rPhysicalDeviceProperties.pipelineCacheUUID, VK_UUID_SIZE);
+        return header;
+    }
+
+    bool IsPipelineCacheFileHeaderValid(const PipelineCacheFileHeader &rHeader,
+                                        const VkPhysicalDeviceProperties &rPhysicalDeviceProperties)
+    {
+        auto expectedHeader = CreatePipelineCacheFileHeader(rPhysicalDeviceProperties);
+        return rHeader.magic == expectedHeader.magic && rHeader.vendorID == expectedHeader.vendorID &&
+               rHeader.deviceID == expectedHeader.deviceID && rHeader.driverVersion == expectedHeader.driverVersion &&
+               std::memcmp(rHeader.pipelineCacheUUID, expectedHeader.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+    }
+
     template <typename AType>
     struct StrComparer;
 
@@ -164,49 +204,129 @@ namespace
 
 #undef FASTCG_LOAD_VK_DEVICE_EXT_FN
 
-    // remove all padding cause struct memory is used to compute hash
+    // remove all padding cause struct memory is used as cache key
     FASTCG_PACKED_PREFIX struct AttachmentDefinition
     {
-        const FastCG::VulkanTexture *pTexture;
+        VkFormat format;
+        VkImageLayout finalLayout;
         VkAttachmentLoadOp colorOrDepth;
         VkAttachmentLoadOp stencil;
         uint8_t write : 2; // 0=no write, 1=write depth/colour, 2=write stencil, 3=write depth&stencil
     } FASTCG_PACKED_SUFFIX;
 
-    size_t GetRenderPassHash(const std::vector<AttachmentDefinition> &rAttachmentDefinitions)
+    // everything the render pass is created from, so render targets alike share it
+    void BuildRenderPassKey(const std::vector<AttachmentDefinition> &rAttachmentDefinitions,
+                            FastCG::VulkanObjectKey &rKey)
+    {
+        rKey.Clear();
+        rKey.Append(rAttachmentDefinitions.data(), rAttachmentDefinitions.size());
+    }
+
+    // only what render pass compatibility depends on (attachment formats and sample counts, the latter always 1):
+    // https://registry.khronos.org/vulkan/specs/1.1-extensions/html/vkspec.html#renderpass-compatibility
+    void BuildCompatibleRenderPassKey(const FastCG::VulkanRenderPassDescription &rRenderPassDescription,
+                                      FastCG::VulkanObjectKey &rKey)
+    {
+        rKey.Clear();
+        for (uint32_t i = 0; i < rRenderPassDescription.renderTargetCount; ++i)
+        {
+            const auto *pRenderTarget = rRenderPassDescription.ppRenderTargets[i];
+            if (pRenderTarget != nullptr)
+            {
+                rKey.Append(pRenderTarget->GetVulkanFormat());
+            }
+        }
+        // color formats are never undefined
+        rKey.Append(rRenderPassDescription.pDepthStencilBuffer != nullptr
+                        ? rRenderPassDescription.pDepthStencilBuffer->GetVulkanFormat()
+                        : VK_FORMAT_UNDEFINED);
+    }
+
+    void BuildFrameBufferKey(const std::vector<VkImageView> &rAttachments, VkRenderPass renderPass,
+                             FastCG::VulkanObjectKey &rKey)
+    {
+        rKey.Clear();
+        rKey.Append(rAttachments.data(), rAttachments.size());
+        rKey.Append(renderPass);
+    }
+
+    void BuildImagelessFrameBufferKey(const std::vector<VkFramebufferAttachmentImageInfoKHR> &rAttachmentImageInfos,
+                                      VkRenderPass renderPass, FastCG::VulkanObjectKey &rKey)
     {
-        // TODO: use renderpass compatibility rule:
-        // https://registry.khronos.org/vulkan/specs/1.1-extensions/html/vkspec.html#renderpass-compatibility
-        return (size_t)FastCG::FNV1a(reinterpret_cast<const uint8_t *>(&rAttachmentDefinitions[0]),
-                                     rAttachmentDefinitions.size() * sizeof(&rAttachmentDefinitions[0]));
+        rKey.Clear();
+        for (const auto &rAttachmentImageInfo : rAttachmentImageInfos)
+        {
+            rKey.Append(rAttachmentImageInfo.flags);
+            rKey.Append(rAttachmentImageInfo.usage);
+            rKey.Append(rAttachmentImageInfo.width);
+            rKey.Append(rAttachmentImageInfo.height);
+            rKey.Append(rAttachmentImageInfo.layerCount);
+        }
+        rKey.Append(renderPass);
     }
 
-    size_t GetFrameBufferHash(const std::vector<VkImageView> &rAttachments)
+    void BuildGraphicsPipelineKey(const FastCG::VulkanPipelineDescription &rPipelineDescription,
+                                  VkRenderPass renderPass, uint32_t renderTargetCount, FastCG::VulkanObjectKey &rKey)
     {
-        return (size_t)FastCG::FNV1a(reinterpret_cast<const uint8_t *>(&rAttachments[0]),
-                                     rAttachments.size() * sizeof(&rAttachments[0]));
+        rKey.Clear();
+        rKey.Append(rPipelineDescription);
+        rKey.Append(renderPass);
+        rKey.Append(renderTargetCount);
     }
 
-    size_t GetPipelineHash(const FastCG::VulkanPipelineDescription &rPipelineDescription)
+    void BuildComputePipelineKey(const FastCG::VulkanPipelineDescription &rPipelineDescription,
+                                 FastCG::VulkanObjectKey &rKey)
     {
-        return (size_t)FastCG::FNV1a(reinterpret_cast<const uint8_t *>(&rPipelineDescription),
-                                     sizeof(rPipelineDescription));
+        rKey.Clear();
+        rKey.Append(rPipelineDescription.pShader);
     }
 
-    size_t GetPipelineLayoutHash(const FastCG::VulkanPipelineLayoutDescription &rPipelineLayoutDescription)
+    void BuildPipelineLayoutKey(const FastCG::VulkanPipelineLayoutDescription &rPipelineLayoutDescription,
+                                FastCG::VulkanObjectKey &rKey)
     {
         assert(rPipelineLayoutDescription.setLayoutCount > 0);
-        return (size_t)FastCG::FNV1a(reinterpret_cast<const uint8_t *>(&rPipelineLayoutDescription.pSetLayouts[0]),
-                                     rPipelineLayoutDescription.setLayoutCount *
-                                         sizeof(rPipelineLayoutDescription.pSetLayouts[0]));
+        rKey.Clear();
+        rKey.Append(rPipelineLayoutDescription.setLayoutCount);
+        for (uint32_t i = 0; i < rPipelineLayoutDescription.setLayoutCount; ++i)
+        {
+            const auto &rSetLayout = rPipelineLayoutDescription.pSetLayouts[i];
+            rKey.Append(rSetLayout.bindingLayoutCount);
+            rKey.Append(rSetLayout.pBindingLayouts, rSetLayout.bindingLayoutCount);
+        }
     }
 
-    size_t GetDescriptorSetLayoutHash(const FastCG::VulkanDescriptorSetLayout &rDescriptorSetLayout)
+    void BuildDescriptorSetLayoutKey(const FastCG::VulkanDescriptorSetLayout &rDescriptorSetLayout,
+                                     FastCG::VulkanObjectKey &rKey)
     {
         assert(rDescriptorSetLayout.bindingLayoutCount > 0);
-        return (size_t)FastCG::FNV1a(reinterpret_cast<const uint8_t *>(&rDescriptorSetLayout.pBindingLayouts[0]),
-                                     rDescriptorSetLayout.bindingLayoutCount *
-                                         sizeof(rDescriptorSetLayout.pBindingLayouts[0]));
+        rKey.Clear();
+        rKey.Append(rDescriptorSetLayout.pBindingLayouts, rDescriptorSetLayout.bindingLayoutCount);
+    }
+
+    void BuildDescriptorSetKey(VkDescriptorSetLayout setLayout, const VkWriteDescriptorSet *pSetWrites,
+                               uint32_t setWriteCount, FastCG::VulkanObjectKey &rKey)
+    {
+        rKey.Clear();
+        rKey.Append(setLayout);
+        for (uint32_t i = 0; i < setWriteCount; ++i)
+        {
+            const auto &rSetWrite = pSetWrites[i];
+            rKey.Append(rSetWrite.dstBinding);
+            rKey.Append(rSetWrite.descriptorType);
+            // info structs have padding, so append their members
+            if (rSetWrite.pImageInfo != nullptr)
+            {
+                rKey.Append(rSetWrite.pImageInfo->sampler);
+                rKey.Append(rSetWrite.pImageInfo->imageView);
+                rKey.Append(rSetWrite.pImageInfo->imageLayout);
+            }
+            if (rSetWrite.pBufferInfo != nullptr)
+            {
+                rKey.Append(rSetWrite.pBufferInfo->buffer);
+                rKey.Append(rSetWrite.pBufferInfo->offset);
+                rKey.Append(rSetWrite.pBufferInfo->range);
+            }
+        }
     }
 
 #if defined FASTCG_LINUX
@@ -260,6 +380,16 @@ extern const uint8_t APPLICATION_MINOR_VERSION;
 extern const uint8_t APPLICATION_PATCH_VERSION;
 extern const char *const APPLICATION_NAME;
 
+namespace
+{
+    std::filesystem::path GetPipelineCachePath()
+    {
+        return FastCG::Application::GetInstance()->GetDataPath() / "cache" /
+               (std::string(APPLICATION_NAME) + "_VulkanPipelineCache.bin");
+    }
+
+}
+
 namespace FastCG
 {
 #define FASTCG_IMPL_VK_EXT_FN(fn) PFN_##fn fn = nullptr
@@ -299,6 +429,7 @@ namespace FastCG
 #endif
         SelectPhysicalDevice();
         AcquirePhysicalDeviceProperties();
+        SelectDedicatedQueueFamilies();
         CreateDeviceAndGetQueues();
         CreateAllocator();
         CreateSynchronizationObjects();
@@ -308,6 +439,8 @@ namespace FastCG
         BeginCurrentCommandBuffer();
         ResetQueryPool();
         CreateImmediateGraphicsContext();
+        CreateStagingRing();
+        CreatePipelineCache();
         CreateSurfacelessSwapChain();
     }
 
@@ -315,21 +448,27 @@ namespace FastCG
     {
         BaseGraphicsSystem::OnPreFinalize();
 
+        CancelPipelineCompileJobs();
+
         // wait for device to become idle
         FASTCG_CHECK_VK_RESULT(vkDeviceWaitIdle(mDevice));
+
+        DestroyStagingRing();
+        SavePipelineCache();
     }
 
     void VulkanGraphicsSystem::OnPostFinalize()
     {
         FinalizeDeferredDestroys();
         DestroyPipelines();
+        DestroyPipelineCache();
         DestroyPipelineLayouts();
         DestroyFrameBuffers();
         DestroyRenderPasses();
         DestroyDescriptorSetLayouts();
         DestroySwapChain();
         DestroyQueryPool();
-        DestroyDescriptorPool();
+        DestroyDescriptorPools();
         DestroyCommandPoolAndCommandBuffers();
         DestroySynchronizationObjects();
         DestroyAllocator();
@@ -344,6 +483,30 @@ namespace FastCG
         BaseGraphicsSystem::OnPostFinalize();
     }
 
+    void VulkanGraphicsSystem::ConstructShaders(const std::vector<VulkanShader::Args> &rArgs,
+                                                std::vector<VulkanShader *> &rShaders)
+    {
+        // shader module creation and reflection don't touch any shared state, so shaders are created in parallel
+        // (the worker threads are only used for command recording at the end of a frame)
+        GetThreadPool()->ParallelFor(rArgs.size(), [&](size_t i, uint32_t threadIdx) {
+            FASTCG_UNUSED(threadIdx);
+            rShaders[i] = new VulkanShader(rArgs[i]);
+        });
+
+        // compute pipelines only depend on their shader, so they can be compiled right away
+        std::vector<VulkanPipelineDescription> computePipelineDescriptions;
+        for (const auto *pShader : rShaders)
+        {
+            if (pShader->GetModule(ShaderType::COMPUTE) != VK_NULL_HANDLE)
+            {
+                VulkanPipelineDescription pipelineDescription{};
+                pipelineDescription.pShader = pShader;
+                computePipelineDescriptions.emplace_back(pipelineDescription);
+            }
+        }
+        PrewarmComputePipelines(computePipelineDescriptions);
+    }
+
     void VulkanGraphicsSystem::CreateInstance()
     {
         VkApplicationInfo applicationInfo;
@@ -601,6 +764,8 @@ namespace FastCG
     {
         vkGetPhysicalDeviceProperties(mPhysicalDevice, &mPhysicalDeviceProperties);
 
+        vkGetPhysicalDeviceFeatures(mPhysicalDevice, &mPhysicalDeviceFeatures);
+
         vkGetPhysicalDeviceMemoryProperties(mPhysicalDevice, &mPhysicalDeviceMemoryProperties);
 
         for (VkFormat format = VK_FORMAT_UNDEFINED; format < LAST_FORMAT; format = (VkFormat)(((size_t)format) + 1))
@@ -701,17 +866,65 @@ namespace FastCG
         }
     }
 
+    void VulkanGraphicsSystem::SelectDedicatedQueueFamilies()
+    {
+        uint32_t queueFamiliesCount;
+        vkGetPhysicalDeviceQueueFamilyProperties(mPhysicalDevice, &queueFamiliesCount, nullptr);
+
+        std::vector<VkQueueFamilyProperties> queueFamiliesProperties(queueFamiliesCount);
+        vkGetPhysicalDeviceQueueFamilyProperties(mPhysicalDevice, &queueFamiliesCount, &queueFamiliesProperties[0]);
+
+        mQueueFamilyIndices = {mQueueFamilyIdx};
+        for (uint32_t queueFamilyIdx = 0; queueFamilyIdx < queueFamiliesCount; ++queueFamilyIdx)
+        {
+            auto queueFlags = queueFamiliesProperties[queueFamilyIdx].queueFlags;
+            if ((queueFlags & VK_QUEUE_GRAPHICS_BIT) != 0)
+            {
+                continue;
+            }
+
+            QueueType queueType;
+            if ((queueFlags & VK_QUEUE_COMPUTE_BIT) != 0)
+            {
+                queueType = QueueType::COMPUTE;
+            }
+            else if ((queueFlags & VK_QUEUE_TRANSFER_BIT) != 0)
+            {
+                queueType = QueueType::TRANSFER;
+            }
+            else
+            {
+                continue;
+            }
+
+            auto &rDedicatedQueue = mDedicatedQueues[(size_t)queueType];
+            if (rDedicatedQueue.familyIdx != ~0u)
+            {
+                continue;
+            }
+            rDedicatedQueue.familyIdx = queueFamilyIdx;
+            mQueueFamilyIndices.emplace_back(queueFamilyIdx);
+
+            FASTCG_LOG_DEBUG(VulkanGraphicsSystem, "Dedicated queue family found (type: %s, index: %u)",
+                             GetQueueTypeString(queueType), queueFamilyIdx);
+        }
+    }
+
     void VulkanGraphicsSystem::CreateDeviceAndGetQueues()
     {
         static const float sc_queuePriorities[] = {1.f};
 
-        VkDeviceQueueCreateInfo deviceQueueCreateInfo;
-        deviceQueueCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
-        deviceQueueCreateInfo.pNext = nullptr;
-        deviceQueueCreateInfo.flags = 0;
-        deviceQueueCreateInfo.queueFamilyIndex = mQueueFamilyIdx;
-        deviceQueueCreateInfo.queueCount = 1;
-        deviceQueueCreateInfo.pQueuePriorities = sc_queuePriorities;
+        std::vector<VkDeviceQueueCreateInfo> deviceQueueCreateInfos(mQueueFamilyIndices.size());
+        for (size_t i = 0; i < mQueueFamilyIndices.size(); ++i)
+        {
+            auto &rDeviceQueueCreateInfo = deviceQueueCreateInfos[i];
+            rDeviceQueueCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+            rDeviceQueueCreateInfo.pNext = nullptr;
+            rDeviceQueueCreateInfo.flags = 0;
+            rDeviceQueueCreateInfo.queueFamilyIndex = mQueueFamilyIndices[i];
+            rDeviceQueueCreateInfo.queueCount = 1;
+            rDeviceQueueCreateInfo.pQueuePriorities = sc_queuePriorities;
+        }
 
         if (!Contains(mPhysicalDeviceExtensionProperties, "VK_KHR_swapchain"))
         {
@@ -725,18 +938,45 @@ namespace FastCG
         }
         mPhysicalDeviceExtensions.push_back("VK_KHR_create_renderpass2");
 
+        // optional features
+        mEnabledPhysicalDeviceFeatures = {};
+        mEnabledPhysicalDeviceFeatures.multiDrawIndirect = mPhysicalDeviceFeatures.multiDrawIndirect;
+
+        VkPhysicalDeviceImagelessFramebufferFeaturesKHR imagelessFramebufferFeatures;
+        imagelessFramebufferFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_IMAGELESS_FRAMEBUFFER_FEATURES_KHR;
+        imagelessFramebufferFeatures.pNext = nullptr;
+        imagelessFramebufferFeatures.imagelessFramebuffer = VK_FALSE;
+        // VK_KHR_imageless_framebuffer depends on VK_KHR_image_format_list (and VK_KHR_maintenance2, core in 1.1)
+        if (Contains(mPhysicalDeviceExtensionProperties, "VK_KHR_imageless_framebuffer") &&
+            Contains(mPhysicalDeviceExtensionProperties, "VK_KHR_image_format_list"))
+        {
+            VkPhysicalDeviceFeatures2 physicalDeviceFeatures2;
+            physicalDeviceFeatures2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+            physicalDeviceFeatures2.pNext = &imagelessFramebufferFeatures;
+            vkGetPhysicalDeviceFeatures2(mPhysicalDevice, &physicalDeviceFeatures2);
+        }
+        mImagelessFrameBufferSupported = imagelessFramebufferFeatures.imagelessFramebuffer == VK_TRUE;
+        if (mImagelessFrameBufferSupported)
+        {
+            mPhysicalDeviceExtensions.push_back("VK_KHR_image_format_list");
+            mPhysicalDeviceExtensions.push_back("VK_KHR_imageless_framebuffer");
+        }
+
+        FASTCG_LOG_DEBUG(VulkanGraphicsSystem, "Imageless frame buffers: %s",
+                         mImagelessFrameBufferSupported ? "supported" : "not supported");
+
         VkDeviceCreateInfo deviceCreateInfo;
         deviceCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
-        deviceCreateInfo.pNext = nullptr;
+        deviceCreateInfo.pNext = mImagelessFrameBufferSupported ? &imagelessFramebufferFeatures : nullptr;
         deviceCreateInfo.flags = 0;
-        deviceCreateInfo.queueCreateInfoCount = 1;
-        deviceCreateInfo.pQueueCreateInfos = &deviceQueueCreateInfo;
+        deviceCreateInfo.queueCreateInfoCount = (uint32_t)deviceQueueCreateInfos.size();
+        deviceCreateInfo.pQueueCreateInfos = &deviceQueueCreateInfos[0];
         deviceCreateInfo.enabledExtensionCount = (uint32_t)mPhysicalDeviceExtensions.size();
         deviceCreateInfo.ppEnabledExtensionNames =
             mPhysicalDeviceExtensions.empty() ? nullptr : &mPhysicalDeviceExtensions[0];
         deviceCreateInfo.enabledLayerCount = 0;
         deviceCreateInfo.ppEnabledLayerNames = nullptr;
-        deviceCreateInfo.pEnabledFeatures = nullptr;
+        deviceCreateInfo.pEnabledFeatures = &mEnabledPhysicalDeviceFeatures;
 
         FASTCG_CHECK_VK_RESULT(
             vkCreateDevice(mPhysicalDevice, &deviceCreateInfo, mAllocationCallbacks.get(), &mDevice));
@@ -744,6 +984,13 @@ namespace FastCG
         LoadVulkanDeviceExtensionFunctions(mDevice);
 
         vkGetDeviceQueue(mDevice, mQueueFamilyIdx, 0, &mQueue);
+        for (auto &rDedicatedQueue : mDedicatedQueues)
+        {
+            if (rDedicatedQueue.familyIdx != ~0u)
+            {
+                vkGetDeviceQueue(mDevice, rDedicatedQueue.familyIdx, 0, &rDedicatedQueue.queue);
+            }
+        }
     }
 
     void VulkanGraphicsSystem::RecreateSwapChain()
@@ -823,6 +1070,7 @@ namespace FastCG
             const auto &rSwapChainImage = swapChainImages[i];
             args.name = "Surface SwapChain Image " + std::to_string(i);
             args.image = rSwapChainImage;
+            args.imageUsage = swapChainCreateInfo.imageUsage;
             mSwapChainTextures.emplace_back(CreateTexture(args));
         }
 
@@ -887,6 +1135,20 @@ namespace FastCG
             FASTCG_CHECK_VK_RESULT(vkCreateSemaphore(mDevice, &semaphoreCreateInfo, mAllocationCallbacks.get(),
                                                      &mSubmitFinishedSemaphores[i]));
         }
+
+        for (auto &rDedicatedQueue : mDedicatedQueues)
+        {
+            if (rDedicatedQueue.queue == VK_NULL_HANDLE)
+            {
+                continue;
+            }
+            rDedicatedQueue.submitFinishedSemaphores.resize(mMaxSimultaneousFrames);
+            for (auto &rSemaphore : rDedicatedQueue.submitFinishedSemaphores)
+            {
+                FASTCG_CHECK_VK_RESULT(
+                    vkCreateSemaphore(mDevice, &semaphoreCreateInfo, mAllocationCallbacks.get(), &rSemaphore));
+            }
+        }
     }
 
     void VulkanGraphicsSystem::CreateCommandPoolAndCommandBuffers()
@@ -907,36 +1169,107 @@ namespace FastCG
         commandBufferAllocateInfo.commandBufferCount = mMaxSimultaneousFrames;
         mCommandBuffers.resize(mMaxSimultaneousFrames);
         FASTCG_CHECK_VK_RESULT(vkAllocateCommandBuffers(mDevice, &commandBufferAllocateInfo, &mCommandBuffers[0]));
+
+        for (auto &rDedicatedQueue : mDedicatedQueues)
+        {
+            if (rDedicatedQueue.queue == VK_NULL_HANDLE)
+            {
+                continue;
+            }
+            commandPoolCreateInfo.queueFamilyIndex = rDedicatedQueue.familyIdx;
+            FASTCG_CHECK_VK_RESULT(vkCreateCommandPool(mDevice, &commandPoolCreateInfo, mAllocationCallbacks.get(),
+                                                       &rDedicatedQueue.commandPool));
+            commandBufferAllocateInfo.commandPool = rDedicatedQueue.commandPool;
+            rDedicatedQueue.commandBuffers.resize(mMaxSimultaneousFrames);
+            FASTCG_CHECK_VK_RESULT(
+                vkAllocateCommandBuffers(mDevice, &commandBufferAllocateInfo, &rDedicatedQueue.commandBuffers[0]));
+        }
+
+        // one pool per worker thread plus one for the render thread (which also records)
+        auto threadCount = GetThreadPool()->GetThreadCount();
+
+        // command buffers are reset in bulk with their pool at the start of the frame
+        commandPoolCreateInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+        commandPoolCreateInfo.queueFamilyIndex = mQueueFamilyIdx;
+        mSecondaryCommandBufferPools.resize(mMaxSimultaneousFrames * (threadCount + 1));
+        for (auto &rSecondaryCommandBufferPool : mSecondaryCommandBufferPools)
+        {
+            FASTCG_CHECK_VK_RESULT(vkCreateCommandPool(mDevice, &commandPoolCreateInfo, mAllocationCallbacks.get(),
+                                                       &rSecondaryCommandBufferPool.commandPool));
+        }
+
+        FASTCG_LOG_DEBUG(VulkanGraphicsSystem, "Secondary command buffer pools created (count: %zu)",
+                         mSecondaryCommandBufferPools.size());
+    }
+
+    VkCommandBuffer VulkanGraphicsSystem::AcquireSecondaryCommandBuffer(uint32_t threadIdx)
+    {
+        assert(threadIdx <= GetThreadPool()->GetThreadCount());
+        auto &rSecondaryCommandBufferPool =
+            mSecondaryCommandBufferPools[mCurrentFrame * (GetThreadPool()->GetThreadCount() + 1) +
+                                         threadIdx];
+        if (rSecondaryCommandBufferPool.nextCommandBufferIdx == rSecondaryCommandBufferPool.commandBuffers.size())
+        {
+            VkCommandBufferAllocateInfo commandBufferAllocateInfo;
+            commandBufferAllocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            commandBufferAllocateInfo.pNext = nullptr;
+            commandBufferAllocateInfo.commandPool = rSecondaryCommandBufferPool.commandPool;
+            commandBufferAllocateInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+            commandBufferAllocateInfo.commandBufferCount = 1;
+            VkCommandBuffer commandBuffer;
+            FASTCG_CHECK_VK_RESULT(vkAllocateCommandBuffers(mDevice, &commandBufferAllocateInfo, &commandBuffer));
+            rSecondaryCommandBufferPool.commandBuffers.emplace_back(commandBuffer);
+        }
+        return rSecondaryCommandBufferPool.commandBuffers[rSecondaryCommandBufferPool.nextCommandBufferIdx++];
+    }
+
+    void VulkanGraphicsSystem::ResetSecondaryCommandBufferPools()
+    {
+        auto poolCount = GetThreadPool()->GetThreadCount() + 1;
+        for (uint32_t i = 0; i < poolCount; ++i)
+        {
+            auto &rSecondaryCommandBufferPool = mSecondaryCommandBufferPools[mCurrentFrame * poolCount + i];
+            if (rSecondaryCommandBufferPool.nextCommandBufferIdx == 0)
+            {
+                continue;
+            }
+            FASTCG_CHECK_VK_RESULT(vkResetCommandPool(mDevice, rSecondaryCommandBufferPool.commandPool, 0));
+            rSecondaryCommandBufferPool.nextCommandBufferIdx = 0;
+        }
     }
 
-    void VulkanGraphicsSystem::CreateDescriptorPool()
+    VkDescriptorPool VulkanGraphicsSystem::CreateDescriptorPool()
     {
-// TODO: make this less brittle and possibly dynamic
 #if defined FASTCG_ANDROID
-        const size_t MAX_LOCAL_POOL_COUNT = 64;
-        const size_t DESCRIPTOR_TYPE_COUNT = 64;
+        const uint32_t MAX_SET_COUNT = 4096;
 #else
-        const size_t MAX_LOCAL_POOL_COUNT = 16;
-        const size_t DESCRIPTOR_TYPE_COUNT = 16;
+        const uint32_t MAX_SET_COUNT = 1024;
 #endif
+        // average number of descriptors of each type per set
+        const uint32_t DESCRIPTOR_TYPE_COUNT = 4;
         const VkDescriptorPoolSize DESCRIPTOR_POOL_SIZES[] = {
-            {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-             VulkanDescriptorSetLocalPool::MAX_SET_COUNT * DESCRIPTOR_TYPE_COUNT},
-            {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VulkanDescriptorSetLocalPool::MAX_SET_COUNT * DESCRIPTOR_TYPE_COUNT},
-            {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VulkanDescriptorSetLocalPool::MAX_SET_COUNT * DESCRIPTOR_TYPE_COUNT}};
+            {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, MAX_SET_COUNT * DESCRIPTOR_TYPE_COUNT},
+            {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, MAX_SET_COUNT * DESCRIPTOR_TYPE_COUNT},
+            {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, MAX_SET_COUNT * DESCRIPTOR_TYPE_COUNT},
+            {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, MAX_SET_COUNT * DESCRIPTOR_TYPE_COUNT}};
 
         VkDescriptorPoolCreateInfo descriptorPoolCreateInfo;
         descriptorPoolCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
         descriptorPoolCreateInfo.pNext = nullptr;
+        // evicted sets are freed individually
         descriptorPoolCreateInfo.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
-        descriptorPoolCreateInfo.maxSets =
-            VulkanDescriptorSetLocalPool::MAX_SET_COUNT * MAX_LOCAL_POOL_COUNT * mMaxSimultaneousFrames;
+        descriptorPoolCreateInfo.maxSets = MAX_SET_COUNT;
         descriptorPoolCreateInfo.poolSizeCount = (uint32_t)FASTCG_ARRAYSIZE(DESCRIPTOR_POOL_SIZES);
         descriptorPoolCreateInfo.pPoolSizes = DESCRIPTOR_POOL_SIZES;
+        VkDescriptorPool descriptorPool;
         FASTCG_CHECK_VK_RESULT(
-            vkCreateDescriptorPool(mDevice, &descriptorPoolCreateInfo, mAllocationCallbacks.get(), &mDescriptorPool));
+            vkCreateDescriptorPool(mDevice, &descriptorPoolCreateInfo, mAllocationCallbacks.get(), &descriptorPool));
+
+        mDescriptorPools.emplace_back(descriptorPool);
+
+        FASTCG_LOG_DEBUG(VulkanGraphicsSystem, "Descriptor pool created (count: %zu)", mDescriptorPools.size());
 
-        mDescriptorSetLocalPools.resize(mMaxSimultaneousFrames);
+        return descriptorPool;
     }
 
     void VulkanGraphicsSystem::CreateQueryPool()
@@ -984,50 +1317,241 @@ namespace FastCG
         mpImmediateGraphicsContext->Begin();
     }
 
+    void VulkanGraphicsSystem::CreateStagingRing()
+    {
+        if (mArgs.stagingBufferSize == 0)
+        {
+            return;
+        }
+
+        // a multi-frame dynamic buffer gives us one persistently mapped region per frame in flight
+        mpStagingRing = CreateBuffer({"Staging Ring", BufferUsageFlagBit::DYNAMIC, mArgs.stagingBufferSize});
+        // base alignment of all staged copies (copies into images are further aligned to their texel block size)
+        mStagingRingAlignment =
+            std::max((size_t)mPhysicalDeviceProperties.limits.optimalBufferCopyOffsetAlignment, (size_t)16);
+        mStagingRingOffset = 0;
+    }
+
+    void VulkanGraphicsSystem::CreatePipelineCache()
+    {
+        // a cache written by another device or driver is rejected, so the pipeline cache starts from scratch
+        size_t fileSize;
+        auto pFileData = FileReader::ReadBinary(GetPipelineCachePath(), fileSize);
+        size_t initialDataSize = 0;
+        const void *pInitialData = nullptr;
+        if (pFileData != nullptr && fileSize >= sizeof(PipelineCacheFileHeader))
+        {
+            PipelineCacheFileHeader header;
+            std::memcpy(&header, pFileData.get(), sizeof(header));
+            if (IsPipelineCacheFileHeaderValid(header, mPhysicalDeviceProperties) &&
+                fileSize - sizeof(header) == header.dataSize)
+            {
+                initialDataSize = (size_t)header.dataSize;
+                pInitialData = pFileData.get() + sizeof(header);
+            }
+            else
+            {
+                FASTCG_LOG_DEBUG(VulkanGraphicsSystem, "Discarding incompatible pipeline cache");
+            }
+        }
+
+        VkPipelineCacheCreateInfo pipelineCacheCreateInfo;
+        pipelineCacheCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+        pipelineCacheCreateInfo.pNext = nullptr;
+        pipelineCacheCreateInfo.flags = 0;
+        pipelineCacheCreateInfo.initialDataSize = initialDataSize;
+        pipelineCacheCreateInfo.pInitialData = pInitialData;
+        FASTCG_CHECK_VK_RESULT(vkCreatePipelineCache(mDevice, &pipelineCacheCreateInfo, mAllocationCallbacks.get(),
+                                                     &mPipelineCache));
+
+        FASTCG_LOG_DEBUG(VulkanGraphicsSystem, "Pipeline cache created (initial data: %zu bytes)", initialDataSize);
+    }
+
     void VulkanGraphicsSystem::EndCurrentCommandBuffer()
     {
         FASTCG_CHECK_VK_RESULT(vkEndCommandBuffer(mCommandBuffers[mCurrentFrame]));
     }
 
+    VkCommandBuffer VulkanGraphicsSystem::GetCurrentCommandBuffer(QueueType queueType)
+    {
+        if (!HasDedicatedQueue(queueType))
+        {
+            return GetCurrentCommandBuffer();
+        }
+
+        auto &rDedicatedQueue = mDedicatedQueues[(size_t)queueType];
+        auto commandBuffer = rDedicatedQueue.commandBuffers[mCurrentFrame];
+        if (!rDedicatedQueue.recording)
+        {
+            // the graphics work of the frame that last used it waited on it
+            FASTCG_CHECK_VK_RESULT(vkResetCommandBuffer(commandBuffer, 0));
+
+            VkCommandBufferBeginInfo commandBufferBeginInfo;
+            commandBufferBeginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+            commandBufferBeginInfo.pNext = nullptr;
+            commandBufferBeginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+            commandBufferBeginInfo.pInheritanceInfo = nullptr;
+            FASTCG_CHECK_VK_RESULT(vkBeginCommandBuffer(commandBuffer, &commandBufferBeginInfo));
+
+            rDedicatedQueue.recording = true;
+        }
+        return commandBuffer;
+    }
+
+    void VulkanGraphicsSystem::SubmitDedicatedQueues(std::vector<VkSemaphore> &rWaitSemaphores,
+                                                     std::vector<VkPipelineStageFlags> &rWaitDstStageMasks)
+    {
+        for (auto &rDedicatedQueue : mDedicatedQueues)
+        {
+            if (!rDedicatedQueue.recording)
+            {
+                continue;
+            }
+
+            FASTCG_CHECK_VK_RESULT(vkEndCommandBuffer(rDedicatedQueue.commandBuffers[mCurrentFrame]));
+
+            VkSubmitInfo submitInfo;
+            submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+            submitInfo.pNext = nullptr;
+            submitInfo.waitSemaphoreCount = 0;
+            submitInfo.pWaitSemaphores = nullptr;
+            submitInfo.pWaitDstStageMask = nullptr;
+            submitInfo.commandBufferCount = 1;
+            submitInfo.pCommandBuffers = &rDedicatedQueue.commandBuffers[mCurrentFrame];
+            submitInfo.signalSemaphoreCount = 1;
+            submitInfo.pSignalSemaphores = &rDedicatedQueue.submitFinishedSemaphores[mCurrentFrame];
+            // no fence, the frame fence is signaled after the graphics work, which waits on this one
+            FASTCG_CHECK_VK_RESULT(vkQueueSubmit(rDedicatedQueue.queue, 1, &submitInfo, VK_NULL_HANDLE));
+
+            rWaitSemaphores.emplace_back(rDedicatedQueue.submitFinishedSemaphores[mCurrentFrame]);
+            rWaitDstStageMasks.emplace_back(VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+
+            rDedicatedQueue.recording = false;
+        }
+    }
+
     void VulkanGraphicsSystem::DestroyFrameBuffers()
     {
-        std::for_each(mFrameBuffers.begin(), mFrameBuffers.end(), [&](const auto &rEntry) {
-            vkDestroyFramebuffer(mDevice, rEntry.second, mAllocationCallbacks.get());
+        mFrameBuffers.ForEach([&](auto frameBuffer) {
+            vkDestroyFramebuffer(mDevice, frameBuffer, mAllocationCallbacks.get());
         });
-        mFrameBuffers.clear();
-        mRenderTargetToFrameBufferHash.clear();
+        mFrameBuffers.Clear();
+        mRenderTargetToFrameBuffers.clear();
+        mFrameBufferEntries.clear();
     }
 
     void VulkanGraphicsSystem::DestroyRenderPasses()
     {
-        std::for_each(mRenderPasses.begin(), mRenderPasses.end(), [&](const auto &rEntry) {
-            vkDestroyRenderPass(mDevice, rEntry.second, mAllocationCallbacks.get());
+        mRenderPasses.ForEach([&](auto renderPass) {
+            vkDestroyRenderPass(mDevice, renderPass, mAllocationCallbacks.get());
         });
-        mRenderPasses.clear();
+        mRenderPasses.Clear();
+        mCompatibleRenderPasses.Clear();
     }
 
     void VulkanGraphicsSystem::DestroyPipelineLayouts()
     {
-        std::for_each(mPipelineLayouts.begin(), mPipelineLayouts.end(), [&](const auto &rEntry) {
-            vkDestroyPipelineLayout(mDevice, rEntry.second, mAllocationCallbacks.get());
+        mPipelineLayouts.ForEach([&](auto pipelineLayout) {
+            vkDestroyPipelineLayout(mDevice, pipelineLayout, mAllocationCallbacks.get());
         });
-        mPipelineLayouts.clear();
+        mPipelineLayouts.Clear();
     }
 
     void VulkanGraphicsSystem::DestroyPipelines()
     {
-        std::for_each(mPipelines.begin(), mPipelines.end(), [&](const auto &rEntry) {
-            vkDestroyPipeline(mDevice, rEntry.second, mAllocationCallbacks.get());
+        mPipelines.ForEach([&](auto pipeline) {
+            if (pipeline != VK_NULL_HANDLE)
+            {
+                vkDestroyPipeline(mDevice, pipeline, mAllocationCallbacks.get());
+            }
         });
-        mPipelines.clear();
+        mPipelines.Clear();
+    }
+
+    void VulkanGraphicsSystem::DestroyStagingRing()
+    {
+        if (mpStagingRing == nullptr)
+        {
+            return;
+        }
+
+        // device is idle, no need to defer
+        Super::DestroyBuffer(mpStagingRing);
+        mpStagingRing = nullptr;
+    }
+
+    void VulkanGraphicsSystem::SavePipelineCache()
+    {
+        if (mPipelineCache == VK_NULL_HANDLE)
+        {
+            return;
+        }
+
+        size_t dataSize;
+        FASTCG_CHECK_VK_RESULT(vkGetPipelineCacheData(mDevice, mPipelineCache, &dataSize, nullptr));
+        if (dataSize == 0)
+        {
+            return;
+        }
+
+        auto header = CreatePipelineCacheFileHeader(mPhysicalDeviceProperties);
+        std::vector<uint8_t> fileData(sizeof(header) + dataSize);
+        FASTCG_CHECK_VK_RESULT(
+            vkGetPipelineCacheData(mDevice, mPipelineCache, &dataSize, fileData.data() + sizeof(header)));
+        header.dataSize = (uint64_t)dataSize;
+        std::memcpy(fileData.data(), &header, sizeof(header));
+
+        // failing to persist the cache only costs pipeline compilations on the next run
+        try
+        {
+            FileWriter::WriteBinary(GetPipelineCachePath(), fileData.data(), sizeof(header) + dataSize);
+        }
+        catch (const std::exception &rException)
+        {
+            FASTCG_UNUSED(rException);
+            FASTCG_LOG_DEBUG(VulkanGraphicsSystem, "Couldn't save pipeline cache: %s", rException.what());
+        }
+    }
+
+    void VulkanGraphicsSystem::CancelPipelineCompileJobs()
+    {
+        std::unique_lock<std::mutex> lock(mPipelineCompileMutex);
+        // queued pipelines are never compiled and their placeholders are ignored by DestroyPipelines()
+        // (the pool tasks that would've compiled them find the queue empty)
+        mPendingPipelineCompileJobCount -= mQueuedPipelineCompileJobs.size();
+        mQueuedPipelineCompileJobs.clear();
+        // the ones being compiled still make it into the pipeline cache
+        mPipelineCompileJobDone.wait(
+            lock, [this]() { return mDonePipelineCompileJobs.size() == mPendingPipelineCompileJobCount; });
+        for (const auto &rpJob : mDonePipelineCompileJobs)
+        {
+            if (rpJob->pipeline != VK_NULL_HANDLE)
+            {
+                *mPipelines.Find(rpJob->hash, rpJob->key) = rpJob->pipeline;
+            }
+        }
+        mDonePipelineCompileJobs.clear();
+        mPendingPipelineCompileJobCount = 0;
+        mPendingPipelineCompileJobCountPerShader.clear();
+    }
+
+    void VulkanGraphicsSystem::DestroyPipelineCache()
+    {
+        if (mPipelineCache == VK_NULL_HANDLE)
+        {
+            return;
+        }
+
+        vkDestroyPipelineCache(mDevice, mPipelineCache, mAllocationCallbacks.get());
+        mPipelineCache = VK_NULL_HANDLE;
     }
 
     void VulkanGraphicsSystem::DestroyDescriptorSetLayouts()
     {
-        std::for_each(mDescriptorSetLayouts.begin(), mDescriptorSetLayouts.end(), [&](const auto &rEntry) {
-            vkDestroyDescriptorSetLayout(mDevice, rEntry.second, mAllocationCallbacks.get());
+        mDescriptorSetLayouts.ForEach([&](auto setLayout) {
+            vkDestroyDescriptorSetLayout(mDevice, setLayout, mAllocationCallbacks.get());
         });
-        mDescriptorSetLayouts.clear();
+        mDescriptorSetLayouts.Clear();
     }
 
     void VulkanGraphicsSystem::DestroyQueryPool()
@@ -1039,17 +1563,42 @@ namespace FastCG
         mQueryPools.clear();
     }
 
-    void VulkanGraphicsSystem::DestroyDescriptorPool()
+    void VulkanGraphicsSystem::DestroyDescriptorPools()
     {
-        if (mDescriptorPool != VK_NULL_HANDLE)
+        // cached sets are freed along with their pools
+        mDescriptorSets.Clear();
+        mDescriptorSetLru.clear();
+        mResourceToDescriptorSets.clear();
+        for (auto descriptorPool : mDescriptorPools)
         {
-            vkDestroyDescriptorPool(mDevice, mDescriptorPool, mAllocationCallbacks.get());
-            mDescriptorPool = VK_NULL_HANDLE;
+            vkDestroyDescriptorPool(mDevice, descriptorPool, mAllocationCallbacks.get());
         }
+        mDescriptorPools.clear();
+        mDescriptorPoolHint = 0;
     }
 
     void VulkanGraphicsSystem::DestroyCommandPoolAndCommandBuffers()
     {
+        for (auto &rSecondaryCommandBufferPool : mSecondaryCommandBufferPools)
+        {
+            // freed along with their pool
+            vkDestroyCommandPool(mDevice, rSecondaryCommandBufferPool.commandPool, mAllocationCallbacks.get());
+        }
+        mSecondaryCommandBufferPools.clear();
+
+        for (auto &rDedicatedQueue : mDedicatedQueues)
+        {
+            if (rDedicatedQueue.commandPool == VK_NULL_HANDLE)
+            {
+                continue;
+            }
+            // command buffers are freed along with their pool
+            vkDestroyCommandPool(mDevice, rDedicatedQueue.commandPool, mAllocationCallbacks.get());
+            rDedicatedQueue.commandPool = VK_NULL_HANDLE;
+            rDedicatedQueue.commandBuffers.clear();
+            rDedicatedQueue.recording = false;
+        }
+
         if (mCommandPool != VK_NULL_HANDLE)
         {
             if (!mCommandBuffers.empty())
@@ -1073,6 +1622,15 @@ namespace FastCG
         mAcquireSurfaceSwapChainImageSemaphores.clear();
         mSubmitFinishedSemaphores.clear();
         mFrameFences.clear();
+
+        for (auto &rDedicatedQueue : mDedicatedQueues)
+        {
+            for (auto semaphore : rDedicatedQueue.submitFinishedSemaphores)
+            {
+                vkDestroySemaphore(mDevice, semaphore, mAllocationCallbacks.get());
+            }
+            rDedicatedQueue.submitFinishedSemaphores.clear();
+        }
     }
 
     void VulkanGraphicsSystem::DestroySwapChain()
@@ -1100,6 +1658,13 @@ namespace FastCG
         mQueue = VK_NULL_HANDLE;
         mQueueFamilyIdx = ~0u;
         mQueueSupportsCompute = false;
+        mImagelessFrameBufferSupported = false;
+        for (auto &rDedicatedQueue : mDedicatedQueues)
+        {
+            rDedicatedQueue.queue = VK_NULL_HANDLE;
+            rDedicatedQueue.familyIdx = ~0u;
+        }
+        mQueueFamilyIndices.clear();
     }
 
     void VulkanGraphicsSystem::DestroyAllocator()
@@ -1155,22 +1720,22 @@ namespace FastCG
 
         EndCurrentCommandBuffer();
 
-        VkPipelineStageFlags waitDstStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT;
+        std::vector<VkSemaphore> waitSemaphores;
+        std::vector<VkPipelineStageFlags> waitDstStageMasks;
+        if (mSurface != VK_NULL_HANDLE)
+        {
+            waitSemaphores.emplace_back(mAcquireSurfaceSwapChainImageSemaphores[mCurrentFrame]);
+            waitDstStageMasks.emplace_back(VK_PIPELINE_STAGE_TRANSFER_BIT);
+        }
+
+        SubmitDedicatedQueues(waitSemaphores, waitDstStageMasks);
+
         VkSubmitInfo submitInfo;
         submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
         submitInfo.pNext = nullptr;
-        if (mSurface == VK_NULL_HANDLE)
-        {
-            submitInfo.waitSemaphoreCount = 0;
-            submitInfo.pWaitSemaphores = nullptr;
-            submitInfo.pWaitDstStageMask = nullptr;
-        }
-        else
-        {
-            submitInfo.waitSemaphoreCount = 1;
-            submitInfo.pWaitSemaphores = &mAcquireSurfaceSwapChainImageSemaphores[mCurrentFrame];
-            submitInfo.pWaitDstStageMask = &waitDstStageMask;
-        }
+        submitInfo.waitSemaphoreCount = (uint32_t)waitSemaphores.size();
+        submitInfo.pWaitSemaphores = waitSemaphores.empty() ? nullptr : &waitSemaphores[0];
+        submitInfo.pWaitDstStageMask = waitDstStageMasks.empty() ? nullptr : &waitDstStageMasks[0];
         submitInfo.commandBufferCount = 1;
         submitInfo.pCommandBuffers = &mCommandBuffers[mCurrentFrame];
         if (mSurface == VK_NULL_HANDLE)
@@ -1230,10 +1795,9 @@ namespace FastCG
 
         PerformDeferredDestroys();
 
-        for (auto &rEntry : mDescriptorSetLocalPools[mCurrentFrame])
-        {
-            rEntry.second.lastDescriptorSetIdx = 0;
-        }
+        mStagingRingOffset = 0;
+
+        ResetSecondaryCommandBufferPools();
 
         BeginCurrentCommandBuffer();
 
@@ -1272,7 +1836,7 @@ namespace FastCG
 #endif
     }
 
-    std::pair<size_t, VkRenderPass> VulkanGraphicsSystem::GetOrCreateRenderPass(
+    std::pair<uint64_t, VkRenderPass> VulkanGraphicsSystem::GetOrCreateRenderPass(
         const VulkanRenderPassDescription &rRenderPassDescription, bool depthWrite, bool stencilWrite)
     {
         std::vector<AttachmentDefinition> attachmentDefinitions;
@@ -1286,7 +1850,8 @@ namespace FastCG
 
             attachmentDefinitions.emplace_back();
             auto &rAttachmentDefinition = attachmentDefinitions.back();
-            rAttachmentDefinition.pTexture = pRenderTarget;
+            rAttachmentDefinition.format = pRenderTarget->GetVulkanFormat();
+            rAttachmentDefinition.finalLayout = pRenderTarget->GetRestingLayout();
 
             if ((rRenderPassDescription.colorClearRequests[i].flags & VulkanClearRequestFlagBit::COLOR_OR_DEPTH) != 0)
             {
@@ -1304,7 +1869,8 @@ namespace FastCG
         {
             attachmentDefinitions.emplace_back();
             auto &rAttachmentDefinition = attachmentDefinitions.back();
-            rAttachmentDefinition.pTexture = rRenderPassDescription.pDepthStencilBuffer;
+            rAttachmentDefinition.format = rRenderPassDescription.pDepthStencilBuffer->GetVulkanFormat();
+            rAttachmentDefinition.finalLayout = rRenderPassDescription.pDepthStencilBuffer->GetRestingLayout();
 
             if ((rRenderPassDescription.depthStencilClearRequest.flags & VulkanClearRequestFlagBit::COLOR_OR_DEPTH) !=
                 0)
@@ -1313,7 +1879,7 @@ namespace FastCG
             }
             else
             {
-                rAttachmentDefinition.stencil = VK_ATTACHMENT_LOAD_OP_LOAD;
+                rAttachmentDefinition.colorOrDepth = VK_ATTACHMENT_LOAD_OP_LOAD;
             }
 
             if (HasStencil(rRenderPassDescription.pDepthStencilBuffer->GetFormat()))
@@ -1335,11 +1901,11 @@ namespace FastCG
                 (depthWrite) + (stencilWrite << 1); // no write, write depth or write depth&stencil
         }
 
-        auto renderPassHash = GetRenderPassHash(attachmentDefinitions);
-        auto it = mRenderPasses.find(renderPassHash);
-        if (it != mRenderPasses.end())
+        BuildRenderPassKey(attachmentDefinitions, mRenderPassKey);
+        auto renderPassHash = mRenderPassKey.GetHash();
+        if (auto *pRenderPass = mRenderPasses.Find(renderPassHash, mRenderPassKey))
         {
-            return {it->first, it->second};
+            return {renderPassHash, *pRenderPass};
         }
 
         VkRenderPassCreateInfo2KHR renderPassCreateInfo;
@@ -1467,25 +2033,42 @@ namespace FastCG
         FASTCG_CHECK_VK_RESULT(
             VkExt::vkCreateRenderPass2KHR(mDevice, &renderPassCreateInfo, mAllocationCallbacks.get(), &renderPass));
 
-        it = mRenderPasses.emplace(renderPassHash, renderPass).first;
+        mRenderPasses.Add(renderPassHash, mRenderPassKey, renderPass);
 
-        return {it->first, it->second};
+        return {renderPassHash, renderPass};
     }
 
-    std::pair<size_t, VkFramebuffer> VulkanGraphicsSystem::GetOrCreateFrameBuffer(
+    VkRenderPass VulkanGraphicsSystem::GetOrCreateCompatibleRenderPass(
         const VulkanRenderPassDescription &rRenderPassDescription, bool depthWrite, bool stencilWrite)
     {
-        auto result = GetOrCreateRenderPass(rRenderPassDescription, depthWrite, stencilWrite);
+        BuildCompatibleRenderPassKey(rRenderPassDescription, mCompatibleRenderPassKey);
+        auto compatibleRenderPassHash = mCompatibleRenderPassKey.GetHash();
+        if (auto *pRenderPass = mCompatibleRenderPasses.Find(compatibleRenderPassHash, mCompatibleRenderPassKey))
+        {
+            return *pRenderPass;
+        }
 
-        std::vector<VkImageView> attachments;
+        auto renderPass = GetOrCreateRenderPass(rRenderPassDescription, depthWrite, stencilWrite).second;
+        mCompatibleRenderPasses.Add(compatibleRenderPassHash, mCompatibleRenderPassKey, renderPass);
+        return renderPass;
+    }
+
+    std::pair<uint64_t, VkFramebuffer> VulkanGraphicsSystem::GetOrCreateFrameBuffer(
+        const VulkanRenderPassDescription &rRenderPassDescription, bool depthWrite, bool stencilWrite)
+    {
+        // a frame buffer can be used with any render pass compatible with the one it was created with
+        auto renderPass = GetOrCreateCompatibleRenderPass(rRenderPassDescription, depthWrite, stencilWrite);
+
+        std::vector<const VulkanTexture *> renderTargets;
         auto width = std::numeric_limits<uint32_t>::max();
         auto height = std::numeric_limits<uint32_t>::max();
-        auto CalculateFramebufferDimensions = [&width, &height](const auto *pRenderTarget) {
+        auto AddRenderTarget = [&](const auto *pRenderTarget) {
             // according to VUID-VkFramebufferCreateInfo-flags-04533/0433, each element of pAttachments (...)
             // must have been created with a (...) width/height greater than or equal the width/height of the
             // framebuffer
             width = std::min(width, pRenderTarget->GetWidth());
             height = std::min(height, pRenderTarget->GetHeight());
+            renderTargets.emplace_back(pRenderTarget);
         };
 
         for (uint32_t i = 0; i < rRenderPassDescription.renderTargetCount; ++i)
@@ -1496,72 +2079,184 @@ namespace FastCG
                 continue;
             }
 
-            CalculateFramebufferDimensions(pRenderTarget);
-            attachments.emplace_back(pRenderTarget->GetDefaultImageView());
+            AddRenderTarget(pRenderTarget);
         }
 
         if (rRenderPassDescription.pDepthStencilBuffer != nullptr)
         {
-            CalculateFramebufferDimensions(rRenderPassDescription.pDepthStencilBuffer);
-            attachments.emplace_back(rRenderPassDescription.pDepthStencilBuffer->GetDefaultImageView());
+            AddRenderTarget(rRenderPassDescription.pDepthStencilBuffer);
         }
 
-        // FIXME: increased risk of hash collision!
-        auto frameBufferHash = GetFrameBufferHash(attachments) + result.first;
+        std::vector<VkImageView> attachments;
+        std::vector<VkFramebufferAttachmentImageInfoKHR> attachmentImageInfos;
+        if (mImagelessFrameBufferSupported)
+        {
+            for (const auto *pRenderTarget : renderTargets)
+            {
+                attachmentImageInfos.emplace_back();
+                auto &rAttachmentImageInfo = attachmentImageInfos.back();
+                rAttachmentImageInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_ATTACHMENT_IMAGE_INFO_KHR;
+                rAttachmentImageInfo.pNext = nullptr;
+                rAttachmentImageInfo.flags = pRenderTarget->GetImageCreateFlags();
+                rAttachmentImageInfo.usage = pRenderTarget->GetImageUsageFlags();
+                rAttachmentImageInfo.width = pRenderTarget->GetWidth();
+                rAttachmentImageInfo.height = pRenderTarget->GetHeight();
+                rAttachmentImageInfo.layerCount = pRenderTarget->GetSlices();
+                // images aren't created with a VkImageFormatListCreateInfo, and the view formats have to match theirs
+                // when the render pass begins (the attachment formats still come from the render pass)
+                rAttachmentImageInfo.viewFormatCount = 0;
+                rAttachmentImageInfo.pViewFormats = nullptr;
+            }
+            BuildImagelessFrameBufferKey(attachmentImageInfos, renderPass, mFrameBufferKey);
+        }
+        else
+        {
+            for (const auto *pRenderTarget : renderTargets)
+            {
+                attachments.emplace_back(pRenderTarget->GetDefaultImageView());
+            }
+            BuildFrameBufferKey(attachments, renderPass, mFrameBufferKey);
+        }
 
-        auto it = mFrameBuffers.find(frameBufferHash);
-        if (it != mFrameBuffers.end())
+        auto frameBufferHash = mFrameBufferKey.GetHash();
+        if (auto *pFrameBuffer = mFrameBuffers.Find(frameBufferHash, mFrameBufferKey))
         {
-            return {it->first, it->second};
+            return {frameBufferHash, *pFrameBuffer};
         }
 
         VkFramebufferCreateInfo framebufferCreateInfo;
         framebufferCreateInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
         framebufferCreateInfo.pNext = nullptr;
         framebufferCreateInfo.flags = 0;
-        framebufferCreateInfo.renderPass = result.second;
+        framebufferCreateInfo.renderPass = renderPass;
         framebufferCreateInfo.layers = 1;
         framebufferCreateInfo.width = width;
         framebufferCreateInfo.height = height;
-        framebufferCreateInfo.attachmentCount = (uint32_t)attachments.size();
-        framebufferCreateInfo.pAttachments = &attachments[0];
+        framebufferCreateInfo.attachmentCount = (uint32_t)renderTargets.size();
+        framebufferCreateInfo.pAttachments = attachments.empty() ? nullptr : &attachments[0];
+
+        VkFramebufferAttachmentsCreateInfoKHR framebufferAttachmentsCreateInfo;
+        if (mImagelessFrameBufferSupported)
+        {
+            framebufferAttachmentsCreateInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_ATTACHMENTS_CREATE_INFO_KHR;
+            framebufferAttachmentsCreateInfo.pNext = nullptr;
+            framebufferAttachmentsCreateInfo.attachmentImageInfoCount = (uint32_t)attachmentImageInfos.size();
+            framebufferAttachmentsCreateInfo.pAttachmentImageInfos = &attachmentImageInfos[0];
+
+            framebufferCreateInfo.pNext = &framebufferAttachmentsCreateInfo;
+            framebufferCreateInfo.flags = VK_FRAMEBUFFER_CREATE_IMAGELESS_BIT_KHR;
+        }
 
         VkFramebuffer frameBuffer;
         FASTCG_CHECK_VK_RESULT(
             vkCreateFramebuffer(mDevice, &framebufferCreateInfo, mAllocationCallbacks.get(), &frameBuffer));
 
-        it = mFrameBuffers.emplace(frameBufferHash, frameBuffer).first;
+        mFrameBuffers.Add(frameBufferHash, mFrameBufferKey, frameBuffer);
 
-        for (uint32_t i = 0; i < rRenderPassDescription.renderTargetCount; ++i)
+        // track every attachment, so that destroying any of them destroys the frame buffer.
+        // imageless frame buffers are shared by all attachments with the same extent and formats, but they're still
+        // destroyed along with the attachments they were created for (e.g., when the swap chain or the render targets
+        // are recreated after a resize), otherwise one would be leaked for every new extent. the other attachments
+        // that shared it simply create a new one
+        auto &rFrameBufferEntry = mFrameBufferEntries[frameBuffer];
+        rFrameBufferEntry.hash = frameBufferHash;
+        for (const auto *pRenderTarget : renderTargets)
         {
-            const auto *pRenderTarget = rRenderPassDescription.ppRenderTargets[i];
-            if (pRenderTarget != nullptr)
+            auto image = pRenderTarget->GetImage();
+            mRenderTargetToFrameBuffers[image].emplace_back(frameBuffer);
+            rFrameBufferEntry.renderTargets.emplace_back(image);
+        }
+
+        return {frameBufferHash, frameBuffer};
+    }
+
+    std::pair<uint64_t, VulkanPipeline> VulkanGraphicsSystem::GetOrCreateGraphicsPipeline(
+        const VulkanPipelineDescription &rPipelineDescription, VkRenderPass renderPass, uint32_t renderTargetCount)
+    {
+        assert(rPipelineDescription.pShader != nullptr);
+
+        auto pipelineLayout =
+            GetOrCreatePipelineLayout(rPipelineDescription.pShader->GetPipelineLayoutDescription()).second;
+
+        BuildGraphicsPipelineKey(rPipelineDescription, renderPass, renderTargetCount, mPipelineKey);
+        auto pipelineHash = mPipelineKey.GetHash();
+        if (auto *pPipeline = mPipelines.Find(pipelineHash, mPipelineKey))
+        {
+            if (*pPipeline == VK_NULL_HANDLE)
             {
-                auto image = pRenderTarget->GetImage();
-                mRenderTargetToFrameBufferHash[image] = frameBufferHash;
-                mFrameBufferHashToRenderTargets[frameBufferHash].emplace_back(image);
+                // still being compiled in the background, the draw is skipped if it isn't done yet
+                CollectDonePipelineCompileJobs();
             }
+            return {pipelineHash, {*pPipeline, pipelineLayout}};
         }
 
-        return {it->first, it->second};
+        VertexInputState vertexInputState;
+        GetVertexInputState(rPipelineDescription, vertexInputState);
+        auto pipeline = CreateGraphicsPipeline(rPipelineDescription, vertexInputState, renderPass, renderTargetCount,
+                                               pipelineLayout);
+
+        mPipelines.Add(pipelineHash, mPipelineKey, pipeline);
+
+        return {pipelineHash, {pipeline, pipelineLayout}};
     }
 
-    std::pair<size_t, VulkanPipeline> VulkanGraphicsSystem::GetOrCreateGraphicsPipeline(
-        const VulkanPipelineDescription &rPipelineDescription, VkRenderPass renderPass, uint32_t renderTargetCount)
+    std::pair<uint64_t, VulkanPipeline> VulkanGraphicsSystem::GetOrCreateComputePipeline(
+        const VulkanPipelineDescription &rPipelineDescription)
     {
         assert(rPipelineDescription.pShader != nullptr);
 
         auto pipelineLayout =
             GetOrCreatePipelineLayout(rPipelineDescription.pShader->GetPipelineLayoutDescription()).second;
 
-        auto pipelineHash = GetPipelineHash(rPipelineDescription);
+        BuildComputePipelineKey(rPipelineDescription, mPipelineKey);
+        auto pipelineHash = mPipelineKey.GetHash();
+        if (auto *pPipeline = mPipelines.Find(pipelineHash, mPipelineKey))
+        {
+            // dispatches can't be skipped, so wait for the background compilation
+            while (*pPipeline == VK_NULL_HANDLE)
+            {
+                WaitForDonePipelineCompileJobs();
+            }
+            return {pipelineHash, {*pPipeline, pipelineLayout}};
+        }
+
+        auto pipeline = CreateComputePipeline(rPipelineDescription, pipelineLayout);
+
+        mPipelines.Add(pipelineHash, mPipelineKey, pipeline);
+
+        return {pipelineHash, {pipeline, pipelineLayout}};
+    }
 
-        auto it = mPipelines.find(pipelineHash);
-        if (it != mPipelines.end())
+    void VulkanGraphicsSystem::GetVertexInputState(const VulkanPipelineDescription &rPipelineDescription,
+                                                   VertexInputState &rVertexInputState)
+    {
+        const auto &rVertexInputDescription = rPipelineDescription.pShader->GetInputDescription();
+        for (uint32_t i = 0; i < rPipelineDescription.graphicsInfo.vertexBufferCount; ++i)
         {
-            return {it->first, {it->second, pipelineLayout}};
+            const auto *pVertexBuffer = rPipelineDescription.graphicsInfo.ppVertexBuffers[i];
+            uint32_t stride = 0;
+            for (const auto &rVbDesc : pVertexBuffer->GetVertexBindingDescriptors())
+            {
+                auto it = rVertexInputDescription.find(rVbDesc.binding);
+                if (it == rVertexInputDescription.end())
+                {
+                    continue;
+                }
+                auto format = GetVkFormat(rVbDesc.type, rVbDesc.size);
+                rVertexInputState.attributeDescriptions.emplace_back(
+                    VkVertexInputAttributeDescription{rVbDesc.binding, (uint32_t)i, format, rVbDesc.offset});
+                stride += GetVkStride(format);
+            }
+            rVertexInputState.bindingDescriptions.emplace_back(
+                VkVertexInputBindingDescription{(uint32_t)i, stride, VK_VERTEX_INPUT_RATE_VERTEX});
         }
+    }
 
+    VkPipeline VulkanGraphicsSystem::CreateGraphicsPipeline(const VulkanPipelineDescription &rPipelineDescription,
+                                                            const VertexInputState &rVertexInputState,
+                                                            VkRenderPass renderPass, uint32_t renderTargetCount,
+                                                            VkPipelineLayout pipelineLayout) const
+    {
         VkGraphicsPipelineCreateInfo pipelineCreateInfo;
         pipelineCreateInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
         pipelineCreateInfo.pNext = nullptr;
@@ -1590,37 +2285,17 @@ namespace FastCG
             }
         }
 
-        const auto &rVertexInputDescription = rPipelineDescription.pShader->GetInputDescription();
-        std::vector<VkVertexInputAttributeDescription> vertexInputAttributeDescriptions;
-        std::vector<VkVertexInputBindingDescription> vertexInputBindingDescriptions;
-        for (uint32_t i = 0; i < rPipelineDescription.graphicsInfo.vertexBufferCount; ++i)
-        {
-            const auto *pVertexBuffer = rPipelineDescription.graphicsInfo.ppVertexBuffers[i];
-            uint32_t stride = 0;
-            for (const auto &rVbDesc : pVertexBuffer->GetVertexBindingDescriptors())
-            {
-                auto it = rVertexInputDescription.find(rVbDesc.binding);
-                if (it == rVertexInputDescription.end())
-                {
-                    continue;
-                }
-                auto format = GetVkFormat(rVbDesc.type, rVbDesc.size);
-                vertexInputAttributeDescriptions.emplace_back(
-                    VkVertexInputAttributeDescription{rVbDesc.binding, (uint32_t)i, format, rVbDesc.offset});
-                stride += GetVkStride(format);
-            }
-            vertexInputBindingDescriptions.emplace_back(
-                VkVertexInputBindingDescription{(uint32_t)i, stride, VK_VERTEX_INPUT_RATE_VERTEX});
-        }
+        const auto &rVertexInputAttributeDescriptions = rVertexInputState.attributeDescriptions;
+        const auto &rVertexInputBindingDescriptions = rVertexInputState.bindingDescriptions;
 
         VkPipelineVertexInputStateCreateInfo vertexInputStateCreateInfo;
         vertexInputStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
         vertexInputStateCreateInfo.pNext = nullptr;
         vertexInputStateCreateInfo.flags = 0;
-        vertexInputStateCreateInfo.pVertexBindingDescriptions = &vertexInputBindingDescriptions[0];
-        vertexInputStateCreateInfo.vertexBindingDescriptionCount = (uint32_t)vertexInputBindingDescriptions.size();
-        vertexInputStateCreateInfo.pVertexAttributeDescriptions = &vertexInputAttributeDescriptions[0];
-        vertexInputStateCreateInfo.vertexAttributeDescriptionCount = (uint32_t)vertexInputAttributeDescriptions.size();
+        vertexInputStateCreateInfo.pVertexBindingDescriptions = rVertexInputBindingDescriptions.data();
+        vertexInputStateCreateInfo.vertexBindingDescriptionCount = (uint32_t)rVertexInputBindingDescriptions.size();
+        vertexInputStateCreateInfo.pVertexAttributeDescriptions = rVertexInputAttributeDescriptions.data();
+        vertexInputStateCreateInfo.vertexAttributeDescriptionCount = (uint32_t)rVertexInputAttributeDescriptions.size();
         pipelineCreateInfo.pVertexInputState = &vertexInputStateCreateInfo;
 
         VkPipelineInputAssemblyStateCreateInfo inputAssemblyCreateInfo;
@@ -1759,30 +2434,15 @@ namespace FastCG
         pipelineCreateInfo.basePipelineIndex = 0;
 
         VkPipeline pipeline;
-        FASTCG_CHECK_VK_RESULT(vkCreateGraphicsPipelines(mDevice, VK_NULL_HANDLE, 1, &pipelineCreateInfo,
+        FASTCG_CHECK_VK_RESULT(vkCreateGraphicsPipelines(mDevice, mPipelineCache, 1, &pipelineCreateInfo,
                                                          mAllocationCallbacks.get(), &pipeline));
 
-        it = mPipelines.emplace(pipelineHash, pipeline).first;
-
-        return {it->first, {it->second, pipelineLayout}};
+        return pipeline;
     }
 
-    std::pair<size_t, VulkanPipeline> VulkanGraphicsSystem::GetOrCreateComputePipeline(
-        const VulkanPipelineDescription &rPipelineDescription)
+    VkPipeline VulkanGraphicsSystem::CreateComputePipeline(const VulkanPipelineDescription &rPipelineDescription,
+                                                           VkPipelineLayout pipelineLayout) const
     {
-        assert(rPipelineDescription.pShader != nullptr);
-
-        auto pipelineLayout =
-            GetOrCreatePipelineLayout(rPipelineDescription.pShader->GetPipelineLayoutDescription()).second;
-
-        auto pipelineHash = GetPipelineHash(rPipelineDescription);
-
-        auto it = mPipelines.find(pipelineHash);
-        if (it != mPipelines.end())
-        {
-            return {it->first, {it->second, pipelineLayout}};
-        }
-
         VkComputePipelineCreateInfo pipelineCreateInfo;
         pipelineCreateInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
         pipelineCreateInfo.pNext = nullptr;
@@ -1799,23 +2459,225 @@ namespace FastCG
         pipelineCreateInfo.basePipelineIndex = 0;
 
         VkPipeline pipeline;
-        FASTCG_CHECK_VK_RESULT(vkCreateComputePipelines(mDevice, VK_NULL_HANDLE, 1, &pipelineCreateInfo,
+        FASTCG_CHECK_VK_RESULT(vkCreateComputePipelines(mDevice, mPipelineCache, 1, &pipelineCreateInfo,
                                                         mAllocationCallbacks.get(), &pipeline));
 
-        it = mPipelines.emplace(pipelineHash, pipeline).first;
+        return pipeline;
+    }
 
-        return {it->first, {it->second, pipelineLayout}};
+    void VulkanGraphicsSystem::GetDrawRenderPassDescription(const VulkanPipelineDescription &rPipelineDescription,
+                                                            const VulkanRenderPassDescription &rRenderPassDescription,
+                                                            VulkanRenderPassDescription &rDrawRenderPassDescription,
+                                                            bool &rDepthWrite, bool &rStencilWrite,
+                                                            uint32_t &rRenderTargetCount)
+    {
+        assert(rPipelineDescription.pShader != nullptr);
+
+        const auto &rFragmentOutputDescription = rPipelineDescription.pShader->GetOutputDescription();
+        rDrawRenderPassDescription = rRenderPassDescription;
+        rRenderTargetCount = 0;
+        for (uint32_t i = 0; i < rDrawRenderPassDescription.renderTargetCount; ++i)
+        {
+            if (rFragmentOutputDescription.find(i) == rFragmentOutputDescription.end())
+            {
+                rDrawRenderPassDescription.ppRenderTargets[i] = nullptr;
+            }
+            else if (rDrawRenderPassDescription.ppRenderTargets[i] != nullptr)
+            {
+                rRenderTargetCount++;
+            }
+        }
+
+        rDepthWrite = rPipelineDescription.graphicsInfo.depthWrite;
+        rStencilWrite = rPipelineDescription.graphicsInfo.stencilTest &&
+                        (rPipelineDescription.graphicsInfo.stencilBackState.writeMask != 0 ||
+                         rPipelineDescription.graphicsInfo.stencilFrontState.writeMask != 0);
     }
 
-    std::pair<size_t, VkPipelineLayout> VulkanGraphicsSystem::GetOrCreatePipelineLayout(
-        const VulkanPipelineLayoutDescription &rPipelineLayoutDescription)
+    void VulkanGraphicsSystem::PrewarmGraphicsPipelines(
+        const std::vector<VulkanPipelineDescription> &rPipelineDescriptions,
+        const VulkanRenderPassDescription &rRenderPassDescription)
+    {
+        for (const auto &rPipelineDescription : rPipelineDescriptions)
+        {
+            VulkanRenderPassDescription drawRenderPassDescription;
+            bool depthWrite, stencilWrite;
+            uint32_t renderTargetCount;
+            GetDrawRenderPassDescription(rPipelineDescription, rRenderPassDescription, drawRenderPassDescription,
+                                         depthWrite, stencilWrite, renderTargetCount);
+
+            // render passes and pipeline layouts are cheap, only pipelines are compiled in the background
+            auto renderPass = GetOrCreateCompatibleRenderPass(drawRenderPassDescription, depthWrite, stencilWrite);
+            auto pipelineLayout =
+                GetOrCreatePipelineLayout(rPipelineDescription.pShader->GetPipelineLayoutDescription()).second;
+
+            BuildGraphicsPipelineKey(rPipelineDescription, renderPass, renderTargetCount, mPipelineKey);
+            auto pipelineHash = mPipelineKey.GetHash();
+            if (mPipelines.Find(pipelineHash, mPipelineKey) != nullptr)
+            {
+                continue;
+            }
+
+            EnqueuePipelineCompileJob(pipelineHash, mPipelineKey, rPipelineDescription, renderPass, renderTargetCount,
+                                      pipelineLayout);
+        }
+    }
+
+    void VulkanGraphicsSystem::PrewarmComputePipelines(
+        const std::vector<VulkanPipelineDescription> &rPipelineDescriptions)
+    {
+        for (const auto &rPipelineDescription : rPipelineDescriptions)
+        {
+            assert(rPipelineDescription.pShader != nullptr);
+
+            auto pipelineLayout =
+                GetOrCreatePipelineLayout(rPipelineDescription.pShader->GetPipelineLayoutDescription()).second;
+
+            BuildComputePipelineKey(rPipelineDescription, mPipelineKey);
+            auto pipelineHash = mPipelineKey.GetHash();
+            if (mPipelines.Find(pipelineHash, mPipelineKey) != nullptr)
+            {
+                continue;
+            }
+
+            EnqueuePipelineCompileJob(pipelineHash, mPipelineKey, rPipelineDescription, VK_NULL_HANDLE, 0,
+                                      pipelineLayout);
+        }
+    }
+
+    bool VulkanGraphicsSystem::IsPrewarmingPipelines()
     {
-        auto pipelineLayoutHash = GetPipelineLayoutHash(rPipelineLayoutDescription);
+        CollectDonePipelineCompileJobs();
+        return mPendingPipelineCompileJobCount > 0;
+    }
+
+    void VulkanGraphicsSystem::WaitForPipelinePrewarm()
+    {
+        while (mPendingPipelineCompileJobCount > 0)
+        {
+            WaitForDonePipelineCompileJobs();
+        }
+    }
+
+    void VulkanGraphicsSystem::EnqueuePipelineCompileJob(uint64_t hash, const VulkanObjectKey &rKey,
+                                                         const VulkanPipelineDescription &rPipelineDescription,
+                                                         VkRenderPass renderPass, uint32_t renderTargetCount,
+                                                         VkPipelineLayout pipelineLayout)
+    {
+        // placeholder until the job is collected
+        mPipelines.Add(hash, rKey, VK_NULL_HANDLE);
+
+        auto pJob = std::make_unique<PipelineCompileJob>();
+        pJob->hash = hash;
+        pJob->key = rKey;
+        pJob->description = rPipelineDescription;
+        if (renderPass != VK_NULL_HANDLE)
+        {
+            GetVertexInputState(rPipelineDescription, pJob->vertexInputState);
+        }
+        pJob->renderPass = renderPass;
+        pJob->renderTargetCount = renderTargetCount;
+        pJob->layout = pipelineLayout;
+        {
+            std::lock_guard<std::mutex> lock(mPipelineCompileMutex);
+            mQueuedPipelineCompileJobs.emplace_back(std::move(pJob));
+        }
+        mPendingPipelineCompileJobCount++;
+        mPendingPipelineCompileJobCountPerShader[rPipelineDescription.pShader]++;
+        // one task per job, each compiling the oldest queued job
+        GetThreadPool()->Enqueue([this]() { RunPipelineCompileJob(); });
+    }
+
+    void VulkanGraphicsSystem::RunPipelineCompileJob()
+    {
+        std::unique_ptr<PipelineCompileJob> pJob;
+        {
+            std::lock_guard<std::mutex> lock(mPipelineCompileMutex);
+            // cancelled
+            if (mQueuedPipelineCompileJobs.empty())
+            {
+                return;
+            }
+            pJob = std::move(mQueuedPipelineCompileJobs.front());
+            mQueuedPipelineCompileJobs.pop_front();
+        }
+
+        // errors are rethrown on the render thread
+        try
+        {
+            if (pJob->renderPass != VK_NULL_HANDLE)
+            {
+                pJob->pipeline = CreateGraphicsPipeline(pJob->description, pJob->vertexInputState, pJob->renderPass,
+                                                        pJob->renderTargetCount, pJob->layout);
+            }
+            else
+            {
+                pJob->pipeline = CreateComputePipeline(pJob->description, pJob->layout);
+            }
+        }
+        catch (...)
+        {
+            pJob->exception = std::current_exception();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mPipelineCompileMutex);
+            mDonePipelineCompileJobs.emplace_back(std::move(pJob));
+        }
+        mPipelineCompileJobDone.notify_one();
+    }
+
+    void VulkanGraphicsSystem::CollectDonePipelineCompileJobs()
+    {
+        std::vector<std::unique_ptr<PipelineCompileJob>> doneJobs;
+        {
+            std::lock_guard<std::mutex> lock(mPipelineCompileMutex);
+            doneJobs.swap(mDonePipelineCompileJobs);
+        }
+        for (const auto &rpJob : doneJobs)
+        {
+            assert(mPendingPipelineCompileJobCount > 0);
+            mPendingPipelineCompileJobCount--;
+            auto it = mPendingPipelineCompileJobCountPerShader.find(rpJob->description.pShader);
+            assert(it != mPendingPipelineCompileJobCountPerShader.end() && it->second > 0);
+            if (--it->second == 0)
+            {
+                mPendingPipelineCompileJobCountPerShader.erase(it);
+            }
+            if (rpJob->exception)
+            {
+                std::rethrow_exception(rpJob->exception);
+            }
+            *mPipelines.Find(rpJob->hash, rpJob->key) = rpJob->pipeline;
+        }
+    }
+
+    void VulkanGraphicsSystem::WaitForDonePipelineCompileJobs()
+    {
+        assert(mPendingPipelineCompileJobCount > 0);
+        {
+            std::unique_lock<std::mutex> lock(mPipelineCompileMutex);
+            mPipelineCompileJobDone.wait(lock, [this]() { return !mDonePipelineCompileJobs.empty(); });
+        }
+        CollectDonePipelineCompileJobs();
+    }
+
+    void VulkanGraphicsSystem::WaitForPipelineCompileJobs(const VulkanShader *pShader)
+    {
+        while (mPendingPipelineCompileJobCountPerShader.find(pShader) != mPendingPipelineCompileJobCountPerShader.end())
+        {
+            WaitForDonePipelineCompileJobs();
+        }
+    }
 
-        auto it = mPipelineLayouts.find(pipelineLayoutHash);
-        if (it != mPipelineLayouts.end())
+    std::pair<uint64_t, VkPipelineLayout> VulkanGraphicsSystem::GetOrCreatePipelineLayout(
+        const VulkanPipelineLayoutDescription &rPipelineLayoutDescription)
+    {
+        BuildPipelineLayoutKey(rPipelineLayoutDescription, mPipelineLayoutKey);
+        auto pipelineLayoutHash = mPipelineLayoutKey.GetHash();
+        if (auto *pPipelineLayout = mPipelineLayouts.Find(pipelineLayoutHash, mPipelineLayoutKey))
         {
-            return {it->first, it->second};
+            return {pipelineLayoutHash, *pPipelineLayout};
         }
 
         VkDescriptorSetLayout pSetLayouts[VulkanPipelineLayout::MAX_SET_COUNT];
@@ -1846,22 +2708,21 @@ namespace FastCG
             vkCreatePipelineLayout(VulkanGraphicsSystem::GetInstance()->GetDevice(), &pipelineLayoutCreateInfo,
                                    VulkanGraphicsSystem::GetInstance()->GetAllocationCallbacks(), &pipelineLayout));
 
-        it = mPipelineLayouts.emplace(pipelineLayoutHash, pipelineLayout).first;
+        mPipelineLayouts.Add(pipelineLayoutHash, mPipelineLayoutKey, pipelineLayout);
 
-        return {it->first, it->second};
+        return {pipelineLayoutHash, pipelineLayout};
     }
 
-    std::pair<size_t, VkDescriptorSetLayout> VulkanGraphicsSystem::GetOrCreateDescriptorSetLayout(
+    std::pair<uint64_t, VkDescriptorSetLayout> VulkanGraphicsSystem::GetOrCreateDescriptorSetLayout(
         const VulkanDescriptorSetLayout &rDescriptorSetLayout)
     {
         assert(rDescriptorSetLayout.bindingLayoutCount > 0);
 
-        auto setLayoutHash = GetDescriptorSetLayoutHash(rDescriptorSetLayout);
-
-        auto it = mDescriptorSetLayouts.find(setLayoutHash);
-        if (it != mDescriptorSetLayouts.end())
+        BuildDescriptorSetLayoutKey(rDescriptorSetLayout, mDescriptorSetLayoutKey);
+        auto setLayoutHash = mDescriptorSetLayoutKey.GetHash();
+        if (auto *pSetLayout = mDescriptorSetLayouts.Find(setLayoutHash, mDescriptorSetLayoutKey))
         {
-            return {it->first, it->second};
+            return {setLayoutHash, *pSetLayout};
         }
 
         VkDescriptorSetLayoutBinding pLayoutBindings[VulkanDescriptorSet::MAX_BINDING_COUNT];
@@ -1888,47 +2749,151 @@ namespace FastCG
             vkCreateDescriptorSetLayout(VulkanGraphicsSystem::GetInstance()->GetDevice(), &setLayoutCreateInfo,
                                         VulkanGraphicsSystem::GetInstance()->GetAllocationCallbacks(), &setLayout));
 
-        it = mDescriptorSetLayouts.emplace(setLayoutHash, setLayout).first;
+        mDescriptorSetLayouts.Add(setLayoutHash, mDescriptorSetLayoutKey, setLayout);
 
-        return {it->first, it->second};
+        return {setLayoutHash, setLayout};
     }
 
-    std::pair<size_t, VkDescriptorSet> VulkanGraphicsSystem::GetOrCreateDescriptorSet(
-        const VulkanDescriptorSetLayout &rDescriptorSetLayout)
+    VkDescriptorSet VulkanGraphicsSystem::GetOrCreateDescriptorSet(
+        const VulkanDescriptorSetLayout &rDescriptorSetLayout, VkWriteDescriptorSet *pSetWrites, uint32_t setWriteCount)
     {
-        auto setLayoutHash = GetDescriptorSetLayoutHash(rDescriptorSetLayout);
+        // evicted sets are freed back to their pools, so this also bounds how many pools get created
+#if defined FASTCG_ANDROID
+        const size_t MAX_CACHED_SET_COUNT = 8192;
+#else
+        const size_t MAX_CACHED_SET_COUNT = 4096;
+#endif
+
+        auto setLayout = GetOrCreateDescriptorSetLayout(rDescriptorSetLayout).second;
 
-        auto &rDescriptorSetLocalPools = mDescriptorSetLocalPools[mCurrentFrame];
-        auto it = rDescriptorSetLocalPools.find(setLayoutHash);
-        if (it != rDescriptorSetLocalPools.end())
+        BuildDescriptorSetKey(setLayout, pSetWrites, setWriteCount, mDescriptorSetKey);
+        auto setHash = mDescriptorSetKey.GetHash();
+        if (auto *pIt = mDescriptorSets.Find(setHash, mDescriptorSetKey))
         {
-            auto &rDescriptorSetLocalPool = it->second;
-            auto descriptorSet = rDescriptorSetLocalPool.descriptorSets[rDescriptorSetLocalPool.lastDescriptorSetIdx++];
-            assert(rDescriptorSetLocalPool.lastDescriptorSetIdx < VulkanDescriptorSetLocalPool::MAX_SET_COUNT);
-            return {it->first, descriptorSet};
+            mDescriptorSetLru.splice(mDescriptorSetLru.begin(), mDescriptorSetLru, *pIt);
+            return (*pIt)->descriptorSet;
         }
 
-        auto setLayout = GetOrCreateDescriptorSetLayout(rDescriptorSetLayout).second;
+        if (mDescriptorSetLru.size() == MAX_CACHED_SET_COUNT)
+        {
+            EvictDescriptorSet(std::prev(mDescriptorSetLru.end()));
+        }
+
+        DescriptorSetCacheEntry entry;
+        entry.hash = setHash;
+        entry.descriptorSet = AllocateDescriptorSet(setLayout, entry.descriptorPool);
+        auto AddResource = [&entry](uint64_t resource) {
+            if (std::find(entry.resources.begin(), entry.resources.end(), resource) == entry.resources.end())
+            {
+                entry.resources.emplace_back(resource);
+            }
+        };
+        for (uint32_t i = 0; i < setWriteCount; ++i)
+        {
+            auto &rSetWrite = pSetWrites[i];
+            rSetWrite.dstSet = entry.descriptorSet;
+            if (rSetWrite.pImageInfo != nullptr)
+            {
+                AddResource((uint64_t)rSetWrite.pImageInfo->imageView);
+            }
+            if (rSetWrite.pBufferInfo != nullptr)
+            {
+                AddResource((uint64_t)rSetWrite.pBufferInfo->buffer);
+            }
+        }
 
-        auto &rDescriptorSetLocalPool = rDescriptorSetLocalPools[setLayoutHash];
+        if (setWriteCount > 0)
+        {
+            vkUpdateDescriptorSets(mDevice, setWriteCount, pSetWrites, 0, nullptr);
+        }
 
-        for (size_t i = 0; i < VulkanDescriptorSetLocalPool::MAX_SET_COUNT; ++i)
+        mDescriptorSetLru.emplace_front(std::move(entry));
+        mDescriptorSets.Add(setHash, mDescriptorSetKey, mDescriptorSetLru.begin());
+        for (auto resource : mDescriptorSetLru.front().resources)
         {
-            auto &rDescriptorSet = rDescriptorSetLocalPool.descriptorSets[i];
+            mResourceToDescriptorSets[resource].emplace_back(mDescriptorSetLru.begin());
+        }
 
-            VkDescriptorSetAllocateInfo descriptorSetAllocateInfo;
-            descriptorSetAllocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-            descriptorSetAllocateInfo.pNext = nullptr;
-            descriptorSetAllocateInfo.descriptorPool = mDescriptorPool;
-            descriptorSetAllocateInfo.descriptorSetCount = 1;
-            descriptorSetAllocateInfo.pSetLayouts = &setLayout;
+        return mDescriptorSetLru.front().descriptorSet;
+    }
+
+    VkDescriptorSet VulkanGraphicsSystem::AllocateDescriptorSet(VkDescriptorSetLayout setLayout,
+                                                                VkDescriptorPool &rDescriptorPool)
+    {
+        VkDescriptorSetAllocateInfo descriptorSetAllocateInfo;
+        descriptorSetAllocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        descriptorSetAllocateInfo.pNext = nullptr;
+        descriptorSetAllocateInfo.descriptorSetCount = 1;
+        descriptorSetAllocateInfo.pSetLayouts = &setLayout;
 
-            FASTCG_CHECK_VK_RESULT(vkAllocateDescriptorSets(mDevice, &descriptorSetAllocateInfo, &rDescriptorSet));
+        // sets freed by evictions leave room in older pools, so all of them are tried (starting with the hinted one)
+        // before growing
+        VkDescriptorSet descriptorSet;
+        for (size_t i = 0; i < mDescriptorPools.size(); ++i)
+        {
+            auto poolIdx = (mDescriptorPoolHint + i) % mDescriptorPools.size();
+            descriptorSetAllocateInfo.descriptorPool = mDescriptorPools[poolIdx];
+            auto result = vkAllocateDescriptorSets(mDevice, &descriptorSetAllocateInfo, &descriptorSet);
+            if (result == VK_SUCCESS)
+            {
+                mDescriptorPoolHint = poolIdx;
+                rDescriptorPool = mDescriptorPools[poolIdx];
+                return descriptorSet;
+            }
+            if (result != VK_ERROR_OUT_OF_POOL_MEMORY && result != VK_ERROR_FRAGMENTED_POOL)
+            {
+                FASTCG_CHECK_VK_RESULT(result);
+            }
         }
 
-        auto descriptorSet = rDescriptorSetLocalPool.descriptorSets[rDescriptorSetLocalPool.lastDescriptorSetIdx++];
-        assert(rDescriptorSetLocalPool.lastDescriptorSetIdx < VulkanDescriptorSetLocalPool::MAX_SET_COUNT);
-        return {setLayoutHash, descriptorSet};
+        // grow
+        rDescriptorPool = CreateDescriptorPool();
+        mDescriptorPoolHint = mDescriptorPools.size() - 1;
+        descriptorSetAllocateInfo.descriptorPool = rDescriptorPool;
+        FASTCG_CHECK_VK_RESULT(vkAllocateDescriptorSets(mDevice, &descriptorSetAllocateInfo, &descriptorSet));
+
+        return descriptorSet;
+    }
+
+    void VulkanGraphicsSystem::EvictDescriptorSet(DescriptorSetLru::iterator it)
+    {
+        mDescriptorSets.Remove(it->hash, it);
+        for (auto resource : it->resources)
+        {
+            // the resource being invalidated is already gone
+            auto it2 = mResourceToDescriptorSets.find(resource);
+            if (it2 == mResourceToDescriptorSets.end())
+            {
+                continue;
+            }
+            auto &rDescriptorSets = it2->second;
+            rDescriptorSets.erase(std::remove(rDescriptorSets.begin(), rDescriptorSets.end(), it),
+                                  rDescriptorSets.end());
+            if (rDescriptorSets.empty())
+            {
+                mResourceToDescriptorSets.erase(it2);
+            }
+        }
+        // the set might still be used by frames in flight
+        mDeferredDestroyRequests.emplace_back(
+            DeferredDestroyRequest{mCurrentFrame, it->descriptorSet, it->descriptorPool});
+        mDescriptorSetLru.erase(it);
+    }
+
+    void VulkanGraphicsSystem::InvalidateDescriptorSets(uint64_t resource)
+    {
+        // handles of destroyed resources can be reused by new ones, so sets pointing to them can't be matched anymore
+        auto it = mResourceToDescriptorSets.find(resource);
+        if (it == mResourceToDescriptorSets.end())
+        {
+            return;
+        }
+        auto descriptorSets = std::move(it->second);
+        mResourceToDescriptorSets.erase(it);
+        for (auto descriptorSetIt : descriptorSets)
+        {
+            EvictDescriptorSet(descriptorSetIt);
+        }
     }
 
 #if _DEBUG
@@ -1993,6 +2958,8 @@ namespace FastCG
                 Super::DestroyBuffer(rDeferredDestroyRequest.pBuffer);
                 break;
             case DeferredDestroyRequest::Type::SHADER:
+                // background pipeline compilations might still use the shader modules
+                WaitForPipelineCompileJobs(rDeferredDestroyRequest.pShader);
                 Super::DestroyShader(rDeferredDestroyRequest.pShader);
                 break;
             case DeferredDestroyRequest::Type::TEXTURE:
@@ -2001,6 +2968,17 @@ namespace FastCG
             case DeferredDestroyRequest::Type::FRAME_BUFFER:
                 vkDestroyFramebuffer(mDevice, rDeferredDestroyRequest.frameBuffer, mAllocationCallbacks.get());
                 break;
+            case DeferredDestroyRequest::Type::DESCRIPTOR_SET:
+                FASTCG_CHECK_VK_RESULT(vkFreeDescriptorSets(mDevice, rDeferredDestroyRequest.descriptorSet.pool, 1,
+                                                            &rDeferredDestroyRequest.descriptorSet.set));
+                {
+                    // the pool now has room for at least one set
+                    auto it = std::find(mDescriptorPools.begin(), mDescriptorPools.end(),
+                                        rDeferredDestroyRequest.descriptorSet.pool);
+                    assert(it != mDescriptorPools.end());
+                    mDescriptorPoolHint = (size_t)std::distance(mDescriptorPools.begin(), it);
+                }
+                break;
             default:
                 FASTCG_THROW_EXCEPTION(Exception, "Vulkan: Unhandled deferred destroy type %d",
                                        (int)rDeferredDestroyRequest.type);
@@ -2020,6 +2998,8 @@ namespace FastCG
             case DeferredDestroyRequest::Type::BUFFER:
             case DeferredDestroyRequest::Type::SHADER:
             case DeferredDestroyRequest::Type::TEXTURE:
+            // descriptor sets are freed along with their pools
+            case DeferredDestroyRequest::Type::DESCRIPTOR_SET:
                 // ignore those deferred destroy requests
                 break;
             case DeferredDestroyRequest::Type::FRAME_BUFFER:
@@ -2034,6 +3014,33 @@ namespace FastCG
         mDeferredDestroyRequests.clear();
     }
 
+    bool VulkanGraphicsSystem::CopyToStagingRing(const void *pSrc, size_t size, size_t alignment, size_t &rOffset)
+    {
+        if (mpStagingRing == nullptr)
+        {
+            return false;
+        }
+
+        // texel block sizes aren't necessarily powers of two (e.g., 3 bytes for RGB8, 12 bytes for RGB32F)
+        auto offsetAlignment = std::lcm(mStagingRingAlignment, std::max(alignment, (size_t)1));
+        auto offset = (mStagingRingOffset + offsetAlignment - 1) / offsetAlignment * offsetAlignment;
+        if (offset + size > mpStagingRing->GetDataSize())
+        {
+            return false;
+        }
+
+        auto &rFrameData = mpStagingRing->GetFrameData(mCurrentFrame);
+        std::memcpy((uint8_t *)rFrameData.allocationInfo.pMappedData + offset, pSrc, size);
+        if (!rFrameData.hostCoherent)
+        {
+            FASTCG_CHECK_VK_RESULT(vmaFlushAllocation(mAllocator, rFrameData.allocation, offset, size));
+        }
+
+        mStagingRingOffset = offset + size;
+        rOffset = offset;
+        return true;
+    }
+
     void VulkanGraphicsSystem::OnPostWindowInitialize(void *pWindow)
     {
 #if defined FASTCG_LINUX
@@ -2062,12 +3069,16 @@ namespace FastCG
         VkFence fence;
         FASTCG_CHECK_VK_RESULT(vkCreateFence(mDevice, &fenceCreateInfo, mAllocationCallbacks.get(), &fence));
 
+        std::vector<VkSemaphore> waitSemaphores;
+        std::vector<VkPipelineStageFlags> waitDstStageMasks;
+        SubmitDedicatedQueues(waitSemaphores, waitDstStageMasks);
+
         VkSubmitInfo submitInfo;
         submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
         submitInfo.pNext = nullptr;
-        submitInfo.waitSemaphoreCount = 0;
-        submitInfo.pWaitSemaphores = nullptr;
-        submitInfo.pWaitDstStageMask = nullptr;
+        submitInfo.waitSemaphoreCount = (uint32_t)waitSemaphores.size();
+        submitInfo.pWaitSemaphores = waitSemaphores.empty() ? nullptr : &waitSemaphores[0];
+        submitInfo.pWaitDstStageMask = waitDstStageMasks.empty() ? nullptr : &waitDstStageMasks[0];
         submitInfo.commandBufferCount = 1;
         submitInfo.pCommandBuffers = &mCommandBuffers[mCurrentFrame];
         submitInfo.signalSemaphoreCount = 0;
@@ -2087,10 +3098,9 @@ namespace FastCG
 
         PerformDeferredDestroys();
 
-        for (auto &rEntry : mDescriptorSetLocalPools[mCurrentFrame])
-        {
-            rEntry.second.lastDescriptorSetIdx = 0;
-        }
+        mStagingRingOffset = 0;
+
+        ResetSecondaryCommandBufferPools();
 
         BeginCurrentCommandBuffer();
 
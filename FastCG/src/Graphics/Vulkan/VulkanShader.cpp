@@ -133,7 +133,7 @@ namespace FastCG
             auto set = rCompiler.get_decoration(rResource.id, spv::DecorationDescriptorSet);
             assert(set < VulkanPipelineLayout::MAX_SET_COUNT);
             auto binding = rCompiler.get_decoration(rResource.id, spv::DecorationBinding);
-            mResourceLocation[rResource.name] = {set, binding};
+            mResourceLocation[GetShaderResourceId(rResource.name.c_str())] = {set, binding};
             if (mPipelineLayoutDescription.setLayoutCount <= set)
             {
                 mPipelineLayoutDescription.setLayoutCount = set + 1;
@@ -208,6 +208,29 @@ namespace FastCG
                 }
             }
         }
+
+        // uniform buffers are bound w/ dynamic offsets (as long as the device allows), so sub-allocated constants
+        // don't need a descriptor write each. dynamic offsets are consumed in binding order, so keep bindings sorted.
+        const auto &rLimits = VulkanGraphicsSystem::GetInstance()->GetPhysicalDeviceProperties().limits;
+        auto maxDynamicUniformBufferCount = std::min(rLimits.maxDescriptorSetUniformBuffersDynamic,
+                                                     VulkanPipelineLayout::MAX_DYNAMIC_UNIFORM_BUFFER_COUNT);
+        uint32_t dynamicUniformBufferCount = 0;
+        for (uint32_t i = 0; i < mPipelineLayoutDescription.setLayoutCount; ++i)
+        {
+            auto &rSetLayout = mPipelineLayoutDescription.pSetLayouts[i];
+            std::sort(rSetLayout.pBindingLayouts, rSetLayout.pBindingLayouts + rSetLayout.bindingLayoutCount,
+                      [](const auto &rLhs, const auto &rRhs) { return rLhs.binding < rRhs.binding; });
+            for (uint32_t j = 0; j < rSetLayout.bindingLayoutCount; ++j)
+            {
+                auto &rBindingLayout = rSetLayout.pBindingLayouts[j];
+                if (rBindingLayout.type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER &&
+                    dynamicUniformBufferCount < maxDynamicUniformBufferCount)
+                {
+                    rBindingLayout.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+                    ++dynamicUniformBufferCount;
+                }
+            }
+        }
     }
 
     VulkanShader::~VulkanShader()
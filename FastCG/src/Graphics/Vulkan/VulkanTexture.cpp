@@ -8,7 +8,8 @@
 
 namespace FastCG
 {
-    VulkanTexture::VulkanTexture(const Args &rArgs) : BaseTexture(rArgs), mImage(rArgs.image)
+    VulkanTexture::VulkanTexture(const Args &rArgs)
+        : BaseTexture(rArgs), mImage(rArgs.image), mImageUsage(rArgs.imageUsage)
     {
         if (mImage == VK_NULL_HANDLE)
         {
@@ -69,9 +70,25 @@ namespace FastCG
         }
 
         imageCreateInfo.usage = GetVkImageUsageFlags(GetUsage(), GetFormat());
-        imageCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        // shared with the dedicated queues (if any) instead of transferring ownership between them
+        const auto &rQueueFamilyIndices = VulkanGraphicsSystem::GetInstance()->GetQueueFamilyIndices();
+        if (rQueueFamilyIndices.size() > 1)
+        {
+            imageCreateInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+            imageCreateInfo.queueFamilyIndexCount = (uint32_t)rQueueFamilyIndices.size();
+            imageCreateInfo.pQueueFamilyIndices = &rQueueFamilyIndices[0];
+        }
+        else
+        {
+            imageCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+            imageCreateInfo.queueFamilyIndexCount = 0;
+            imageCreateInfo.pQueueFamilyIndices = nullptr;
+        }
         imageCreateInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
 
+        mImageUsage = imageCreateInfo.usage;
+        mImageCreateFlags = imageCreateInfo.flags;
+
         VmaAllocationCreateInfo allocationCreateInfo;
         if (mUsesMappableMemory)
         {
@@ -57,6 +57,14 @@ namespace
             ImGui::TextColored(GetColor(gpu), "GPU: %.6lf (%zu)", gpu, gpu == 0 ? 0 : (uint64_t)(1 / gpu));
             ImGui::Text("Draw Calls: %u", rRenderingStatistics.drawCalls);
             ImGui::Text("Triangles: %u", rRenderingStatistics.triangles);
+            ImGui::Text("Visible Renderables: %u", rRenderingStatistics.visibleRenderables);
+            ImGui::Text("Culled Renderables: %u", rRenderingStatistics.culledRenderables);
+            ImGui::Text("Culled Shadow Casters: %u", rRenderingStatistics.culledShadowCasters);
+            ImGui::Text("Uploaded Instances: %u", rRenderingStatistics.uploadedInstances);
+#if defined FASTCG_OPENGL
+            ImGui::Text("Elided GL Calls: %u",
+                        FastCG::GraphicsSystem::GetInstance()->GetStateCache().GetElidedCallCount());
+#endif
         }
         ImGui::End();
     }
@@ -157,7 +165,8 @@ namespace FastCG
             DebugMenuSystem::Create({});
 #endif
             GraphicsSystem::Create({mScreenWidth, mScreenHeight, mSettings.graphics.maxSimultaneousFrames,
-                                    mSettings.graphics.vsync, mSettings.graphics.headless});
+                                    mSettings.graphics.vsync, mSettings.graphics.headless,
+                                    mSettings.graphics.stagingBufferSize});
             InputSystem::Create({});
             ImGuiSystem::Create({mScreenWidth, mScreenHeight});
             RenderingSystem::Create({mSettings.rendering.path, mSettings.rendering.hdr, mScreenWidth, mScreenHeight,
@@ -7,6 +7,12 @@
 
 namespace
 {
+    constexpr FastCG::ShaderResourceId DIFFUSE_MAP_SHADER_RESOURCE_ID = FastCG::GetShaderResourceId("uDiffuseMap");
+    constexpr FastCG::ShaderResourceId NORMAL_MAP_SHADER_RESOURCE_ID = FastCG::GetShaderResourceId("uNormalMap");
+    constexpr FastCG::ShaderResourceId SPECULAR_MAP_SHADER_RESOURCE_ID = FastCG::GetShaderResourceId("uSpecularMap");
+    constexpr FastCG::ShaderResourceId TANGENT_MAP_SHADER_RESOURCE_ID = FastCG::GetShaderResourceId("uTangentMap");
+    constexpr FastCG::ShaderResourceId EXTRA_DATA_SHADER_RESOURCE_ID = FastCG::GetShaderResourceId("uExtraData");
+
     float CalculateLightBoundingSphereScale(const FastCG::PointLight *pPointLight)
     {
         auto uDiffuseColor = pPointLight->GetDiffuseColor();
@@ -101,25 +107,25 @@ namespace FastCG
     void DeferredWorldRenderer::BindGBuffer(GraphicsContext *pGraphicsContext) const
     {
         auto &rCurrentGBuffer = mGBuffers[GraphicsSystem::GetInstance()->GetCurrentFrame()];
-        pGraphicsContext->BindResource(rCurrentGBuffer[0], "uDiffuseMap");
-        pGraphicsContext->BindResource(rCurrentGBuffer[1], "uNormalMap");
-        pGraphicsContext->BindResource(rCurrentGBuffer[2], "uSpecularMap");
-        pGraphicsContext->BindResource(rCurrentGBuffer[3], "uTangentMap");
-        pGraphicsContext->BindResource(rCurrentGBuffer[4], "uExtraData");
+        pGraphicsContext->BindResource(rCurrentGBuffer[0], DIFFUSE_MAP_SHADER_RESOURCE_ID);
+        pGraphicsContext->BindResource(rCurrentGBuffer[1], NORMAL_MAP_SHADER_RESOURCE_ID);
+        pGraphicsContext->BindResource(rCurrentGBuffer[2], SPECULAR_MAP_SHADER_RESOURCE_ID);
+        pGraphicsContext->BindResource(rCurrentGBuffer[3], TANGENT_MAP_SHADER_RESOURCE_ID);
+        pGraphicsContext->BindResource(rCurrentGBuffer[4], EXTRA_DATA_SHADER_RESOURCE_ID);
         auto &rCurrentDepthStencilBuffer = mDepthStencilBuffers[GraphicsSystem::GetInstance()->GetCurrentFrame()];
-        pGraphicsContext->BindResource(rCurrentDepthStencilBuffer, "uDepth");
+        pGraphicsContext->BindResource(rCurrentDepthStencilBuffer, DEPTH_SHADER_RESOURCE_ID);
     }
 
-    const Buffer *DeferredWorldRenderer::UpdateLightingConstants(const PointLight *pPointLight,
-                                                                 GraphicsContext *pGraphicsContext)
+    UniformSlice DeferredWorldRenderer::UpdateLightingConstants(const PointLight *pPointLight,
+                                                                GraphicsContext *pGraphicsContext)
     {
         BindGBuffer(pGraphicsContext);
         return BaseWorldRenderer::UpdateLightingConstants(pPointLight, pGraphicsContext);
     }
 
-    const Buffer *DeferredWorldRenderer::UpdateLightingConstants(const DirectionalLight *pDirectionalLight,
-                                                                 const glm::vec3 &rViewDirection,
-                                                                 GraphicsContext *pGraphicsContext)
+    UniformSlice DeferredWorldRenderer::UpdateLightingConstants(const DirectionalLight *pDirectionalLight,
+                                                                const glm::vec3 &rViewDirection,
+                                                                GraphicsContext *pGraphicsContext)
     {
         BindGBuffer(pGraphicsContext);
         return BaseWorldRenderer::UpdateLightingConstants(pDirectionalLight, rViewDirection, pGraphicsContext);
@@ -179,11 +185,12 @@ namespace FastCG
 
             if (pCamera != nullptr)
             {
-                GenerateShadowMaps(pGraphicsContext);
-
                 const auto view = pCamera->GetView();
                 const auto inverseView = glm::inverse(view);
                 const auto nearClip = pCamera->GetNearClip();
+                const Frustum frustum(projection * view);
+
+                GenerateShadowMaps(frustum, pGraphicsContext);
 
                 pGraphicsContext->SetViewport(0, 0, rCurrentGBuffer[0]->GetWidth(), rCurrentGBuffer[0]->GetHeight());
                 pGraphicsContext->SetDepthTest(true);
@@ -196,80 +203,96 @@ namespace FastCG
                 pGraphicsContext->SetRenderTargets(rCurrentGBuffer.data(), (uint32_t)rCurrentGBuffer.size(),
                                                    pCurrentDepthStencilBuffer);
 
-                const auto *pSceneConstantsBuffer =
-                    UpdateSceneConstants(view, inverseView, projection, pGraphicsContext);
+                auto sceneConstants = UpdateSceneConstants(view, inverseView, projection, pGraphicsContext);
 
-                auto opaqueRenderBatchesIt = mArgs.rRenderBatchStrategy.GetFirstOpaqueMaterialRenderBatchIterator();
-                auto transparentRenderBatchesIt =
-                    mArgs.rRenderBatchStrategy.GetFirstTransparentMaterialRenderBatchIterator();
-                if (opaqueRenderBatchesIt != transparentRenderBatchesIt)
+                const auto &rDrawList =
+                    BuildDrawList(mArgs.rRenderBatchStrategy.GetFirstOpaqueMaterialRenderBatchIterator(),
+                                  mArgs.rRenderBatchStrategy.GetFirstTransparentMaterialRenderBatchIterator(), frustum,
+                                  view, nearClip, pCamera->GetFarClip());
+                if (!rDrawList.IsEmpty())
                 {
+                    const auto *pIndirectDrawBuffer = UpdateIndirectDrawCommands(rDrawList, frustum, pGraphicsContext);
+
                     pGraphicsContext->PushDebugMarker("Geometry Passes");
                     {
-                        for (; opaqueRenderBatchesIt != transparentRenderBatchesIt; ++opaqueRenderBatchesIt)
+                        // draws are sorted by shader, material and mesh, so only bind what changes between them
+                        const Shader *pLastShader = nullptr;
+                        const Material *pLastMaterial = nullptr;
+                        const Mesh *pLastMesh = nullptr;
+
+                        for (const auto &rDrawCommand : rDrawList.GetDrawCommands())
                         {
-                            const auto &rpMaterial = opaqueRenderBatchesIt->pMaterial;
+                            const auto *pMaterial = rDrawCommand.pMaterial;
+                            const auto *pMesh = rDrawCommand.pMesh;
 
-                            pGraphicsContext->PushDebugMarker((rpMaterial->GetName() + " Pass").c_str());
+                            if (pMaterial != pLastMaterial)
                             {
-                                assert(IsMaterialRenderGroup(opaqueRenderBatchesIt->group));
+                                if (pLastMaterial != nullptr)
+                                {
+                                    pGraphicsContext->PopDebugMarker();
+                                }
+                                pGraphicsContext->PushDebugMarker((pMaterial->GetName() + " Pass").c_str());
 
-                                BindMaterial(rpMaterial, pGraphicsContext);
-                                SetGraphicsContextState(rpMaterial->GetGraphicsContextState(), pGraphicsContext);
+                                if (pMaterial->GetShader() != pLastShader)
+                                {
+                                    pGraphicsContext->BindShader(pMaterial->GetShader());
 
-                                pGraphicsContext->BindResource(pSceneConstantsBuffer,
-                                                               SCENE_CONSTANTS_SHADER_RESOURCE_NAME);
+                                    // binding another shader resets the resource bindings
+                                    pGraphicsContext->BindResource(sceneConstants.pBuffer, sceneConstants.offset,
+                                                                   sceneConstants.size,
+                                                                   SCENE_CONSTANTS_SHADER_RESOURCE_ID);
 
-                                for (auto it = opaqueRenderBatchesIt->renderablesPerMesh.cbegin();
-                                     it != opaqueRenderBatchesIt->renderablesPerMesh.cend(); ++it)
-                                {
-                                    const auto &rpMesh = it->first;
-                                    const auto &rRenderables = it->second;
-
-                                    uint32_t instanceCount;
-                                    const Buffer *pInstanceConstantsBuffer;
-                                    {
-                                        auto result =
-                                            UpdateInstanceConstants(rRenderables, view, projection, pGraphicsContext);
-                                        instanceCount = result.first;
-                                        pInstanceConstantsBuffer = result.second;
-                                    }
-
-                                    if (instanceCount == 0)
-                                    {
-                                        continue;
-                                    }
-
-                                    pGraphicsContext->BindResource(pInstanceConstantsBuffer,
-                                                                   INSTANCE_CONSTANTS_SHADER_RESOURCE_NAME);
-
-                                    pGraphicsContext->SetVertexBuffers(rpMesh->GetVertexBuffers(),
-                                                                       rpMesh->GetVertexBufferCount());
-                                    pGraphicsContext->SetIndexBuffer(rpMesh->GetIndexBuffer());
-
-                                    if (instanceCount == 0)
-                                    {
-                                        pGraphicsContext->DrawIndexed(PrimitiveType::TRIANGLES, 0,
-                                                                      rpMesh->GetIndexCount(), 0);
-                                    }
-                                    else
-                                    {
-                                        pGraphicsContext->DrawInstancedIndexed(
-                                            PrimitiveType::TRIANGLES, 0, instanceCount, 0, rpMesh->GetIndexCount(), 0);
-                                    }
-
-                                    mArgs.rRenderingStatistics.drawCalls++;
-                                    mArgs.rRenderingStatistics.triangles += rpMesh->GetTriangleCount();
+                                    pLastShader = pMaterial->GetShader();
                                 }
+
+                                BindMaterialResources(pMaterial, pGraphicsContext);
+                                SetGraphicsContextState(pMaterial->GetGraphicsContextState(), pGraphicsContext);
+
+                                pLastMaterial = pMaterial;
                             }
-                            pGraphicsContext->PopDebugMarker();
+
+                            uint32_t instanceCount;
+                            UniformSlice instanceConstants;
+                            {
+                                auto result = UpdateInstanceConstants(rDrawList, rDrawCommand, pGraphicsContext);
+                                instanceCount = result.first;
+                                instanceConstants = result.second;
+                            }
+
+                            if (instanceCount == 0)
+                            {
+                                continue;
+                            }
+
+                            pGraphicsContext->BindResource(instanceConstants.pBuffer, instanceConstants.offset,
+                                                           instanceConstants.size,
+                                                           INSTANCE_CONSTANTS_SHADER_RESOURCE_ID);
+
+                            if (pMesh != pLastMesh)
+                            {
+                                pGraphicsContext->SetVertexBuffers(pMesh->GetVertexBuffers(),
+                                                                   pMesh->GetVertexBufferCount());
+                                pGraphicsContext->SetIndexBuffer(pMesh->GetIndexBuffer());
+
+                                pLastMesh = pMesh;
+                            }
+
+                            DrawInstances(rDrawList, rDrawCommand, instanceCount, pIndirectDrawBuffer,
+                                          pGraphicsContext);
+
+                            mArgs.rRenderingStatistics.drawCalls++;
+                            mArgs.rRenderingStatistics.triangles += pMesh->GetTriangleCount();
                         }
+
+                        pGraphicsContext->PopDebugMarker();
                     }
                     pGraphicsContext->PopDebugMarker();
                 }
 
-                const auto *pFogConstantsBuffer =
-                    UpdateFogConstants(WorldSystem::GetInstance()->GetFog(), pGraphicsContext);
+                // the draws of the next frame are tested against the depth of the geometry passes
+                GenerateHiZPyramid(pCurrentDepthStencilBuffer, pGraphicsContext);
+
+                auto fogConstants = UpdateFogConstants(WorldSystem::GetInstance()->GetFog(), pGraphicsContext);
 
                 pGraphicsContext->PushDebugMarker("Point Light Passes");
                 {
@@ -284,8 +307,8 @@ namespace FastCG
                             auto model = glm::scale(pPointLight->GetGameObject()->GetTransform()->GetModel(),
                                                     glm::vec3(CalculateLightBoundingSphereScale(pPointLight)));
 
-                            const auto *pInstanceConstantsBuffer =
-                                UpdateInstanceConstants(model, view, projection, pGraphicsContext);
+                            // shared by the stencil and the color sub-passes
+                            auto instanceConstants = UpdateInstanceConstants(model, pGraphicsContext);
 
                             pGraphicsContext->PushDebugMarker(
                                 (std::string("Point Light (") + std::to_string(i) + ") Stencil Sub-Pass").c_str());
@@ -306,8 +329,12 @@ namespace FastCG
 
                                 pGraphicsContext->BindShader(mpStencilPassShader);
 
-                                pGraphicsContext->BindResource(pInstanceConstantsBuffer,
-                                                               INSTANCE_CONSTANTS_SHADER_RESOURCE_NAME);
+                                pGraphicsContext->BindResource(sceneConstants.pBuffer, sceneConstants.offset,
+                                                               sceneConstants.size,
+                                                               SCENE_CONSTANTS_SHADER_RESOURCE_ID);
+                                pGraphicsContext->BindResource(instanceConstants.pBuffer, instanceConstants.offset,
+                                                               instanceConstants.size,
+                                                               INSTANCE_CONSTANTS_SHADER_RESOURCE_ID);
 
                                 pGraphicsContext->SetVertexBuffers(mpSphereMesh->GetVertexBuffers(),
                                                                    mpSphereMesh->GetVertexBufferCount());
@@ -337,26 +364,27 @@ namespace FastCG
 
                                 pGraphicsContext->BindShader(mpPointLightPassShader);
 
-                                pGraphicsContext->BindResource(pSceneConstantsBuffer,
-                                                               SCENE_CONSTANTS_SHADER_RESOURCE_NAME);
-                                pGraphicsContext->BindResource(pFogConstantsBuffer, FOG_CONSTANTS_SHADER_RESOURCE_NAME);
+                                pGraphicsContext->BindResource(sceneConstants.pBuffer, sceneConstants.offset,
+                                                               sceneConstants.size,
+                                                               SCENE_CONSTANTS_SHADER_RESOURCE_ID);
+                                pGraphicsContext->BindResource(fogConstants.pBuffer, fogConstants.offset,
+                                                               fogConstants.size, FOG_CONSTANTS_SHADER_RESOURCE_ID);
 
                                 UpdateSSAOConstants(isSSAOEnabled, pGraphicsContext);
 
-                                pInstanceConstantsBuffer =
-                                    UpdateInstanceConstants(model, view, projection, pGraphicsContext);
-                                pGraphicsContext->BindResource(pInstanceConstantsBuffer,
-                                                               INSTANCE_CONSTANTS_SHADER_RESOURCE_NAME);
+                                pGraphicsContext->BindResource(instanceConstants.pBuffer, instanceConstants.offset,
+                                                               instanceConstants.size,
+                                                               INSTANCE_CONSTANTS_SHADER_RESOURCE_ID);
 
-                                const auto *pLightingConstantsBuffer =
-                                    UpdateLightingConstants(pPointLight, pGraphicsContext);
-                                pGraphicsContext->BindResource(pLightingConstantsBuffer,
-                                                               LIGHTING_CONSTANTS_SHADER_RESOURCE_NAME);
+                                auto lightingConstants = UpdateLightingConstants(pPointLight, pGraphicsContext);
+                                pGraphicsContext->BindResource(lightingConstants.pBuffer, lightingConstants.offset,
+                                                               lightingConstants.size,
+                                                               LIGHTING_CONSTANTS_SHADER_RESOURCE_ID);
 
-                                const auto *pPCSSConstantsBuffer =
-                                    UpdatePCSSConstants(pPointLight, nearClip, pGraphicsContext);
-                                pGraphicsContext->BindResource(pPCSSConstantsBuffer,
-                                                               PCSS_CONSTANTS_SHADER_RESOURCE_NAME);
+                                auto pcssConstants = UpdatePCSSConstants(pPointLight, nearClip, pGraphicsContext);
+                                pGraphicsContext->BindResource(pcssConstants.pBuffer, pcssConstants.offset,
+                                                               pcssConstants.size,
+                                                               PCSS_CONSTANTS_SHADER_RESOURCE_ID);
 
                                 pGraphicsContext->SetVertexBuffers(mpSphereMesh->GetVertexBuffers(),
                                                                    mpSphereMesh->GetVertexBufferCount());
@@ -388,8 +416,10 @@ namespace FastCG
 
                     pGraphicsContext->BindShader(mpDirectionalLightPassShader);
 
-                    pGraphicsContext->BindResource(pSceneConstantsBuffer, SCENE_CONSTANTS_SHADER_RESOURCE_NAME);
-                    pGraphicsContext->BindResource(pFogConstantsBuffer, FOG_CONSTANTS_SHADER_RESOURCE_NAME);
+                    pGraphicsContext->BindResource(sceneConstants.pBuffer, sceneConstants.offset, sceneConstants.size,
+                                                   SCENE_CONSTANTS_SHADER_RESOURCE_ID);
+                    pGraphicsContext->BindResource(fogConstants.pBuffer, fogConstants.offset, fogConstants.size,
+                                                   FOG_CONSTANTS_SHADER_RESOURCE_ID);
 
                     UpdateSSAOConstants(isSSAOEnabled, pGraphicsContext);
 
@@ -400,13 +430,14 @@ namespace FastCG
                         pGraphicsContext->PushDebugMarker(
                             (std::string("Directional Light Pass (") + std::to_string(i) + ")").c_str());
                         {
-                            const auto *pLightingConstantsBuffer = UpdateLightingConstants(
+                            auto lightingConstants = UpdateLightingConstants(
                                 pDirectionalLight, pDirectionalLight->GetDirection(), pGraphicsContext);
-                            pGraphicsContext->BindResource(pLightingConstantsBuffer,
-                                                           LIGHTING_CONSTANTS_SHADER_RESOURCE_NAME);
-                            const auto *pPCSSConstantsBuffer =
-                                UpdatePCSSConstants(pDirectionalLight, nearClip, pGraphicsContext);
-                            pGraphicsContext->BindResource(pPCSSConstantsBuffer, PCSS_CONSTANTS_SHADER_RESOURCE_NAME);
+                            pGraphicsContext->BindResource(lightingConstants.pBuffer, lightingConstants.offset,
+                                                           lightingConstants.size,
+                                                           LIGHTING_CONSTANTS_SHADER_RESOURCE_ID);
+                            auto pcssConstants = UpdatePCSSConstants(pDirectionalLight, nearClip, pGraphicsContext);
+                            pGraphicsContext->BindResource(pcssConstants.pBuffer, pcssConstants.offset,
+                                                           pcssConstants.size, PCSS_CONSTANTS_SHADER_RESOURCE_ID);
 
                             pGraphicsContext->SetVertexBuffers(mpQuadMesh->GetVertexBuffers(),
                                                                mpQuadMesh->GetVertexBufferCount());
@@ -421,8 +452,7 @@ namespace FastCG
                 }
                 pGraphicsContext->PopDebugMarker();
 
-                RenderSkybox(rCurrentGBuffer[5], pCurrentDepthStencilBuffer, pSceneConstantsBuffer, view, projection,
-                             pGraphicsContext);
+                RenderSkybox(rCurrentGBuffer[5], pCurrentDepthStencilBuffer, sceneConstants, pGraphicsContext);
 
                 pGraphicsContext->PushDebugMarker("Transparent Passes");
                 {
@@ -0,0 +1,140 @@
+#include <FastCG/Rendering/DrawList.h>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+
+namespace
+{
+    constexpr uint32_t ORDER_BITS = 8;
+    constexpr uint32_t SHADER_ID_BITS = 12;
+    constexpr uint32_t MATERIAL_ID_BITS = 16;
+    constexpr uint32_t MESH_ID_BITS = 12;
+    constexpr uint32_t DEPTH_BITS = 16;
+
+    constexpr uint64_t Mask(uint32_t bits)
+    {
+        return (1ull << bits) - 1;
+    }
+
+    // LSD radix sort (stable), one byte per pass, skipping passes in which all keys share the same byte
+    void RadixSort(std::vector<std::pair<FastCG::DrawSortKey, uint32_t>> &rEntries,
+                   std::vector<std::pair<FastCG::DrawSortKey, uint32_t>> &rScratch)
+    {
+        rScratch.resize(rEntries.size());
+        for (uint32_t shift = 0; shift < 64; shift += 8)
+        {
+            std::array<size_t, 256> offsets{};
+            for (const auto &rEntry : rEntries)
+            {
+                offsets[(rEntry.first >> shift) & 0xff]++;
+            }
+            if (offsets[(rEntries[0].first >> shift) & 0xff] == rEntries.size())
+            {
+                continue;
+            }
+            size_t offset = 0;
+            for (auto &rOffset : offsets)
+            {
+                auto count = rOffset;
+                rOffset = offset;
+                offset += count;
+            }
+            for (const auto &rEntry : rEntries)
+            {
+                rScratch[offsets[(rEntry.first >> shift) & 0xff]++] = rEntry;
+            }
+            rEntries.swap(rScratch);
+        }
+    }
+
+}
+
+namespace FastCG
+{
+    void DrawList::Clear()
+    {
+        mDrawCommands.clear();
+        mRenderables.clear();
+        mIds.clear();
+        mLastShaderId = 0;
+        mLastMaterialId = 0;
+        mLastMeshId = 0;
+    }
+
+    void DrawList::Add(RenderGroup group, const Material *pMaterial, const Mesh *pMesh,
+                       const std::vector<const Renderable *> &rRenderables, float normalizedDepth)
+    {
+        assert(IsMaterialRenderGroup(group));
+        assert(pMaterial != nullptr);
+        assert(pMesh != nullptr);
+
+        if (rRenderables.empty())
+        {
+            return;
+        }
+
+        // group + material order can exceed the order field, so saturate it instead of letting it wrap around
+        // (which would move, e.g., a transparent material in front of the opaque ones)
+        uint64_t order = std::min<uint64_t>((uint64_t)group + pMaterial->GetOrder(), Mask(ORDER_BITS));
+        uint64_t shaderId = GetId(pMaterial->GetShader(), mLastShaderId) & Mask(SHADER_ID_BITS);
+        uint64_t materialId = GetId(pMaterial, mLastMaterialId) & Mask(MATERIAL_ID_BITS);
+        uint64_t meshId = GetId(pMesh, mLastMeshId) & Mask(MESH_ID_BITS);
+        uint64_t depth = (uint64_t)(std::clamp(normalizedDepth, 0.0f, 1.0f) * Mask(DEPTH_BITS));
+
+        DrawSortKey sortKey;
+        if (group == RenderGroup::TRANSPARENT_MATERIAL)
+        {
+            depth = Mask(DEPTH_BITS) - depth;
+            sortKey = (order << 56) | (depth << 40) | (shaderId << 28) | (materialId << 12) | meshId;
+        }
+        else
+        {
+            sortKey = (order << 56) | (shaderId << 44) | (materialId << 28) | (depth << 12) | meshId;
+        }
+
+        auto firstRenderable = (uint32_t)mRenderables.size();
+        mRenderables.insert(mRenderables.end(), rRenderables.begin(), rRenderables.end());
+        // the instance constants hold at most MAX_NUM_INSTANCES instances
+        for (uint32_t i = 0; i < (uint32_t)rRenderables.size(); i += MAX_NUM_INSTANCES)
+        {
+            mDrawCommands.emplace_back(
+                DrawCommand{sortKey, pMaterial, pMesh, firstRenderable + i,
+                            std::min(MAX_NUM_INSTANCES, (uint32_t)rRenderables.size() - i), i / MAX_NUM_INSTANCES});
+        }
+    }
+
+    void DrawList::Sort()
+    {
+        if (mDrawCommands.size() < 2)
+        {
+            return;
+        }
+
+        mSortEntries.resize(mDrawCommands.size());
+        for (uint32_t i = 0; i < (uint32_t)mDrawCommands.size(); ++i)
+        {
+            mSortEntries[i] = {mDrawCommands[i].sortKey, i};
+        }
+
+        RadixSort(mSortEntries, mSortScratch);
+
+        mSortedDrawCommands.resize(mDrawCommands.size());
+        for (size_t i = 0; i < mSortEntries.size(); ++i)
+        {
+            mSortedDrawCommands[i] = mDrawCommands[mSortEntries[i].second];
+        }
+        mDrawCommands.swap(mSortedDrawCommands);
+    }
+
+    uint32_t DrawList::GetId(const void *pObject, uint32_t &rLastId)
+    {
+        auto it = mIds.find(pObject);
+        if (it == mIds.end())
+        {
+            it = mIds.emplace(pObject, rLastId++).first;
+        }
+        return it->second;
+    }
+
+}
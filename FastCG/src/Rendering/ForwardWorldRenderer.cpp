@@ -116,11 +116,12 @@ namespace FastCG
 
             if (pCamera != nullptr)
             {
-                GenerateShadowMaps(pGraphicsContext);
-
                 const auto view = pCamera->GetView();
                 const auto inverseView = glm::inverse(view);
                 const auto nearClip = pCamera->GetNearClip();
+                const Frustum frustum(projection * view);
+
+                GenerateShadowMaps(frustum, pGraphicsContext);
 
                 pGraphicsContext->SetViewport(0, 0, pCurrentRenderTarget->GetWidth(),
                                               pCurrentRenderTarget->GetHeight());
@@ -133,205 +134,226 @@ namespace FastCG
                 pGraphicsContext->SetBlend(false);
                 pGraphicsContext->SetRenderTargets(&pCurrentRenderTarget, 1, pCurrentDepthStencilBuffer);
 
-                const auto *pSceneConstantsBuffer =
-                    UpdateSceneConstants(view, inverseView, projection, pGraphicsContext);
+                auto sceneConstants = UpdateSceneConstants(view, inverseView, projection, pGraphicsContext);
 
                 auto ProcessMaterialPasses = [&](const auto &rFirstRenderBatchIt, const auto &rLastRenderBatchIt) {
-                    const auto *pFogConstantsBuffer =
-                        UpdateFogConstants(WorldSystem::GetInstance()->GetFog(), pGraphicsContext);
+                    const auto &rDrawList = BuildDrawList(rFirstRenderBatchIt, rLastRenderBatchIt, frustum, view,
+                                                          nearClip, pCamera->GetFarClip());
+                    if (rDrawList.IsEmpty())
+                    {
+                        return;
+                    }
+
+                    const auto *pIndirectDrawBuffer = UpdateIndirectDrawCommands(rDrawList, frustum, pGraphicsContext);
+
+                    auto fogConstants = UpdateFogConstants(WorldSystem::GetInstance()->GetFog(), pGraphicsContext);
+
+                    const auto &rDirectionalLights = WorldSystem::GetInstance()->GetDirectionalLights();
+                    const auto &rPointLights = WorldSystem::GetInstance()->GetPointLights();
 
-                    for (auto renderBatchIt = rFirstRenderBatchIt; renderBatchIt != rLastRenderBatchIt; ++renderBatchIt)
+                    // draws are sorted by shader, material and mesh, so only bind what changes between them
+                    const Shader *pLastShader = nullptr;
+                    const Material *pLastMaterial = nullptr;
+                    const Mesh *pLastMesh = nullptr;
+                    // secondary light sub-passes override the material's graphics context state
+                    auto isGraphicsContextStateDirty = false;
+
+                    for (const auto &rDrawCommand : rDrawList.GetDrawCommands())
                     {
-                        const auto &rpMaterial = renderBatchIt->pMaterial;
+                        const auto *pMaterial = rDrawCommand.pMaterial;
+                        const auto *pMesh = rDrawCommand.pMesh;
 
-                        pGraphicsContext->PushDebugMarker((rpMaterial->GetName() + " Pass").c_str());
+                        if (pMaterial != pLastMaterial)
                         {
-                            BindMaterial(rpMaterial, pGraphicsContext);
+                            if (pLastMaterial != nullptr)
+                            {
+                                pGraphicsContext->PopDebugMarker();
+                            }
+                            pGraphicsContext->PushDebugMarker((pMaterial->GetName() + " Pass").c_str());
 
-                            pGraphicsContext->BindResource(pSceneConstantsBuffer, SCENE_CONSTANTS_SHADER_RESOURCE_NAME);
-                            pGraphicsContext->BindResource(pFogConstantsBuffer, FOG_CONSTANTS_SHADER_RESOURCE_NAME);
+                            if (pMaterial->GetShader() != pLastShader)
+                            {
+                                pGraphicsContext->BindShader(pMaterial->GetShader());
 
-                            UpdateSSAOConstants(isSSAOEnabled, pGraphicsContext);
+                                // binding another shader resets the resource bindings
+                                pGraphicsContext->BindResource(sceneConstants.pBuffer, sceneConstants.offset,
+                                                               sceneConstants.size,
+                                                               SCENE_CONSTANTS_SHADER_RESOURCE_ID);
+                                pGraphicsContext->BindResource(fogConstants.pBuffer, fogConstants.offset,
+                                                               fogConstants.size, FOG_CONSTANTS_SHADER_RESOURCE_ID);
 
-                            for (auto it = renderBatchIt->renderablesPerMesh.cbegin();
-                                 it != renderBatchIt->renderablesPerMesh.cend(); ++it)
-                            {
-                                SetGraphicsContextState(rpMaterial->GetGraphicsContextState(), pGraphicsContext);
+                                UpdateSSAOConstants(isSSAOEnabled, pGraphicsContext);
 
-                                const auto &rpMesh = it->first;
-                                const auto &rRenderables = it->second;
+                                pLastShader = pMaterial->GetShader();
+                            }
 
-                                uint32_t instanceCount;
-                                const Buffer *pInstanceConstantsBuffer;
-                                {
-                                    auto result =
-                                        UpdateInstanceConstants(rRenderables, view, projection, pGraphicsContext);
-                                    instanceCount = result.first;
-                                    pInstanceConstantsBuffer = result.second;
-                                }
+                            BindMaterialResources(pMaterial, pGraphicsContext);
+                            SetGraphicsContextState(pMaterial->GetGraphicsContextState(), pGraphicsContext);
+                            isGraphicsContextStateDirty = false;
 
-                                if (instanceCount == 0)
-                                {
-                                    continue;
-                                }
+                            pLastMaterial = pMaterial;
+                        }
+                        else if (isGraphicsContextStateDirty)
+                        {
+                            SetGraphicsContextState(pMaterial->GetGraphicsContextState(), pGraphicsContext);
+                            isGraphicsContextStateDirty = false;
+                        }
+
+                        uint32_t instanceCount;
+                        UniformSlice instanceConstants;
+                        {
+                            auto result = UpdateInstanceConstants(rDrawList, rDrawCommand, pGraphicsContext);
+                            instanceCount = result.first;
+                            instanceConstants = result.second;
+                        }
+
+                        if (instanceCount == 0)
+                        {
+                            continue;
+                        }
+
+                        pGraphicsContext->BindResource(instanceConstants.pBuffer, instanceConstants.offset,
+                                                       instanceConstants.size,
+                                                       INSTANCE_CONSTANTS_SHADER_RESOURCE_ID);
+
+                        if (pMesh != pLastMesh)
+                        {
+                            pGraphicsContext->SetVertexBuffers(pMesh->GetVertexBuffers(),
+                                                               pMesh->GetVertexBufferCount());
+                            pGraphicsContext->SetIndexBuffer(pMesh->GetIndexBuffer());
 
-                                pGraphicsContext->BindResource(pInstanceConstantsBuffer,
-                                                               INSTANCE_CONSTANTS_SHADER_RESOURCE_NAME);
+                            pLastMesh = pMesh;
+                        }
 
-                                pGraphicsContext->SetVertexBuffers(rpMesh->GetVertexBuffers(),
-                                                                   rpMesh->GetVertexBufferCount());
-                                pGraphicsContext->SetIndexBuffer(rpMesh->GetIndexBuffer());
+                        if (rDirectionalLights.size() == 0 && rPointLights.size() == 0)
+                        {
+                            auto lightingConstants = EmptyLightingConstants(pGraphicsContext);
+                            pGraphicsContext->BindResource(lightingConstants.pBuffer, lightingConstants.offset,
+                                                           lightingConstants.size,
+                                                           LIGHTING_CONSTANTS_SHADER_RESOURCE_ID);
+                            auto pcssConstants = EmptyPCSSConstants(pGraphicsContext);
+                            pGraphicsContext->BindResource(pcssConstants.pBuffer, pcssConstants.offset,
+                                                           pcssConstants.size, PCSS_CONSTANTS_SHADER_RESOURCE_ID);
+
+                            DrawInstances(rDrawList, rDrawCommand, instanceCount, pIndirectDrawBuffer,
+                                          pGraphicsContext);
+
+                            mArgs.rRenderingStatistics.drawCalls++;
+                            mArgs.rRenderingStatistics.triangles += pMesh->GetTriangleCount();
+                        }
+                        else
+                        {
+                            enum class SubpassType : uint8_t
+                            {
+                                ST_NONE = 0,
+                                ST_MAIN,
+                                ST_SECONDARY
+                            };
 
-                                const auto &rDirectionalLights = WorldSystem::GetInstance()->GetDirectionalLights();
-                                const auto &rPointLights = WorldSystem::GetInstance()->GetPointLights();
+                            SubpassType lastSubpassType{SubpassType::ST_NONE};
 
-                                if (rDirectionalLights.size() == 0 && rPointLights.size() == 0)
+                            for (size_t i = 0; i < rDirectionalLights.size(); i++)
+                            {
+                                pGraphicsContext->PushDebugMarker((pMaterial->GetName() +
+                                                                   " Directional Light Sub-Pass (" +
+                                                                   std::to_string(i) + ")")
+                                                                      .c_str());
                                 {
-                                    const auto *pLightingConstantsBuffer = EmptyLightingConstants(pGraphicsContext);
-                                    pGraphicsContext->BindResource(pLightingConstantsBuffer,
-                                                                   LIGHTING_CONSTANTS_SHADER_RESOURCE_NAME);
-                                    const auto *pPCSSConstantsBuffer = EmptyPCSSConstants(pGraphicsContext);
-                                    pGraphicsContext->BindResource(pPCSSConstantsBuffer,
-                                                                   PCSS_CONSTANTS_SHADER_RESOURCE_NAME);
-
-                                    if (instanceCount == 1)
+                                    switch (lastSubpassType)
                                     {
-                                        pGraphicsContext->DrawIndexed(PrimitiveType::TRIANGLES, 0,
-                                                                      rpMesh->GetIndexCount(), 0);
-                                    }
-                                    else
-                                    {
-                                        pGraphicsContext->DrawInstancedIndexed(
-                                            PrimitiveType::TRIANGLES, 0, instanceCount, 0, rpMesh->GetIndexCount(), 0);
+                                    case SubpassType::ST_MAIN:
+                                        SetupMeshSecondarySubPasses(pGraphicsContext);
+                                        break;
+                                    default:
+                                        break;
                                     }
 
+                                    const auto *pDirectionalLight = rDirectionalLights[i];
+
+                                    auto lightingConstants = UpdateLightingConstants(
+                                        pDirectionalLight, pDirectionalLight->GetDirection(), pGraphicsContext);
+                                    pGraphicsContext->BindResource(lightingConstants.pBuffer, lightingConstants.offset,
+                                                                   lightingConstants.size,
+                                                                   LIGHTING_CONSTANTS_SHADER_RESOURCE_ID);
+                                    auto pcssConstants =
+                                        UpdatePCSSConstants(pDirectionalLight, nearClip, pGraphicsContext);
+                                    pGraphicsContext->BindResource(pcssConstants.pBuffer, pcssConstants.offset,
+                                                                   pcssConstants.size,
+                                                                   PCSS_CONSTANTS_SHADER_RESOURCE_ID);
+
+                                    DrawInstances(rDrawList, rDrawCommand, instanceCount, pIndirectDrawBuffer,
+                                                  pGraphicsContext);
+
                                     mArgs.rRenderingStatistics.drawCalls++;
-                                    mArgs.rRenderingStatistics.triangles += rpMesh->GetTriangleCount();
+
+                                    switch (lastSubpassType)
+                                    {
+                                    case SubpassType::ST_NONE:
+                                        lastSubpassType = SubpassType::ST_MAIN;
+                                        break;
+                                    case SubpassType::ST_MAIN:
+                                        lastSubpassType = SubpassType::ST_SECONDARY;
+                                        break;
+                                    default:
+                                        break;
+                                    }
                                 }
-                                else
+                                pGraphicsContext->PopDebugMarker();
+                            }
+
+                            for (size_t i = 0; i < rPointLights.size(); i++)
+                            {
+                                pGraphicsContext->PushDebugMarker((pMaterial->GetName() + " Point Light Sub-Pass (" +
+                                                                   std::to_string(i) + ")")
+                                                                      .c_str());
                                 {
-                                    enum class SubpassType : uint8_t
+                                    switch (lastSubpassType)
                                     {
-                                        ST_NONE = 0,
-                                        ST_MAIN,
-                                        ST_SECONDARY
-                                    };
+                                    case SubpassType::ST_MAIN:
+                                        SetupMeshSecondarySubPasses(pGraphicsContext);
+                                        break;
+                                    default:
+                                        break;
+                                    }
 
-                                    SubpassType lastSubpassType{SubpassType::ST_NONE};
+                                    auto lightingConstants =
+                                        UpdateLightingConstants(rPointLights[i], pGraphicsContext);
+                                    pGraphicsContext->BindResource(lightingConstants.pBuffer, lightingConstants.offset,
+                                                                   lightingConstants.size,
+                                                                   LIGHTING_CONSTANTS_SHADER_RESOURCE_ID);
+                                    auto pcssConstants =
+                                        UpdatePCSSConstants(rPointLights[i], nearClip, pGraphicsContext);
+                                    pGraphicsContext->BindResource(pcssConstants.pBuffer, pcssConstants.offset,
+                                                                   pcssConstants.size,
+                                                                   PCSS_CONSTANTS_SHADER_RESOURCE_ID);
 
-                                    for (size_t i = 0; i < rDirectionalLights.size(); i++)
-                                    {
-                                        pGraphicsContext->PushDebugMarker((rpMaterial->GetName() +
-                                                                           " Directional Light Sub-Pass (" +
-                                                                           std::to_string(i) + ")")
-                                                                              .c_str());
-                                        {
-                                            switch (lastSubpassType)
-                                            {
-                                            case SubpassType::ST_MAIN:
-                                                SetupMeshSecondarySubPasses(pGraphicsContext);
-                                                break;
-                                            default:
-                                                break;
-                                            }
-
-                                            const auto *pDirectionalLight = rDirectionalLights[i];
-
-                                            const auto *pLightingConstantsBuffer = UpdateLightingConstants(
-                                                pDirectionalLight, pDirectionalLight->GetDirection(), pGraphicsContext);
-                                            pGraphicsContext->BindResource(pLightingConstantsBuffer,
-                                                                           LIGHTING_CONSTANTS_SHADER_RESOURCE_NAME);
-                                            const auto *pPCSSConstantsBuffer =
-                                                UpdatePCSSConstants(pDirectionalLight, nearClip, pGraphicsContext);
-                                            pGraphicsContext->BindResource(pPCSSConstantsBuffer,
-                                                                           PCSS_CONSTANTS_SHADER_RESOURCE_NAME);
-
-                                            if (instanceCount == 1)
-                                            {
-                                                pGraphicsContext->DrawIndexed(PrimitiveType::TRIANGLES, 0,
-                                                                              rpMesh->GetIndexCount(), 0);
-                                            }
-                                            else
-                                            {
-                                                pGraphicsContext->DrawInstancedIndexed(PrimitiveType::TRIANGLES, 0,
-                                                                                       instanceCount, 0,
-                                                                                       rpMesh->GetIndexCount(), 0);
-                                            }
-
-                                            mArgs.rRenderingStatistics.drawCalls++;
-
-                                            switch (lastSubpassType)
-                                            {
-                                            case SubpassType::ST_NONE:
-                                                lastSubpassType = SubpassType::ST_MAIN;
-                                                break;
-                                            case SubpassType::ST_MAIN:
-                                                lastSubpassType = SubpassType::ST_SECONDARY;
-                                                break;
-                                            default:
-                                                break;
-                                            }
-                                        }
-                                        pGraphicsContext->PopDebugMarker();
-                                    }
+                                    DrawInstances(rDrawList, rDrawCommand, instanceCount, pIndirectDrawBuffer,
+                                                  pGraphicsContext);
 
-                                    for (size_t i = 0; i < rPointLights.size(); i++)
+                                    mArgs.rRenderingStatistics.drawCalls++;
+
+                                    switch (lastSubpassType)
                                     {
-                                        pGraphicsContext->PushDebugMarker((rpMaterial->GetName() +
-                                                                           " Point Light Sub-Pass (" +
-                                                                           std::to_string(i) + ")")
-                                                                              .c_str());
-                                        {
-                                            switch (lastSubpassType)
-                                            {
-                                            case SubpassType::ST_MAIN:
-                                                SetupMeshSecondarySubPasses(pGraphicsContext);
-                                                break;
-                                            default:
-                                                break;
-                                            }
-
-                                            const auto *pLightingConstantsBuffer =
-                                                UpdateLightingConstants(rPointLights[i], pGraphicsContext);
-                                            pGraphicsContext->BindResource(pLightingConstantsBuffer,
-                                                                           LIGHTING_CONSTANTS_SHADER_RESOURCE_NAME);
-                                            const auto *pPCSSConstantsBuffer =
-                                                UpdatePCSSConstants(rPointLights[i], nearClip, pGraphicsContext);
-                                            pGraphicsContext->BindResource(pPCSSConstantsBuffer,
-                                                                           PCSS_CONSTANTS_SHADER_RESOURCE_NAME);
-
-                                            if (instanceCount == 1)
-                                            {
-                                                pGraphicsContext->DrawIndexed(PrimitiveType::TRIANGLES, 0,
-                                                                              rpMesh->GetIndexCount(), 0);
-                                            }
-                                            else
-                                            {
-                                                pGraphicsContext->DrawInstancedIndexed(PrimitiveType::TRIANGLES, 0,
-                                                                                       instanceCount, 0,
-                                                                                       rpMesh->GetIndexCount(), 0);
-                                            }
-
-                                            mArgs.rRenderingStatistics.drawCalls++;
-
-                                            switch (lastSubpassType)
-                                            {
-                                            case SubpassType::ST_NONE:
-                                                lastSubpassType = SubpassType::ST_MAIN;
-                                                break;
-                                            case SubpassType::ST_MAIN:
-                                                lastSubpassType = SubpassType::ST_SECONDARY;
-                                                break;
-                                            default:
-                                                break;
-                                            }
-                                        }
-                                        pGraphicsContext->PopDebugMarker();
+                                    case SubpassType::ST_NONE:
+                                        lastSubpassType = SubpassType::ST_MAIN;
+                                        break;
+                                    case SubpassType::ST_MAIN:
+                                        lastSubpassType = SubpassType::ST_SECONDARY;
+                                        break;
+                                    default:
+                                        break;
                                     }
-                                    mArgs.rRenderingStatistics.triangles += rpMesh->GetTriangleCount();
                                 }
+                                pGraphicsContext->PopDebugMarker();
                             }
+                            mArgs.rRenderingStatistics.triangles += pMesh->GetTriangleCount();
+
+                            isGraphicsContextStateDirty = lastSubpassType == SubpassType::ST_SECONDARY;
                         }
+                    }
+
+                    if (pLastMaterial != nullptr)
+                    {
                         pGraphicsContext->PopDebugMarker();
                     }
                 };
@@ -348,8 +370,10 @@ namespace FastCG
                     pGraphicsContext->PopDebugMarker();
                 }
 
-                RenderSkybox(pCurrentRenderTarget, pCurrentDepthStencilBuffer, pSceneConstantsBuffer, view, projection,
-                             pGraphicsContext);
+                // transparent draws (and the draws of the next frame) are tested against opaque geometry only
+                GenerateHiZPyramid(pCurrentDepthStencilBuffer, pGraphicsContext);
+
+                RenderSkybox(pCurrentRenderTarget, pCurrentDepthStencilBuffer, sceneConstants, pGraphicsContext);
 
                 auto lastRenderBatchIt = mArgs.rRenderBatchStrategy.GetLastRenderBatchIterator();
                 if (transparentRenderBatchesIt != lastRenderBatchIt)
@@ -11,10 +11,19 @@ namespace FastCG
     Material::Material(const MaterialArgs &rArgs)
         : mName(rArgs.name), mOrder(std::min<RenderGroupInt>(FastCG::MATERIAL_ORDER_USER_SPACE, rArgs.order)),
           mpMaterialDefinition(rArgs.pMaterialDefinition), mConstants(rArgs.pMaterialDefinition->GetConstantBuffer()),
-          mpConstantBuffer(nullptr), mTextures(rArgs.pMaterialDefinition->GetTextures())
+          mpConstantBuffer(nullptr)
     {
         assert(mpMaterialDefinition != nullptr);
 
+        const auto &rTextures = mpMaterialDefinition->GetTextures();
+        mTextureIndices.reserve(rTextures.size());
+        mTextureBindings.reserve(rTextures.size());
+        for (const auto &rEntry : rTextures)
+        {
+            mTextureIndices.emplace(rEntry.first, mTextureBindings.size());
+            mTextureBindings.emplace_back(GetShaderResourceId(rEntry.first.c_str()), rEntry.second);
+        }
+
         if (mConstants.GetSize() > 0)
         {
             mpConstantBuffer = GraphicsSystem::GetInstance()->CreateBuffer(
@@ -13,14 +13,6 @@ namespace
         return order;
     }
 
-    struct RenderBatchComparer
-    {
-        bool operator()(const FastCG::RenderBatch &rLhs, const FastCG::RenderBatch &rRhs) const
-        {
-            return GetOrder(rLhs) < GetOrder(rRhs);
-        }
-    };
-
 }
 
 namespace FastCG
@@ -58,6 +50,8 @@ namespace FastCG
     {
         assert(pRenderable != nullptr);
 
+        mRenderableRemovalCount++;
+
         if (pRenderable->GetMesh() == nullptr)
         {
             return;
@@ -85,12 +79,12 @@ namespace FastCG
 
     void RenderBatchStrategy::AddToShadowCastersRenderBatch(const Renderable *pRenderable)
     {
-        AddToRenderBatch(GetShadowCastersRenderBatchIterator(), pRenderable);
+        AddToRenderBatch(GetShadowCastersRenderBatchIterator(), mShadowCasterIndices, pRenderable);
     }
 
     void RenderBatchStrategy::RemoveFromShadowCastersRenderBatch(const Renderable *pRenderable)
     {
-        RemoveFromRenderBatch(GetShadowCastersRenderBatchIterator(), pRenderable);
+        RemoveFromRenderBatch(GetShadowCastersRenderBatchIterator(), mShadowCasterIndices, pRenderable);
     }
 
     void RenderBatchStrategy::AddToSkyboxRenderBatch(const Renderable *pRenderable)
@@ -118,18 +112,12 @@ namespace FastCG
         auto materialRenderBatchIt = GetMaterialRenderBatchIterator(rpMaterial);
         if (materialRenderBatchIt == mRenderBatches.end())
         {
-            materialRenderBatchIt =
-                mRenderBatches.insert(mRenderBatches.end(), RenderBatch{rpMaterial->GetGraphicsContextState().blend
-                                                                            ? RenderGroup::TRANSPARENT_MATERIAL
-                                                                            : RenderGroup::OPAQUE_MATERIAL,
-                                                                        rpMaterial});
-            AddToRenderBatch(materialRenderBatchIt, pRenderable);
-            std::sort(mRenderBatches.begin(), mRenderBatches.end(), RenderBatchComparer());
-        }
-        else
-        {
-            AddToRenderBatch(materialRenderBatchIt, pRenderable);
+            materialRenderBatchIt = InsertMaterialRenderBatch(RenderBatch{rpMaterial->GetGraphicsContextState().blend
+                                                                              ? RenderGroup::TRANSPARENT_MATERIAL
+                                                                              : RenderGroup::OPAQUE_MATERIAL,
+                                                                          rpMaterial});
         }
+        AddToRenderBatch(materialRenderBatchIt, mMaterialRenderableIndices, pRenderable);
     }
 
     void RenderBatchStrategy::RemoveFromMaterialRenderBatch(const Renderable *pRenderable)
@@ -137,11 +125,47 @@ namespace FastCG
         const auto &rpMaterial = pRenderable->GetMaterial();
         auto materialRenderBatchIt = GetMaterialRenderBatchIterator(rpMaterial);
         assert(materialRenderBatchIt != mRenderBatches.end());
-        RemoveFromRenderBatch(materialRenderBatchIt, pRenderable);
+        RemoveFromRenderBatch(materialRenderBatchIt, mMaterialRenderableIndices, pRenderable);
+    }
+
+    RenderBatchStrategy::RenderBatches::iterator RenderBatchStrategy::InsertMaterialRenderBatch(
+        RenderBatch &&rRenderBatch)
+    {
+        auto order = GetOrder(rRenderBatch);
+        // insert after the last batch with the same order (ie, before the first batch with a greater order)
+        auto nextOrderIt = mFirstRenderBatchPerOrder.upper_bound(order);
+        auto renderBatchIt = mRenderBatches.insert(
+            nextOrderIt == mFirstRenderBatchPerOrder.end() ? mRenderBatches.end() : nextOrderIt->second,
+            std::move(rRenderBatch));
+        mFirstRenderBatchPerOrder.emplace(order, renderBatchIt);
+        mMaterialRenderBatches.emplace(renderBatchIt->pMaterial.get(), renderBatchIt);
+        return renderBatchIt;
+    }
+
+    void RenderBatchStrategy::EraseMaterialRenderBatch(const RenderBatches::iterator &rRenderBatchIt)
+    {
+        assert(IsMaterialRenderGroup(rRenderBatchIt->group));
+        auto order = GetOrder(*rRenderBatchIt);
+        auto firstRenderBatchIt = mFirstRenderBatchPerOrder.find(order);
+        assert(firstRenderBatchIt != mFirstRenderBatchPerOrder.end());
+        if (firstRenderBatchIt->second == rRenderBatchIt)
+        {
+            auto nextRenderBatchIt = std::next(rRenderBatchIt);
+            if (nextRenderBatchIt != mRenderBatches.end() && GetOrder(*nextRenderBatchIt) == order)
+            {
+                firstRenderBatchIt->second = nextRenderBatchIt;
+            }
+            else
+            {
+                mFirstRenderBatchPerOrder.erase(firstRenderBatchIt);
+            }
+        }
+        mMaterialRenderBatches.erase(rRenderBatchIt->pMaterial.get());
+        mRenderBatches.erase(rRenderBatchIt);
     }
 
     void RenderBatchStrategy::AddToRenderBatch(const RenderBatches::iterator &rRenderBatchIt,
-                                               const Renderable *pRenderable)
+                                               RenderableIndices &rRenderableIndices, const Renderable *pRenderable)
     {
         assert(rRenderBatchIt != mRenderBatches.end());
         auto &rRenderablesPerMesh = rRenderBatchIt->renderablesPerMesh;
@@ -151,11 +175,15 @@ namespace FastCG
         {
             renderablesPerMeshIt = rRenderablesPerMesh.emplace(rpMesh, std::vector<const Renderable *>{}).first;
         }
-        renderablesPerMeshIt->second.emplace_back(pRenderable);
+        auto &rRenderables = renderablesPerMeshIt->second;
+        assert(rRenderableIndices.find(pRenderable) == rRenderableIndices.end());
+        rRenderableIndices.emplace(pRenderable, rRenderables.size());
+        rRenderables.emplace_back(pRenderable);
     }
 
-    inline bool RenderBatchStrategy::RemoveFromRenderBatch(const RenderBatches::iterator &rRenderBatchIt,
-                                                           const Renderable *pRenderable)
+    bool RenderBatchStrategy::RemoveFromRenderBatch(const RenderBatches::iterator &rRenderBatchIt,
+                                                    RenderableIndices &rRenderableIndices,
+                                                    const Renderable *pRenderable)
     {
         assert(rRenderBatchIt != mRenderBatches.end());
         auto &rRenderablesPerMesh = rRenderBatchIt->renderablesPerMesh;
@@ -163,9 +191,18 @@ namespace FastCG
         auto renderablesPerMeshIt = rRenderablesPerMesh.find(rpMesh);
         assert(renderablesPerMeshIt != rRenderablesPerMesh.end());
         auto &rRenderables = renderablesPerMeshIt->second;
-        auto renderableIt = std::find(rRenderables.cbegin(), rRenderables.cend(), pRenderable);
-        assert(renderableIt != rRenderables.cend());
-        rRenderables.erase(renderableIt);
+        auto renderableIndexIt = rRenderableIndices.find(pRenderable);
+        assert(renderableIndexIt != rRenderableIndices.end());
+        auto renderableIdx = renderableIndexIt->second;
+        assert(renderableIdx < rRenderables.size() && rRenderables[renderableIdx] == pRenderable);
+        rRenderableIndices.erase(renderableIndexIt);
+        // swap-and-pop
+        if (renderableIdx != rRenderables.size() - 1)
+        {
+            rRenderables[renderableIdx] = rRenderables.back();
+            rRenderableIndices[rRenderables[renderableIdx]] = renderableIdx;
+        }
+        rRenderables.pop_back();
         if (rRenderables.empty())
         {
             rRenderablesPerMesh.erase(renderablesPerMeshIt);
@@ -173,7 +210,7 @@ namespace FastCG
             {
                 if (IsMaterialRenderGroup(rRenderBatchIt->group))
                 {
-                    mRenderBatches.erase(rRenderBatchIt);
+                    EraseMaterialRenderBatch(rRenderBatchIt);
                 }
             }
         }
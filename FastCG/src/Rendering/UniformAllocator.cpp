@@ -0,0 +1,58 @@
+#include <FastCG/Rendering/UniformAllocator.h>
+
+#include <algorithm>
+#include <cassert>
+
+namespace FastCG
+{
+    UniformAllocator::UniformAllocator(const std::string &rName, size_t pageSize) : mName(rName), mPageSize(pageSize)
+    {
+    }
+
+    UniformSlice UniformAllocator::Allocate(const void *pData, size_t size, size_t dataSize,
+                                            GraphicsContext *pGraphicsContext)
+    {
+        assert(size > 0);
+        assert(dataSize <= size);
+
+        auto offset = (mOffset + OFFSET_ALIGNMENT - 1) & ~(OFFSET_ALIGNMENT - 1);
+        while (mLastPageIdx < mPages.size() && offset + size > mPages[mLastPageIdx]->GetDataSize())
+        {
+            ++mLastPageIdx;
+            offset = 0;
+        }
+        if (mLastPageIdx == mPages.size())
+        {
+            // blocks larger than a page get a page of their own
+            mPages.emplace_back(GraphicsSystem::GetInstance()->CreateBuffer(
+                {mName + " (" + std::to_string(mPages.size()) + ")",
+                 BufferUsageFlagBit::UNIFORM | BufferUsageFlagBit::DYNAMIC, std::max(mPageSize, size)}));
+            offset = 0;
+        }
+
+        UniformSlice slice{mPages[mLastPageIdx], offset, size};
+        if (dataSize > 0)
+        {
+            pGraphicsContext->Copy(slice.pBuffer, pData, offset, dataSize);
+        }
+        mOffset = offset + size;
+        return slice;
+    }
+
+    void UniformAllocator::Reset()
+    {
+        mLastPageIdx = 0;
+        mOffset = 0;
+    }
+
+    void UniformAllocator::Release()
+    {
+        for (const auto *pPage : mPages)
+        {
+            GraphicsSystem::GetInstance()->DestroyBuffer(pPage);
+        }
+        mPages.clear();
+        Reset();
+    }
+
+}
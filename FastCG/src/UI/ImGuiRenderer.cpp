@@ -5,6 +5,13 @@
 #include <cstdint>
 #include <cstring>
 
+namespace
+{
+    constexpr FastCG::ShaderResourceId IMGUI_CONSTANTS_SHADER_RESOURCE_ID =
+        FastCG::GetShaderResourceId("ImGuiConstants");
+    constexpr FastCG::ShaderResourceId COLOR_MAP_SHADER_RESOURCE_ID = FastCG::GetShaderResourceId("uColorMap");
+}
+
 namespace FastCG
 {
     static_assert(sizeof(ImDrawIdx) == sizeof(uint32_t), "Please configure ImGui to use 32-bit indices");
@@ -98,7 +105,7 @@ namespace FastCG
 
                 pGraphicsContext->BindShader(mpImGuiShader);
 
-                pGraphicsContext->BindResource(mpImGuiConstantsBuffer, "ImGuiConstants");
+                pGraphicsContext->BindResource(mpImGuiConstantsBuffer, IMGUI_CONSTANTS_SHADER_RESOURCE_ID);
 
                 pGraphicsContext->SetVertexBuffers(mpImGuiMesh->GetVertexBuffers(),
                                                    mpImGuiMesh->GetVertexBufferCount());
@@ -174,7 +181,7 @@ namespace FastCG
                             const auto *pTexture = (const Texture *)pCmd->GetTexID();
                             // FIXME: there should be a more elegant way to do that
                             pGraphicsContext->SetBlend(pTexture == nullptr || pTexture == mpImGuiTexture);
-                            pGraphicsContext->BindResource(pTexture, "uColorMap");
+                            pGraphicsContext->BindResource(pTexture, COLOR_MAP_SHADER_RESOURCE_ID);
 
                             pGraphicsContext->DrawIndexed(PrimitiveType::TRIANGLES, pCmd->IdxOffset + idxOffset,
                                                           (uint32_t)pCmd->ElemCount,
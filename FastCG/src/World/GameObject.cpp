@@ -126,4 +126,19 @@ namespace FastCG
         return bounds;
     }
 
+    AABB GameObject::GetWorldBounds() const
+    {
+        auto *pRenderable = GetComponent<Renderable>();
+        if (pRenderable == nullptr || pRenderable->GetMesh() == nullptr)
+        {
+            return {};
+        }
+        const auto &rBounds = pRenderable->GetMesh()->GetBounds();
+        if (rBounds.IsEmpty())
+        {
+            return {};
+        }
+        return rBounds.Transform(GetTransform()->GetModel());
+    }
+
 }
\ No newline at end of file
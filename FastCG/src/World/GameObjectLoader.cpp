@@ -203,7 +203,7 @@ namespace
             assert(minArray.Size() == 3);
             args.bounds.min = glm::vec3{minArray[0].GetFloat(), minArray[1].GetFloat(), minArray[2].GetFloat()};
             assert(boundsObj.HasMember("max") && boundsObj["max"].IsArray());
-            auto maxArray = boundsObj["min"].GetArray();
+            auto maxArray = boundsObj["max"].GetArray();
             assert(maxArray.Size() == 3);
             args.bounds.max = glm::vec3{maxArray[0].GetFloat(), maxArray[1].GetFloat(), maxArray[2].GetFloat()};
         }
@@ -1306,6 +1306,11 @@ namespace FastCG
         FASTCG_TRACK_COMPONENT_COLLECTION(Behaviour, pComponent);
 
         mComponents.emplace_back(pComponent);
+
+        if (pComponent->GetType().IsDerived(Renderable::TYPE))
+        {
+            UpdateSpatialIndex(pComponent->GetGameObject());
+        }
     }
 
     void WorldSystem::RegisterCamera(Camera *pCamera)
@@ -1343,6 +1348,110 @@ namespace FastCG
         FASTCG_UNTRACK_COMPONENT(Fog, pComponent);
         FASTCG_UNTRACK_COMPONENT_COLLECTION(Behaviour, pComponent);
         FASTCG_UNTRACK_COMPONENT_COLLECTION(Component, pComponent);
+
+        if (pComponent->GetType().IsDerived(Renderable::TYPE))
+        {
+            UpdateSpatialIndex(pComponent->GetGameObject());
+        }
+    }
+
+    void WorldSystem::UpdateSpatialIndex(GameObject *pGameObject)
+    {
+        assert(pGameObject != nullptr);
+
+        AABB bounds;
+        auto *pRenderable = pGameObject->GetComponent<Renderable>();
+        if (pRenderable != nullptr && !pRenderable->IsSkybox())
+        {
+            bounds = pGameObject->GetWorldBounds();
+        }
+
+        auto it = mSpatialIndexProxies.find(pGameObject);
+        if (bounds.IsEmpty())
+        {
+            if (it != mSpatialIndexProxies.end())
+            {
+                mSpatialIndex.Remove(it->second);
+                mSpatialIndexProxies.erase(it);
+            }
+            return;
+        }
+
+        if (it == mSpatialIndexProxies.end())
+        {
+            mSpatialIndexProxies.emplace(pGameObject, mSpatialIndex.Insert(bounds, pGameObject));
+        }
+        else
+        {
+            mSpatialIndex.Update(it->second, bounds);
+        }
+    }
+
+    void WorldSystem::RefitSpatialIndex()
+    {
+        for (const auto &rEntry : mSpatialIndexProxies)
+        {
+            if (!rEntry.first->GetTransform()->HasUpdated())
+            {
+                continue;
+            }
+            // only reinserts the proxy if the new bounds escape the fat ones
+            mSpatialIndex.Update(rEntry.second, rEntry.first->GetWorldBounds());
+        }
+    }
+
+    void WorldSystem::FindGameObjects(const AABB &rBounds, std::vector<GameObject *> &rGameObjects) const
+    {
+        mSpatialIndex.Query(rBounds, [&](GameObject *pGameObject) {
+            if (pGameObject->GetWorldBounds().Intersects(rBounds))
+            {
+                rGameObjects.emplace_back(pGameObject);
+            }
+            return true;
+        });
+    }
+
+    void WorldSystem::FindGameObjects(const Frustum &rFrustum, std::vector<GameObject *> &rGameObjects) const
+    {
+        mSpatialIndex.Query(rFrustum, [&](GameObject *pGameObject) {
+            if (rFrustum.Intersects(pGameObject->GetWorldBounds()))
+            {
+                rGameObjects.emplace_back(pGameObject);
+            }
+            return true;
+        });
+    }
+
+    void WorldSystem::FindGameObjects(const glm::vec3 &rCenter, float radius,
+                                      std::vector<GameObject *> &rGameObjects) const
+    {
+        mSpatialIndex.Query(rCenter, radius, [&](GameObject *pGameObject) {
+            if (pGameObject->GetWorldBounds().Intersects(rCenter, radius))
+            {
+                rGameObjects.emplace_back(pGameObject);
+            }
+            return true;
+        });
+    }
+
+    GameObject *WorldSystem::Raycast(const glm::vec3 &rOrigin, const glm::vec3 &rDirection, float maxDistance,
+                                     float &rDistance) const
+    {
+        GameObject *pClosestGameObject = nullptr;
+        auto inverseDirection = 1.0f / rDirection;
+        mSpatialIndex.Raycast(rOrigin, rDirection, maxDistance, [&](GameObject *pGameObject, float) {
+            // the tree stores fat bounds, so test the actual ones
+            float distance;
+            if (pGameObject->GetWorldBounds().Raycast(rOrigin, inverseDirection, maxDistance, distance))
+            {
+                pClosestGameObject = pGameObject;
+                rDistance = distance;
+                // only look for closer hits from now on
+                maxDistance = distance;
+            }
+            return maxDistance;
+        });
+        return pClosestGameObject;
     }
 
     void WorldSystem::SetMainCamera(Camera *pCamera)
@@ -1376,6 +1485,10 @@ namespace FastCG
 
     void WorldSystem::Update(float time, float deltaTime)
     {
+        // catch transforms modified outside of the world update (eg, input callbacks)
+        // before the hierarchy update clears their state
+        RefitSpatialIndex();
+
         for (auto *pGameObject : mGameObjects)
         {
             if (pGameObject->GetTransform()->GetParent() != nullptr)
@@ -1389,6 +1502,8 @@ namespace FastCG
         {
             pBehaviour->Update((float)time, (float)deltaTime);
         }
+
+        RefitSpatialIndex();
     }
 
     void WorldSystem::Finalize()
@@ -1405,6 +1520,9 @@ namespace FastCG
         assert(mPointLights.empty());
         assert(mBehaviours.empty());
         assert(mComponents.empty());
+        assert(mSpatialIndexProxies.empty());
+
+        mSpatialIndex.Clear();
     }
 
 }
\ No newline at end of file
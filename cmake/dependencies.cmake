@@ -62,6 +62,8 @@ endfunction()
 set(FETCHCONTENT_QUIET OFF)
 set(FETCHCONTENT_FULLY_DISCONNECTED ON CACHE BOOL "")
 
+find_package(Threads REQUIRED)
+
 if(FASTCG_PLATFORM STREQUAL "Linux")
     find_package(X11 REQUIRED COMPONENTS Xext Xrender)
 endif()
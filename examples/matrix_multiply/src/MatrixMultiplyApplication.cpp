@@ -12,6 +12,11 @@
 
 namespace
 {
+    constexpr ShaderResourceId SIZES_SHADER_RESOURCE_ID = GetShaderResourceId("Sizes");
+    constexpr ShaderResourceId A_SHADER_RESOURCE_ID = GetShaderResourceId("A");
+    constexpr ShaderResourceId B_SHADER_RESOURCE_ID = GetShaderResourceId("B");
+    constexpr ShaderResourceId C_SHADER_RESOURCE_ID = GetShaderResourceId("C");
+
     Matrix MakeZeroMatrix(size_t length)
     {
         return std::make_unique<float[]>(length);
@@ -51,7 +56,8 @@ bool MatrixMultiplyApplication::ParseCommandLineArguments(int argc, char **argv)
         }
         for (const auto &rArg : {Arg{"--method", &mMethod}, Arg{"--count", &mCount}, Arg{"--M", &mM}, Arg{"--N", &mN},
                                  Arg{"--K", &mK}, Arg{"--exit-on-end", &mExitOnEnd}, Arg{"--frame-based", &mFrameBased},
-                                 Arg{"--print", &mPrint}, Arg{"--validate", &mValidate}})
+                                 Arg{"--print", &mPrint}, Arg{"--validate", &mValidate},
+                                 Arg{"--async-compute", &mAsyncCompute}})
         {
             if (std::strcmp(argv[i], rArg.name) == 0)
             {
@@ -79,6 +85,7 @@ void MatrixMultiplyApplication::OnPrintUsage()
               << "\t--frame-based <0=false|1=true>" << std::endl
               << "\t--print <0=false|1=true>" << std::endl
               << "\t--validate <0=false|1=true>" << std::endl
+              << "\t--async-compute <0=false|1=true>" << std::endl
               << std::endl;
 }
 
@@ -147,7 +154,8 @@ void MatrixMultiplyApplication::RecordCommands()
         return;
     }
 
-    mpGraphicsContext = GraphicsSystem::GetInstance()->CreateGraphicsContext({"Application Context"});
+    mpGraphicsContext = GraphicsSystem::GetInstance()->CreateGraphicsContext(
+        {"Application Context", mAsyncCompute ? QueueType::COMPUTE : QueueType::GRAPHICS});
     mpGraphicsContext->Begin();
 
     std::vector<Matrix> A_values(mCount), B_values(mCount), C_outputs(mCount);
@@ -227,16 +235,16 @@ void MatrixMultiplyApplication::RecordCommands()
     });
 
     mpGraphicsContext->BindShader(pShader);
-    mpGraphicsContext->BindResource(pSizesBuffer, "Sizes");
+    mpGraphicsContext->BindResource(pSizesBuffer, SIZES_SHADER_RESOURCE_ID);
     mpGraphicsContext->PushDebugMarker("MatrixMultiplication");
     for (int i = 0; i < mCount; ++i)
     {
         mpGraphicsContext->PushDebugMarker(
             ("C_" + std::to_string(i) + " = A_" + std::to_string(i) + " * B_" + std::to_string(i)).c_str());
         {
-            mpGraphicsContext->BindResource(A_buffers[i], "A");
-            mpGraphicsContext->BindResource(B_buffers[i], "B");
-            mpGraphicsContext->BindResource(mC_buffers[i], "C");
+            mpGraphicsContext->BindResource(A_buffers[i], A_SHADER_RESOURCE_ID);
+            mpGraphicsContext->BindResource(B_buffers[i], B_SHADER_RESOURCE_ID);
+            mpGraphicsContext->BindResource(mC_buffers[i], C_SHADER_RESOURCE_ID);
             mpGraphicsContext->Dispatch(groupX, groupY, 1);
         }
         mpGraphicsContext->PopDebugMarker();
@@ -281,7 +289,11 @@ void MatrixMultiplyApplication::ProcessResults(uint32_t frame)
         mpGraphicsContext->Copy(&C_values_gpu[i][0], mC_buffers[i], 0, C_length * sizeof(float));
     }
 
-    std::cout << "[GPU] " << mpGraphicsContext->GetElapsedTime(frame) * 1000.0 << "ms" << std::endl;
+    // dedicated queues don't record timestamps
+    if (!mAsyncCompute)
+    {
+        std::cout << "[GPU] " << mpGraphicsContext->GetElapsedTime(frame) * 1000.0 << "ms" << std::endl;
+    }
     PrintCs(C_values_gpu);
 
     if (mValidate)
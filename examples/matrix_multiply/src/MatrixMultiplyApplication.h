@@ -33,6 +33,7 @@ private:
     int mFrameBased{0};
     int mPrint{0};
     int mValidate{0};
+    int mAsyncCompute{0};
     GraphicsContext *mpGraphicsContext;
     std::vector<const Buffer *> mC_buffers;
     std::vector<Matrix> mC_values_cpu;